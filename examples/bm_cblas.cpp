@@ -0,0 +1,169 @@
+/*
+  -------------------------------------------------------------------
+
+  Copyright (C) 2021, Andrew W. Steiner
+
+  This file is part of O2scl.
+
+  O2scl is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  O2scl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with O2scl. If not, see <http://www.gnu.org/licenses/>.
+
+  -------------------------------------------------------------------
+*/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <o2scl/cblas.h>
+
+/*
+  This program compares the performance of the blocked level-3 BLAS
+  specializations in o2scl_cblas for ublas matrices with the generic
+  templates, for square matrices with sizes between 100 and 5000.
+  The generic versions are slow for large matrices, so they are only
+  timed up to the size given as the first command-line argument
+  (default 1000).
+*/
+
+using namespace std;
+using namespace o2scl_cblas;
+
+typedef boost::numeric::ublas::matrix<double> ubmatrix;
+typedef boost::numeric::ublas::matrix
+<double,boost::numeric::ublas::row_major,std::vector<double> > ubmatrix_vec;
+
+/** \brief A row-major matrix with the same layout as \c ubmatrix
+    for which the generic templates are used
+*/
+class plain_matrix {
+
+protected:
+
+  std::vector<double> data;
+  size_t n2;
+
+public:
+
+  plain_matrix(size_t r, size_t c) : data(r*c), n2(c) {
+  }
+
+  double &operator()(size_t i, size_t j) {
+    return data[i*n2+j];
+  }
+
+  const double &operator()(size_t i, size_t j) const {
+    return data[i*n2+j];
+  }
+
+};
+
+/** \brief Fill \c A, \c B, and \c C with test data, making
+    \c A diagonally dominant for \c dtrsm()
+*/
+template<class mat_t> void fill(size_t n, mat_t &A, mat_t &B, mat_t &C) {
+  for(size_t i=0;i<n;i++) {
+    for(size_t j=0;j<n;j++) {
+      A(i,j)=sin((double)(i*n+j+1));
+      B(i,j)=cos((double)(3*i+j+1));
+      C(i,j)=sin((double)(i+2*j+1));
+    }
+    A(i,i)+=((double)n);
+  }
+  return;
+}
+
+/** \brief Time \c dgemm(), \c dtrsm() and \c dsyrk() for matrices of
+    type \c mat_t of size \c n, storing the time per call in \c t
+
+    Small matrices are timed over several calls so that the
+    timings are not dominated by the clock resolution.
+*/
+template<class mat_t> void time_all(size_t n, double t[3]) {
+
+  mat_t A(n,n), B(n,n), C(n,n);
+  fill(n,A,B,C);
+  size_t reps=1;
+  if (n<1000) reps=1000000000/(n*n*n);
+
+  std::chrono::steady_clock::time_point t0, t1;
+
+  t0=std::chrono::steady_clock::now();
+  for(size_t ir=0;ir<reps;ir++) {
+    dgemm(o2cblas_RowMajor,o2cblas_NoTrans,o2cblas_NoTrans,n,n,n,
+	  1.0,A,B,0.5,C);
+  }
+  t1=std::chrono::steady_clock::now();
+  t[0]=std::chrono::duration<double>(t1-t0).count()/reps;
+
+  t0=std::chrono::steady_clock::now();
+  for(size_t ir=0;ir<reps;ir++) {
+    dtrsm(o2cblas_RowMajor,o2cblas_Left,o2cblas_Lower,o2cblas_NoTrans,
+	  o2cblas_NonUnit,n,n,1.0,A,B);
+  }
+  t1=std::chrono::steady_clock::now();
+  t[1]=std::chrono::duration<double>(t1-t0).count()/reps;
+
+  t0=std::chrono::steady_clock::now();
+  for(size_t ir=0;ir<reps;ir++) {
+    dsyrk(o2cblas_RowMajor,o2cblas_Upper,o2cblas_NoTrans,n,n,
+	  1.0,A,0.5,C);
+  }
+  t1=std::chrono::steady_clock::now();
+  t[2]=std::chrono::duration<double>(t1-t0).count()/reps;
+
+  return;
+}
+
+int main(int argc, char *argv[]) {
+
+  size_t max_generic=1000;
+  if (argc>=2) max_generic=std::atoi(argv[1]);
+
+  cout.setf(ios::scientific);
+  cout.precision(3);
+
+  size_t sizes[6]={100,200,500,1000,2000,5000};
+
+  cout << "Times per call in seconds for blocked (ubmatrix), blocked "
+       << "(std::vector storage)," << endl;
+  cout << "and generic versions:" << endl;
+  cout << endl;
+
+  const char *names[3]={"dgemm","dtrsm","dsyrk"};
+  for(size_t is=0;is<6;is++) {
+    size_t n=sizes[is];
+
+    double tb[3], tv[3], tg[3];
+    time_all<ubmatrix>(n,tb);
+    time_all<ubmatrix_vec>(n,tv);
+    bool generic=(n<=max_generic);
+    if (generic) time_all<plain_matrix>(n,tg);
+
+    for(size_t k=0;k<3;k++) {
+      cout << setw(5) << n << " " << names[k] << " "
+	   << tb[k] << " " << tv[k] << " ";
+      if (generic) {
+	cout << tg[k] << " speedup: " << tg[k]/tb[k] << endl;
+      } else {
+	cout << "(skipped)" << endl;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -52,6 +52,8 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
@@ -149,6 +151,83 @@ namespace o2scl {
       return (b-a)*(ai+bterm+cterm+dterm);
     }
     
+    /// The number of points processed together in the batch functions
+    static const size_t many_block=256;
+    
+    /** \brief Find the interval containing \c x0 given the 
+        interval \c cache found for a nearby point
+
+        This gives the same result as <tt>svx.find_const()</tt>, but
+        first checks the next interval, so that it is fast when
+        called for an increasing sequence of points.
+    */
+    size_t find_near(double x0, size_t &cache, bool inc) const {
+      if (inc && cache+2<sz && x0>=(*px)[cache+1] &&
+          x0<(*px)[cache+2]) {
+        cache++;
+        return cache;
+      }
+      return svx.find_const(x0,cache);
+    }
+
+    /** \brief Compute the function at the \c n points in \c x0
+        which lie in the intervals given in \c ix
+
+        This default version just calls \ref eval() for each
+        point. Descendants override this to evaluate all of the
+        points in a single loop without searching.
+    */
+    virtual void eval_block(size_t n, const double *x0, const size_t *ix,
+                            double *y0) const {
+      for(size_t i=0;i<n;i++) y0[i]=eval(x0[i]);
+      return;
+    }
+    
+    /** \brief Compute the derivative at the \c n points in \c x0
+        which lie in the intervals given in \c ix
+
+        This default version just calls \ref deriv() for each
+        point.
+    */
+    virtual void deriv_block(size_t n, const double *x0, const size_t *ix,
+                             double *y0) const {
+      for(size_t i=0;i<n;i++) y0[i]=deriv(x0[i]);
+      return;
+    }
+
+    /** \brief Apply \ref eval_block() or \ref deriv_block() to
+        the first \c n points in \c x0, storing the results in 
+        \c y0
+    */
+    template<class vec3_t, class vec4_t>
+    void many_blocks(size_t n, const vec3_t &x0, vec4_t &y0,
+                     bool derivs) const {
+      
+      double xb[many_block], yb[many_block];
+      size_t ib[many_block];
+      size_t cache=0;
+      bool inc=((*px)[0]<(*px)[sz-1]);
+      
+      for(size_t i=0;i<n;i+=many_block) {
+        size_t m=n-i;
+        if (m>many_block) m=many_block;
+        for(size_t j=0;j<m;j++) {
+          xb[j]=x0[i+j];
+          ib[j]=find_near(xb[j],cache,inc);
+        }
+        if (derivs) {
+          deriv_block(m,xb,ib,yb);
+        } else {
+          eval_block(m,xb,ib,yb);
+        }
+        for(size_t j=0;j<m;j++) {
+          y0[i+j]=yb[j];
+        }
+      }
+      
+      return;
+    }
+    
 #endif
     
   public:
@@ -191,6 +270,84 @@ namespace o2scl {
 
     /// Return the type
     virtual const char *type() const=0;
+
+    /** \name Batch evaluation
+        
+        These functions give the same results as calling \ref
+        eval(), \ref deriv(), or \ref integ() for each point, but
+        avoid repeated virtual function calls and reuse the interval
+        found for the previous point, so they are much faster when
+        the points are sorted. The points need not be sorted,
+        however.
+    */
+    //@{
+    /** \brief Give the values of the function at the first \c n
+        points in \c x0, storing the results in \c y0
+    */
+    template<class vec3_t, class vec4_t>
+    void eval_many(size_t n, const vec3_t &x0, vec4_t &y0) const {
+      many_blocks(n,x0,y0,false);
+      return;
+    }
+    
+    /** \brief Give the values of the derivative at the first \c n
+        points in \c x0, storing the results in \c y0
+    */
+    template<class vec3_t, class vec4_t>
+    void deriv_many(size_t n, const vec3_t &x0, vec4_t &y0) const {
+      many_blocks(n,x0,y0,true);
+      return;
+    }
+
+    /** \brief Give the integrals from <tt>a[i]</tt> to <tt>b[i]</tt> 
+        for the first \c n pairs of limits, storing the results 
+        in \c res
+
+        This function first computes the integral over each
+        interval, so that every integral requires only a fixed amount
+        of work, independent of the distance between the limits.
+        Because of this, the results may differ from those of \ref
+        integ() by a small multiple of the machine precision.
+    */
+    template<class vec3_t, class vec4_t, class vec5_t>
+    void integ_many(size_t n, const vec3_t &a, const vec4_t &b,
+                    vec5_t &res) const {
+      
+      const vec_t &x=*px;
+      bool inc=(x[0]<x[sz-1]);
+      
+      // Cumulative integrals at each grid point
+      std::vector<double> cumul(sz);
+      cumul[0]=0.0;
+      for(size_t i=0;i<sz-1;i++) {
+        cumul[i+1]=cumul[i]+integ(x[i],x[i+1]);
+      }
+
+      size_t cache=0;
+      for(size_t i=0;i<n;i++) {
+        double lo=a[i], hi=b[i];
+        // Ensure lo comes first in the grid ordering
+        bool flip=false;
+        if ((inc && lo>hi) || (!inc && lo<hi)) {
+          std::swap(lo,hi);
+          flip=true;
+        }
+        size_t ilo=find_near(lo,cache,inc);
+        size_t ihi=find_near(hi,cache,inc);
+        double result;
+        if (ilo>=ihi) {
+          result=integ(lo,hi);
+        } else {
+          result=integ(lo,x[ilo+1])+(cumul[ihi]-cumul[ilo+1])+
+            integ(x[ihi],hi);
+        }
+        if (flip) result=-result;
+        res[i]=result;
+      }
+      
+      return;
+    }
+    //@}
  
 #ifndef DOXYGEN_INTERNAL
 
@@ -280,6 +437,41 @@ namespace o2scl {
       return 0.0;
     }
 
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+    
+    /// Compute the function at several points (see \ref eval_many())
+    virtual void eval_block(size_t n, const double *x0, const size_t *ix,
+                            double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double x_lo=x[index];
+        double dx=x[index+1]-x_lo;
+        double y_lo=y[index];
+        y0[i]=y_lo+(x0[i]-x_lo)/dx*(y[index+1]-y_lo);
+      }
+      return;
+    }
+    
+    /// Compute the derivative at several points (see \ref deriv_many())
+    virtual void deriv_block(size_t n, const double *x0, const size_t *ix,
+                             double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        y0[i]=(y[index+1]-y[index])/(x[index+1]-x[index]);
+      }
+      return;
+    }
+
+#endif
+    
+  public:
+
     /// Give the value of the integral \f$ \int_a^{b}y(x)~dx \f$ .
     virtual double integ(double a, double b) const {
 
@@ -614,6 +806,51 @@ namespace o2scl {
       return 2.0*c_i+6.0*d_i*delx;
     }
 
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+    
+    /// Compute the function at several points (see \ref eval_many())
+    virtual void eval_block(size_t n, const double *x0, const size_t *ix,
+                            double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double x_lo=x[index];
+        double dx=x[index+1]-x_lo;
+        double y_lo=y[index];
+        double dy=y[index+1]-y_lo;
+        double delx=x0[i]-x_lo;
+        double b_i, c_i, d_i; 
+        coeff_calc(c,dy,dx,index,b_i,c_i,d_i);
+        y0[i]=y_lo+delx*(b_i+delx*(c_i+delx*d_i));
+      }
+      return;
+    }
+    
+    /// Compute the derivative at several points (see \ref deriv_many())
+    virtual void deriv_block(size_t n, const double *x0, const size_t *ix,
+                             double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double x_lo=x[index];
+        double dx=x[index+1]-x_lo;
+        double dy=y[index+1]-y[index];
+        double delx=x0[i]-x_lo;
+        double b_i, c_i, d_i; 
+        coeff_calc(c,dy,dx,index,b_i,c_i,d_i);
+        y0[i]=b_i+delx*(2.0*c_i+3.0*d_i*delx);
+      }
+      return;
+    }
+
+#endif
+    
+  public:
+
     /// Give the value of the integral \f$ \int_a^{b}y(x)~dx \f$ .
     virtual double integ(double a, double b) const {
 
@@ -997,6 +1234,39 @@ namespace o2scl {
       return 2.0*cc+6.0*dd*delx;
     }
 
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+    
+    /// Compute the function at several points (see \ref eval_many())
+    virtual void eval_block(size_t n, const double *x0, const size_t *ix,
+                            double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double delx=x0[i]-x[index];
+        y0[i]=y[index]+delx*(b[index]+delx*(c[index]+d[index]*delx));
+      }
+      return;
+    }
+    
+    /// Compute the derivative at several points (see \ref deriv_many())
+    virtual void deriv_block(size_t n, const double *x0, const size_t *ix,
+                             double *y0) const {
+      const vec_t &x=*this->px;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double delx=x0[i]-x[index];
+        y0[i]=b[index]+delx*(2.0*c[index]+3.0*d[index]*delx);
+      }
+      return;
+    }
+
+#endif
+    
+  public:
+
     /// Give the value of the integral \f$ \int_a^{b}y(x)~dx \f$ .
     virtual double integ(double aa, double bb) const {
 
@@ -1322,6 +1592,38 @@ namespace o2scl {
       return 2.0*b[index]+delx*6.0*a[index];
     }
 
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+    
+    /// Compute the function at several points (see \ref eval_many())
+    virtual void eval_block(size_t n, const double *x0, const size_t *ix,
+                            double *y0) const {
+      const vec_t &x=*this->px;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double delx=x0[i]-x[index];
+        y0[i]=d[index]+delx*(c[index]+delx*(b[index]+delx*a[index]));
+      }
+      return;
+    }
+    
+    /// Compute the derivative at several points (see \ref deriv_many())
+    virtual void deriv_block(size_t n, const double *x0, const size_t *ix,
+                             double *y0) const {
+      const vec_t &x=*this->px;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double delx=x0[i]-x[index];
+        y0[i]=c[index]+delx*(2.0*b[index]+delx*3.0*a[index]);
+      }
+      return;
+    }
+
+#endif
+    
+  public:
+
     /// Give the value of the integral \f$ \int_a^{b}y(x)~dx \f$ .
     virtual double integ(double al, double bl) const {
 
@@ -1584,6 +1886,56 @@ namespace o2scl {
       return deriv2;
     }
 
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+    
+    /// Compute the function at several points (see \ref eval_many())
+    virtual void eval_block(size_t n, const double *x0, const size_t *ix,
+                            double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double x_lo=x[index];
+        double h=x[index+1]-x_lo;
+        double t=(x0[i]-x_lo)/h;
+        double t2=t*t, t3=t2*t;
+        double h00=2.0*t3-3.0*t2+1.0;
+        double h10=t3-2.0*t2+t;
+        double h01=-2.0*t3+3.0*t2;
+        double h11=t3-t2;
+        y0[i]=y[index]*h00+h*m[index]*h10+y[index+1]*h01+
+          h*m[index+1]*h11;
+      }
+      return;
+    }
+    
+    /// Compute the derivative at several points (see \ref deriv_many())
+    virtual void deriv_block(size_t n, const double *x0, const size_t *ix,
+                             double *y0) const {
+      const vec_t &x=*this->px;
+      const vec2_t &y=*this->py;
+      for(size_t i=0;i<n;i++) {
+        size_t index=ix[i];
+        double x_lo=x[index];
+        double h=x[index+1]-x_lo;
+        double t=(x0[i]-x_lo)/h;
+        double t2=t*t;
+        double dh00=6.0*t2-6.0*t;
+        double dh10=3.0*t2-4.0*t+1.0;
+        double dh01=-6.0*t2+6.0*t;
+        double dh11=3.0*t2-2.0*t;
+        y0[i]=(y[index]*dh00+h*m[index]*dh10+y[index+1]*dh01+
+               h*m[index+1]*dh11)/h;
+      }
+      return;
+    }
+
+#endif
+    
+  public:
+
     /// Give the value of the integral \f$ \int_a^{b}y(x)~dx \f$ .
     virtual double integ(double a, double b) const {
       
@@ -1993,6 +2345,53 @@ namespace o2scl {
     return itp->integ(x1,x2);
   }                   
   
+  /** \brief Give the values of the function at the first \c n
+      points in \c x0, storing the results in \c y0
+
+      See \ref interp_base::eval_many().
+  */
+  template<class vec3_t, class vec4_t>
+  void eval_many(size_t n, const vec3_t &x0, vec4_t &y0) const {
+    if (itp==0) {
+      O2SCL_ERR("No vector set in interp_vec::eval_many().",
+                exc_einval);
+    }
+    itp->eval_many(n,x0,y0);
+    return;
+  }                   
+    
+  /** \brief Give the values of the derivative at the first \c n
+      points in \c x0, storing the results in \c y0
+
+      See \ref interp_base::deriv_many().
+  */
+  template<class vec3_t, class vec4_t>
+  void deriv_many(size_t n, const vec3_t &x0, vec4_t &y0) const {
+    if (itp==0) {
+      O2SCL_ERR("No vector set in interp_vec::deriv_many().",
+                exc_einval);
+    }
+    itp->deriv_many(n,x0,y0);
+    return;
+  }                   
+    
+  /** \brief Give the integrals from <tt>a[i]</tt> to <tt>b[i]</tt> 
+      for the first \c n pairs of limits, storing the results 
+      in \c res
+
+      See \ref interp_base::integ_many().
+  */
+  template<class vec3_t, class vec4_t, class vec5_t>
+  void integ_many(size_t n, const vec3_t &a, const vec4_t &b,
+                  vec5_t &res) const {
+    if (itp==0) {
+      O2SCL_ERR("No vector set in interp_vec::integ_many().",
+                exc_einval);
+    }
+    itp->integ_many(n,a,b,res);
+    return;
+  }                   
+  
   /// Return the type, "interp_vec"
   virtual const char *type() const {
     return "interp_vec";
@@ -749,6 +749,58 @@ int main(void) {
     }
   }
   
+  if (true) {
+
+    // Compare batch evaluation with the scalar functions for
+    // increasing and decreasing grids and sorted and unsorted points
+    
+    size_t n=50, np=1000;
+    ubvector xg(n), yg(n), rxg(n), ryg(n);
+    for(size_t i=0;i<n;i++) {
+      xg[i]=((double)i)+0.3*sin((double)i);
+      yg[i]=sin(xg[i]/5.0)+0.1*xg[i];
+      rxg[n-1-i]=xg[i];
+      ryg[n-1-i]=yg[i];
+    }
+    vector<double> xp(np), xu(np), a(np), b(np);
+    for(size_t i=0;i<np;i++) {
+      xp[i]=-2.0+((double)i)/((double)(np-1))*(xg[n-1]+4.0);
+      xu[i]=xp[(i*397)%np];
+      a[i]=xu[i];
+      b[i]=xp[(i*131)%np];
+    }
+
+    size_t types[7]={itp_linear,itp_cspline,itp_cspline_peri,itp_akima,
+                     itp_akima_peri,itp_steffen,itp_monotonic};
+    for(size_t k=0;k<7;k++) {
+      for(size_t dir=0;dir<2;dir++) {
+        interp_vec<> iv;
+        if (dir==0) iv.set(n,xg,yg,types[k]);
+        else iv.set(n,rxg,ryg,types[k]);
+        vector<double> y1(np), y2(np), d1(np), d2(np), i1(np);
+        iv.eval_many(np,xp,y1);
+        iv.eval_many(np,xu,y2);
+        iv.deriv_many(np,xp,d1);
+        iv.deriv_many(np,xu,d2);
+        iv.integ_many(np,a,b,i1);
+        bool same=true, dsame=true;
+        double ierr=0.0;
+        for(size_t i=0;i<np;i++) {
+          if (y1[i]!=iv.eval(xp[i]) || y2[i]!=iv.eval(xu[i])) same=false;
+          if (d1[i]!=iv.deriv(xp[i]) || d2[i]!=iv.deriv(xu[i])) {
+            dsame=false;
+          }
+          double ex=iv.integ(a[i],b[i]);
+          if (fabs(i1[i]-ex)>ierr) ierr=fabs(i1[i]-ex);
+        }
+        t.test_gen(same,"eval_many");
+        t.test_gen(dsame,"deriv_many");
+        t.test_abs(ierr,0.0,1.0e-12,"integ_many");
+      }
+    }
+    
+  }
+  
   t.report();
 
   return 0;
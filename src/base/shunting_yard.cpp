@@ -55,6 +55,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <cmath>
+#include <cstring>
 
 #include <o2scl/shunting_yard.h>
 #include <o2scl/err_hnd.h>
@@ -64,7 +65,8 @@ using namespace o2scl;
 calculator::calculator(const char* expr,
 		       const std::map<std::string, double>* vars,
 		       bool debug,
-		       std::map<std::string, int> opPrec) {
+		       std::map<std::string, int> opPrec) :
+  slot_depth(0), slot_ready(false) {
   compile(expr,vars,debug,opPrec);
 }
 
@@ -863,6 +865,8 @@ void calculator::compile(const char* expr,
 
   // Make sure it is empty:
   cleanRPN(this->RPN);
+  slot_code.clear();
+  slot_ready=false;
 
   this->RPN = calculator::toRPN(expr,vars,debug,opPrec);
 }
@@ -874,6 +878,8 @@ int calculator::compile_nothrow(const char* expr,
 
   // Make sure it is empty:
   cleanRPN(this->RPN);
+  slot_code.clear();
+  slot_ready=false;
 
   int ret=calculator::toRPN_nothrow(expr,vars,debug,opPrec,this->RPN);
   return ret;
@@ -914,3 +920,267 @@ std::string calculator::RPN_to_string() {
   ss << " ] }";
   return ss.str();
 }
+
+void calculator::compile_slots(const std::vector<std::string> &names) {
+
+  slot_code.clear();
+  slot_depth=0;
+  slot_ready=false;
+
+  // Map from the operator strings in the RPN to the bytecode
+  static const char *op_names[]={"sin","cos","tan","sqrt","log","exp",
+    "abs","log10","asin","acos","atan","sinh","cosh","tanh","asinh",
+    "acosh","atanh","floor","+","*","-","/","<<","^",">>","%","<",">",
+    "<=",">=","==","!=","&&","||"};
+  static const size_t n_op_names=sizeof(op_names)/sizeof(op_names[0]);
+
+  size_t depth=0;
+  TokenQueue_t rpn=this->RPN;
+  while (!rpn.empty()) {
+    TokenBase* base=rpn.front();
+    rpn.pop();
+
+    slot_instr si;
+    si.slot=0;
+    si.val=0.0;
+    
+    if (base->type==OP) {
+      
+      Token<std::string>* strTok=static_cast<Token<std::string>*>(base);
+      const std::string &str=strTok->val;
+      bool found=false;
+      for(size_t k=0;k<n_op_names;k++) {
+	if (str==op_names[k]) {
+	  si.op=(slot_op)(sop_sin+k);
+	  found=true;
+	  k=n_op_names;
+	}
+      }
+      if (!found) {
+	throw std::domain_error("Unknown operator: '" + str + "'.");
+      }
+      // Unary operators replace the top of the stack, binary
+      // operators remove one entry
+      if (si.op<=sop_floor) {
+	if (depth<1) throw std::domain_error("Invalid equation.");
+      } else {
+	if (depth<2) throw std::domain_error("Invalid equation.");
+	depth--;
+      }
+      
+    } else if (base->type==NUM) {
+      
+      Token<double>* doubleTok=static_cast<Token<double>*>(base);
+      si.op=sop_num;
+      si.val=doubleTok->val;
+      depth++;
+      
+    } else if (base->type==VAR) {
+      
+      Token<std::string>* strTok=static_cast<Token<std::string>*>(base);
+      const std::string &key=strTok->val;
+      bool found=false;
+      for(size_t k=0;k<names.size();k++) {
+	if (names[k]==key) {
+	  si.op=sop_var;
+	  si.slot=k;
+	  found=true;
+	  k=names.size();
+	}
+      }
+      if (!found) {
+        throw std::domain_error("Unable to find the variable '" +
+				key + "'.");
+      }
+      depth++;
+      
+    } else {
+      throw std::domain_error("Invalid token.");
+    }
+    
+    if (depth>slot_depth) slot_depth=depth;
+    slot_code.push_back(si);
+  }
+
+  if (depth==0) {
+    throw std::domain_error("Invalid equation.");
+  }
+  
+  slot_ready=true;
+  return;
+}
+
+double calculator::slot_unary(slot_op op, double right) {
+  switch (op) {
+  case sop_sin: return sin(right);
+  case sop_cos: return cos(right);
+  case sop_tan: return tan(right);
+  case sop_sqrt: return sqrt(right);
+  case sop_log: return log(right);
+  case sop_exp: return exp(right);
+  case sop_abs: return std::abs(right);
+  case sop_log10: return log10(right);
+  case sop_asin: return asin(right);
+  case sop_acos: return acos(right);
+  case sop_atan: return atan(right);
+  case sop_sinh: return sinh(right);
+  case sop_cosh: return cosh(right);
+  case sop_tanh: return tanh(right);
+  case sop_asinh: return asinh(right);
+  case sop_acosh: return acosh(right);
+  case sop_atanh: return atanh(right);
+  case sop_floor: return floor(right);
+  default: break;
+  }
+  throw std::domain_error("Invalid token.");
+  return 0.0;
+}
+
+double calculator::slot_binary(slot_op op, double left, double right) {
+  // These expressions must match those in calculate() exactly
+  switch (op) {
+  case sop_add: return left + right;
+  case sop_mul: return left * right;
+  case sop_sub: return left - right;
+  case sop_div: return left / right;
+  case sop_lshift: return (int) left << (int) right;
+  case sop_pow: return pow(left, right);
+  case sop_rshift: return (int) left >> (int) right;
+  case sop_mod: return (int) left % (int) right;
+  case sop_lt: return left < right;
+  case sop_gt: return left > right;
+  case sop_le: return left <= right;
+  case sop_ge: return left >= right;
+  case sop_eq: return left == right;
+  case sop_ne: return left != right;
+  case sop_and: return (int) left && (int) right;
+  case sop_or: return (int) left || (int) right;
+  default: break;
+  }
+  throw std::domain_error("Invalid token.");
+  return 0.0;
+}
+
+double calculator::eval_slots(const double *vals) const {
+
+  if (!slot_ready) {
+    O2SCL_ERR2("Function compile_slots() not called before ",
+	       "calculator::eval_slots().",o2scl::exc_efailed);
+  }
+
+  // Small expressions use a stack-allocated array
+  double sarr[32];
+  std::vector<double> svec;
+  double *stack=sarr;
+  if (slot_depth>32) {
+    svec.resize(slot_depth);
+    stack=&svec[0];
+  }
+  
+  size_t top=0;
+  for(size_t i=0;i<slot_code.size();i++) {
+    const slot_instr &si=slot_code[i];
+    if (si.op==sop_num) {
+      stack[top++]=si.val;
+    } else if (si.op==sop_var) {
+      stack[top++]=vals[si.slot];
+    } else if (si.op<=sop_floor) {
+      stack[top-1]=slot_unary(si.op,stack[top-1]);
+    } else {
+      stack[top-2]=slot_binary(si.op,stack[top-2],stack[top-1]);
+      top--;
+    }
+  }
+  return stack[top-1];
+}
+
+void calculator::eval_columns(size_t n, const double * const *cols,
+			      double *out) const {
+
+  if (!slot_ready) {
+    O2SCL_ERR2("Function compile_slots() not called before ",
+	       "calculator::eval_columns().",o2scl::exc_efailed);
+  }
+  if (n==0) return;
+
+  // The evaluation stack, each entry of which is a block of
+  // slot_block values
+  std::vector<double> svec(slot_depth*slot_block);
+  double *stack=&svec[0];
+
+  for(size_t start=0;start<n;start+=slot_block) {
+    
+    size_t nb=n-start;
+    if (nb>slot_block) nb=slot_block;
+    
+    size_t top=0;
+    for(size_t i=0;i<slot_code.size();i++) {
+      const slot_instr &si=slot_code[i];
+
+      if (si.op==sop_num) {
+	
+	double *dest=stack+top*slot_block;
+	for(size_t j=0;j<nb;j++) dest[j]=si.val;
+	top++;
+	
+      } else if (si.op==sop_var) {
+	
+	std::memcpy(stack+top*slot_block,cols[si.slot]+start,
+		    nb*sizeof(double));
+	top++;
+	
+      } else if (si.op<=sop_floor) {
+
+	// Unary operators, with the most common ones unrolled
+	// so that the compiler can vectorize them
+	double *x=stack+(top-1)*slot_block;
+	switch (si.op) {
+	case sop_sqrt:
+	  for(size_t j=0;j<nb;j++) x[j]=sqrt(x[j]);
+	  break;
+	case sop_exp:
+	  for(size_t j=0;j<nb;j++) x[j]=exp(x[j]);
+	  break;
+	case sop_log:
+	  for(size_t j=0;j<nb;j++) x[j]=log(x[j]);
+	  break;
+	default:
+	  for(size_t j=0;j<nb;j++) x[j]=slot_unary(si.op,x[j]);
+	  break;
+	}
+
+      } else {
+
+	// Binary operators, with the arithmetic operators
+	// unrolled
+	double *left=stack+(top-2)*slot_block;
+	const double *right=stack+(top-1)*slot_block;
+	switch (si.op) {
+	case sop_add:
+	  for(size_t j=0;j<nb;j++) left[j]=left[j]+right[j];
+	  break;
+	case sop_mul:
+	  for(size_t j=0;j<nb;j++) left[j]=left[j]*right[j];
+	  break;
+	case sop_sub:
+	  for(size_t j=0;j<nb;j++) left[j]=left[j]-right[j];
+	  break;
+	case sop_div:
+	  for(size_t j=0;j<nb;j++) left[j]=left[j]/right[j];
+	  break;
+	default:
+	  for(size_t j=0;j<nb;j++) {
+	    left[j]=slot_binary(si.op,left[j],right[j]);
+	  }
+	  break;
+	}
+	top--;
+	
+      }
+    }
+
+    std::memcpy(out+start,stack+(top-1)*slot_block,nb*sizeof(double));
+  }
+  
+  return;
+}
@@ -60,6 +60,7 @@
 #include <stack>
 #include <string>
 #include <queue>
+#include <vector>
 
 namespace o2scl {
 
@@ -199,7 +200,7 @@ namespace o2scl {
     
     /** \brief Create an empty calculator object
      */
-    calculator(){}
+    calculator() : slot_depth(0), slot_ready(false) {}
     
     /** \brief Compile expression \c expr using variables 
 	specified in \c vars
@@ -254,6 +255,97 @@ namespace o2scl {
     /** \brief Get the variable list
      */
     std::vector<std::string> get_var_list();
+
+    /** \name Slot-indexed evaluation
+     */
+    //@{
+    /** \brief Convert the previously compiled expression into
+	bytecode where each variable is given by its index in
+	\c names
+
+	This resolves all of the variable names in the expression
+	once, so that \ref eval_slots() and \ref eval_columns() do
+	not need to perform any string lookups. The expression must
+	be recompiled with this function after any subsequent call
+	to \ref compile() . If a variable in the expression is not
+	present in \c names, then <tt>std::domain_error</tt> is
+	thrown.
+     */
+    void compile_slots(const std::vector<std::string> &names);
+
+    /** \brief Return true if \ref compile_slots() has been called
+	for the current expression
+     */
+    bool slots_compiled() const {
+      return slot_ready;
+    }
+
+    /** \brief Evaluate the bytecode with the values of the variables
+	given in \c vals, ordered as in the call to \ref
+	compile_slots()
+     */
+    double eval_slots(const double *vals) const;
+    
+    /** \brief Evaluate the bytecode for \c n points, storing the
+	results in \c out
+
+	The value of variable \c i at point \c j is taken from
+	<tt>cols[i][j]</tt>, where the variables are ordered as in
+	the call to \ref compile_slots(). The operations are
+	performed on blocks of points at a time, and the results are
+	identical to those from \ref eval(). This function does not
+	modify the calculator object, so it may be called from
+	several threads simultaneously.
+     */
+    void eval_columns(size_t n, const double * const *cols,
+		      double *out) const;
+    //@}
+
+  protected:
+
+    /** \brief Bytecode operations for slot-indexed evaluation
+     */
+    enum slot_op {
+      sop_num, sop_var,
+      sop_sin, sop_cos, sop_tan, sop_sqrt, sop_log, sop_exp,
+      sop_abs, sop_log10, sop_asin, sop_acos, sop_atan, sop_sinh,
+      sop_cosh, sop_tanh, sop_asinh, sop_acosh, sop_atanh, sop_floor,
+      sop_add, sop_mul, sop_sub, sop_div, sop_lshift, sop_pow,
+      sop_rshift, sop_mod, sop_lt, sop_gt, sop_le, sop_ge, sop_eq,
+      sop_ne, sop_and, sop_or
+    };
+    
+    /** \brief A bytecode instruction
+     */
+    typedef struct slot_instr_s {
+      /// The operation
+      slot_op op;
+      /// The variable index for \ref sop_var 
+      size_t slot;
+      /// The value for \ref sop_num
+      double val;
+    } slot_instr;
+
+    /** \brief Number of points in each block in \ref eval_columns()
+     */
+    static const size_t slot_block=256;
+    
+    /// The bytecode
+    std::vector<slot_instr> slot_code;
+
+    /// The maximum depth of the evaluation stack
+    size_t slot_depth;
+
+    /// True if \ref slot_code corresponds to the current expression
+    bool slot_ready;
+
+    /** \brief Apply a unary operator
+     */
+    static double slot_unary(slot_op op, double right);
+    
+    /** \brief Apply a binary operator
+     */
+    static double slot_binary(slot_op op, double left, double right);
     
   };
 
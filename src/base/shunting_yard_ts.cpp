@@ -169,6 +169,39 @@ int main(void) {
     rpn.pop();
   }
 
+  // Test slot-indexed evaluation against eval()
+  {
+    std::vector<std::string> names={"x","y","z"};
+    size_t n=1000;
+    std::vector<double> x(n), y(n), z(n), out(n);
+    for(size_t i=0;i<n;i++) {
+      x[i]=((double)i)/100.0;
+      y[i]=sin(((double)i));
+      z[i]=((double)(i%7));
+    }
+    const double *cols[3]={&x[0],&y[0],&z[0]};
+    
+    std::vector<std::string> exprs={"x*y+z","-exp(x/10)+sin(y)^2",
+      "sqrt(abs(y))*log(x+1)-z/3","(x>2 && z<4)*y","z%3+(x<<1)",
+      "atan(y)/floor(x+1)+y*y*y-x"};
+    for(size_t k=0;k<exprs.size();k++) {
+      calc.compile(exprs[k].c_str(),0);
+      calc.compile_slots(names);
+      calc.eval_columns(n,cols,&out[0]);
+      bool match=true;
+      for(size_t i=0;i<n;i++) {
+	std::map<std::string,double> vars;
+	vars["x"]=x[i];
+	vars["y"]=y[i];
+	vars["z"]=z[i];
+	double v=calc.eval(&vars);
+	double arr[3]={x[i],y[i],z[i]};
+	if (v!=out[i] || v!=calc.eval_slots(arr)) match=false;
+      }
+      t.test_gen(match,((string)"slots ")+exprs[k]);
+    }
+  }
+  
   /*
     typedef std::queue<TokenBase *>::const_iterator cit;
     for(cit=rpn.begin();cit!=rpn.end();cit++) {
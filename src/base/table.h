@@ -82,6 +82,109 @@ namespace o2scl_hdf {
 namespace o2scl {
 #endif
 
+  /** \brief Column storage policy for \ref table
+
+      This class describes how \ref table resizes the vectors which
+      store its columns. The generic version assumes that resizing a
+      vector of type \c vec_t may destroy its contents, so \ref
+      resize() copies the first \c n_keep elements to a temporary
+      and then copies them back after the resize. Specializations
+      for <tt>std::vector</tt> and <tt>boost::numeric::ublas::vector</tt>
+      resize in place instead, and the <tt>std::vector</tt>
+      specialization also supports \ref reserve().
+
+      Users with other vector types which preserve their contents
+      when resized can provide a specialization of this class to
+      avoid the extra copies.
+  */
+  template<class vec_t> class table_col_storage {
+    
+  public:
+
+    /// If true, \ref resize() preserves the vector contents directly
+    static const bool preserves=false;
+    
+    /** \brief Resize \c v to size \c n, keeping the first \c n_keep
+	elements
+    */
+    static void resize(vec_t &v, size_t n, size_t n_keep) {
+      if (n_keep>n) n_keep=n;
+      vec_t temp_col(n_keep);
+      for(size_t j=0;j<n_keep;j++) {
+	temp_col[j]=v[j];
+      }
+      v.resize(n);
+      for(size_t j=0;j<n_keep;j++) {
+	v[j]=temp_col[j];
+      }
+      return;
+    }
+
+    /** \brief Reserve space for \c n elements (no-op by default)
+     */
+    static void reserve(vec_t &v, size_t n) {
+      return;
+    }
+    
+  };
+
+  /** \brief Column storage policy for <tt>std::vector</tt>
+   */
+  template<class data_t, class alloc_t>
+    class table_col_storage<std::vector<data_t,alloc_t> > {
+    
+  public:
+
+    /// If true, \ref resize() preserves the vector contents directly
+    static const bool preserves=true;
+    
+    /** \brief Resize \c v to size \c n, keeping the first \c n_keep
+	elements
+    */
+    static void resize(std::vector<data_t,alloc_t> &v, size_t n,
+		       size_t n_keep) {
+      v.resize(n);
+      return;
+    }
+
+    /** \brief Reserve space for \c n elements
+     */
+    static void reserve(std::vector<data_t,alloc_t> &v, size_t n) {
+      v.reserve(n);
+      return;
+    }
+    
+  };
+
+  /** \brief Column storage policy for 
+      <tt>boost::numeric::ublas::vector</tt>
+  */
+  template<class data_t, class alloc_t>
+    class table_col_storage<boost::numeric::ublas::vector<data_t,alloc_t> > {
+    
+  public:
+
+    /// If true, \ref resize() preserves the vector contents directly
+    static const bool preserves=true;
+    
+    /** \brief Resize \c v to size \c n, keeping the first \c n_keep
+	elements
+    */
+    static void resize(boost::numeric::ublas::vector<data_t,alloc_t> &v,
+		       size_t n, size_t n_keep) {
+      v.resize(n,true);
+      return;
+    }
+
+    /** \brief Reserve space for \c n elements (no-op)
+     */
+    static void reserve(boost::numeric::ublas::vector<data_t,alloc_t> &v,
+			size_t n) {
+      return;
+    }
+    
+  };
+
   /** \brief Data \table class
 
       \b Summary \n 
@@ -232,6 +335,7 @@ namespace o2scl {
     nlines=0;
     intp_set=false;
     maxlines=cmaxlines;
+    reserve_hint=0;
     itype=itp_cspline;
   }
 
@@ -255,6 +359,7 @@ namespace o2scl {
     // Copy the columns and data
     nlines=t.get_nlines();
     maxlines=nlines;
+    reserve_hint=0;
 
     for(size_t i=0;i<t.get_ncolumns();i++) {
 
@@ -345,6 +450,7 @@ namespace o2scl {
     // The data
     swap(t1.maxlines,t2.maxlines);
     swap(t1.nlines,t2.nlines);
+    swap(t1.reserve_hint,t2.reserve_hint);
     swap(t1.atree,t2.atree);
 
     // Take care of interpolation
@@ -632,9 +738,7 @@ namespace o2scl {
       
     // Try to increase the number of lines
     if (il>maxlines) {
-      size_t inc=il-maxlines;
-      if (inc<maxlines) inc=maxlines;
-      inc_maxlines(inc);
+      inc_maxlines(auto_inc(il));
     }
       
     // Now that maxlines is large enough, set the number of lines 
@@ -650,30 +754,16 @@ namespace o2scl {
   }
 
   /** \brief Manually increase the maximum number of lines
-   */
+
+      The columns are resized using \ref table_col_storage, so
+      for <tt>std::vector</tt> and <tt>boost::numeric::ublas::vector</tt>
+      columns the data is not copied through a temporary.
+  */
   void inc_maxlines(size_t llines) {
 
-    vec_t temp_col;
-    
-    // For the moment, we assume resizes are destructive, so
-    // we have to copy the data to a temporary and then
-    // copy it back
     for(aiter it=atree.begin();it!=atree.end();it++) {
-	
-      // Copy data to temporary array
-      temp_col.resize(maxlines+llines);
-      for(size_t j=0;j<maxlines;j++) {
-	temp_col[j]=it->second.dat[j];
-      }
-
-      // Resize
-      it->second.dat.resize(maxlines+llines);
-
-      // Copy data back to resized array
-      for(size_t j=0;j<maxlines;j++) {
-	it->second.dat[j]=temp_col[j];
-      }
-	
+      table_col_storage<vec_t>::resize(it->second.dat,maxlines+llines,
+				       maxlines);
     }
   
     maxlines+=llines;
@@ -681,6 +771,35 @@ namespace o2scl {
     return;
   }
 
+  /** \brief Reserve memory for \c n lines without changing
+      the maximum number of lines
+
+      This is a hint for tables which will grow to about \c n
+      lines through \ref line_of_data() or \ref set_nlines_auto().
+      For <tt>std::vector</tt> columns, the memory for \c n lines is
+      reserved in each column (and in columns created later), so
+      subsequent growth up to \c n lines never moves the data. For
+      vector types which do not preserve their contents on resize,
+      the first automatic increase in the table size goes directly
+      to \c n lines. Calling this function with \c n equal to zero
+      removes the hint.
+  */
+  void reserve_lines(size_t n) {
+    reserve_hint=n;
+    if (n>maxlines) {
+      for(aiter it=atree.begin();it!=atree.end();it++) {
+	table_col_storage<vec_t>::reserve(it->second.dat,n);
+      }
+    }
+    return;
+  }
+
+  /** \brief Return the current reserve hint (see \ref reserve_lines())
+   */
+  size_t get_reserve_lines() const {
+    return reserve_hint;
+  }
+
   /** \brief Manually set the maximum number of lines
 
       \note This function will call the error handler if
@@ -697,27 +816,8 @@ namespace o2scl {
 		 
     }
     
-    vec_t temp_col;
-    
-    // For the moment, we assume resizes are destructive, so
-    // we have to copy the data to a temporary and then
-    // copy it back
     for(aiter it=atree.begin();it!=atree.end();it++) {
-	
-      // Copy data to temporary array
-      temp_col.resize(llines);
-      for(size_t j=0;j<nlines;j++) {
-	temp_col[j]=it->second.dat[j];
-      }
-
-      // Resize
-      it->second.dat.resize(llines);
-
-      // Copy data back to resized array
-      for(size_t j=0;j<nlines;j++) {
-	it->second.dat[j]=temp_col[j];
-      }
-	
+      table_col_storage<vec_t>::resize(it->second.dat,llines,nlines);
     }
   
     maxlines=llines;
@@ -836,10 +936,13 @@ namespace o2scl {
       }
     }
     col s;
-    s.dat.resize(maxlines);
-    s.index=((int)atree.size());
     atree.insert(make_pair(head,s));
     aiter it=atree.find(head);
+    if (reserve_hint>maxlines) {
+      table_col_storage<vec_t>::reserve(it->second.dat,reserve_hint);
+    }
+    it->second.dat.resize(maxlines);
+    it->second.index=((int)alist.size());
     alist.push_back(it);
     return;
   }
@@ -1138,10 +1241,25 @@ namespace o2scl {
 
     // Add the new column
     if (!is_column(dest_col)) new_column(dest_col);
-  
+
+    const vec_t &xdest=get_column(dest_index);
+    for(size_t i=0;i<nlines;i++) {
+      if (!std::isfinite(xdest[i])) {
+	O2SCL_ERR2("Value of independent variable not finite in ",
+		   "table::add_col_from_table().",exc_einval);
+      }
+    }
+    
+    // Interpolate all of the rows at once
+    interp_vec<vec2_t> iv(source.get_nlines(),source.get_column(src_index),
+			  source.get_column(src_col),
+			  source.get_interp_type());
+    std::vector<double> res(nlines);
+    iv.eval_many(nlines,xdest,res);
+    
     // Fill the new column
     for(size_t i=0;i<nlines;i++) {
-      set(dest_col,i,source.interp(src_index,get(dest_index,i),src_col));
+      set(dest_col,i,res[i]);
     }
   
     return;
@@ -1213,13 +1331,30 @@ namespace o2scl {
       }
     }
 
+    // Copy the independent variable, since new columns may
+    // be added to this table
+    std::vector<double> xdest(get_nlines());
+    for(size_t j=0;j<get_nlines();j++) {
+      xdest[j]=get(dest_index,j);
+      if (allow_extrap && !std::isfinite(xdest[j])) {
+	O2SCL_ERR2("Value of independent variable not finite in ",
+		   "table::insert_table().",exc_einval);
+      }
+    }
+    
     // Create new columns and perform interpolation
+    std::vector<double> res(get_nlines());
     for(size_t i=0;i<col_list.size();i++) {
       if (!is_column(col_list[i])) new_column(col_list[i]);
+      interp_vec<vec2_t> iv(source.get_nlines(),
+			    source.get_column(src_index),
+			    source.get_column(col_list[i]),
+			    source.get_interp_type());
+      iv.eval_many(get_nlines(),xdest,res);
       for(size_t j=0;j<get_nlines();j++) {
-	double val=get(dest_index,j);
+	double val=xdest[j];
 	if (allow_extrap || (val>=min && val<=max)) {
-	  set(col_list[i],j,source.interp(src_index,val,col_list[i]));
+	  set(col_list[i],j,res[j]);
 	}
       }
     }
@@ -1289,8 +1424,7 @@ namespace o2scl {
 
     // If we're already at the maximum number of lines,
     // double it so that we can easily add more data later
-    if (maxlines==0) inc_maxlines(1);
-    else if (nlines>=maxlines) inc_maxlines(maxlines);
+    if (nlines>=maxlines) inc_maxlines(auto_inc(nlines+1));
 
     // Increase the nlines parameter
     nlines++;
@@ -1368,37 +1502,109 @@ namespace o2scl {
     return;
   }
 
-  /** \brief Delete all rows where \c func evaluates to a number greater
-      than 0.5 \f$ {\cal O}(R C) \f$
+  /** \brief Compute a mask which is nonzero for each row where 
+      \c func evaluates to a number greater than 0.5
 
-      If no rows match the delete condition, this function silently
-      performs no changes to the table.
+      The function is compiled once and evaluated in blocks of rows
+      with \ref function_vector(). If \c invert is true, then the
+      mask is instead nonzero for the rows where \c func evaluates
+      to a number less than 0.5. The mask is resized to the 
+      number of rows, and the number of nonzero entries in the 
+      mask is returned.
   */
-  void delete_rows_func(std::string func) {
-    size_t new_nlines=0;
+  size_t row_mask(std::string func, std::vector<char> &mask,
+		  bool invert=false) {
+    std::vector<double> vals;
+    function_vector(func,vals);
+    mask.resize(nlines);
+    size_t count=0;
     for(size_t i=0;i<nlines;i++) {
-      double val=row_function(func,i);
-      if (val<0.5) {
-	// If val<0.5, then the function was evaluated to false and
-	// we want to keep the row, but if i==new_nlines, then
-	// we don't need to copy because the row is already in
-	// the correct place.
-	if (i!=new_nlines) {
-	  for(aiter it=atree.begin();it!=atree.end();it++) {
-	    it->second.dat[new_nlines]=it->second.dat[i];
-	  }
-	}
-	new_nlines++;
+      if (invert) {
+	mask[i]=(vals[i]<0.5);
+      } else {
+	mask[i]=(vals[i]>0.5);
       }
+      if (mask[i]) count++;
     }
-    nlines=new_nlines;
-    if (intp_set==true) {
-      delete si;
-      intp_set=false;
+    return count;
+  }
+
+  /** \brief Keep only the rows for which \c mask is nonzero
+      \f$ {\cal O}(R C) \f$
+
+      The columns are compacted in place in parallel (if OpenMP 
+      is enabled), one column per thread. The vector \c mask 
+      must have at least as many entries as there are rows in
+      the table.
+  */
+  void compact_rows(const std::vector<char> &mask) {
+
+    if (mask.size()<nlines) {
+      O2SCL_ERR2("Mask too small in ",
+		 "table::compact_rows().",exc_einval);
+    }
+    
+    // Construct the list of rows to keep once for all columns
+    std::vector<size_t> keep;
+    for(size_t i=0;i<nlines;i++) {
+      if (mask[i]) keep.push_back(i);
     }
+    size_t new_nlines=keep.size();
+
+    if (new_nlines<nlines) {
+      
+      // Since keep[j]>=j, each column can be compacted in place
+      int ncols=((int)alist.size());
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(int k=0;k<ncols;k++) {
+	vec_t &dat=alist[k]->second.dat;
+	for(size_t j=0;j<new_nlines;j++) {
+	  if (keep[j]!=j) dat[j]=dat[keep[j]];
+	}
+      }
+      
+      nlines=new_nlines;
+      if (intp_set==true) {
+	delete si;
+	intp_set=false;
+      }
+    }
+    
+    return;
+  }
+  
+  /** \brief Delete all rows where \c func evaluates to a number greater
+      than or equal to 0.5 \f$ {\cal O}(R C) \f$
+
+      If no rows match the delete condition, this function silently
+      performs no changes to the table. The function is compiled
+      only once, see \ref row_mask() and \ref compact_rows().
+  */
+  void delete_rows_func(std::string func) {
+    std::vector<char> mask;
+    row_mask(func,mask,true);
+    compact_rows(mask);
     return;
   }
 
+  /** \brief Keep only the rows where \c func evaluates to a 
+      number greater than 0.5 \f$ {\cal O}(R C) \f$
+
+      The function is compiled only once, see \ref row_mask() and
+      \ref compact_rows(). The number of remaining rows is returned.
+      The threshold matches \ref copy_rows(). Note that rows where \c
+      func is exactly 0.5 are removed by both this function and
+      \ref delete_rows_func().
+  */
+  size_t select_rows(std::string func) {
+    std::vector<char> mask;
+    row_mask(func,mask);
+    compact_rows(mask);
+    return nlines;
+  }
+
   /** \brief Copy row \c ix from table \c src to the end of the
       current table
    */
@@ -1439,14 +1645,16 @@ namespace o2scl {
       }
     }
 
+    std::vector<char> mask;
+    size_t n_sel=row_mask(func,mask);
+    
     size_t new_lines=dest.get_nlines();
+    dest.set_nlines_auto(new_lines+n_sel);
     for(size_t i=0;i<nlines;i++) {
-      double val=row_function(func,i);
-      if (val>0.5) {
-	dest.set_nlines_auto(new_lines+1);
+      if (mask[i]) {
 	for(size_t j=0;j<get_ncolumns();j++) {
 	  std::string cname=get_column_name(j);
-	  dest.set(cname,new_lines);
+	  dest.set(cname,new_lines,get(cname,i));
 	}
 	new_lines++;
       }
@@ -1653,8 +1861,7 @@ namespace o2scl {
       geometrically to help avoid excessive memory rearrangements.
   */
   template<class vec2_t> void line_of_data(size_t nv, const vec2_t &v) {
-    if (maxlines==0) inc_maxlines(1);
-    if (nlines>=maxlines) inc_maxlines(maxlines);
+    if (nlines>=maxlines) inc_maxlines(auto_inc(nlines+1));
     
     if (intp_set) {
       intp_set=false;
@@ -1663,9 +1870,11 @@ namespace o2scl {
       
     if (nlines<maxlines && nv<=(atree.size())) {
 
-      set_nlines_auto(nlines+1);
+      // The interpolation object has already been reset and
+      // the column index checked, so store the data directly
+      nlines++;
       for(size_t i=0;i<nv;i++) {
-	(*this).set(i,nlines-1,v[i]);
+	alist[i]->second.dat[nlines-1]=v[i];
       }
 	
       return;
@@ -2926,6 +3135,26 @@ namespace o2scl {
   /** \name Parsing mathematical functions specified as strings
    */
   //@{
+  /** \brief Get the names of all columns and pointers to their
+      data, in the order used by \ref calculator::compile_slots()
+
+      If the table has no rows, the pointers are set to zero.
+  */
+  void get_column_slots(std::vector<std::string> &names,
+			std::vector<const double *> &ptrs) const {
+    names.clear();
+    ptrs.clear();
+    for(aciter it=atree.begin();it!=atree.end();it++) {
+      names.push_back(it->first);
+      if (maxlines>0) {
+	ptrs.push_back(&(it->second.dat[0]));
+      } else {
+	ptrs.push_back(0);
+      }
+    }
+    return;
+  }
+  
   /** \brief Create new columns or recompute from a list of functions
 	
       The list should be a space-delimited list of entries of the
@@ -2981,23 +3210,21 @@ namespace o2scl {
     
     std::vector<calculator> calcs(funcs.size());
     std::vector<vec_t> newcols(funcs.size());
+
+    std::vector<std::string> col_names;
+    std::vector<const double *> col_ptrs;
+    get_column_slots(col_names,col_ptrs);
     
     for(size_t j=0;j<funcs.size();j++) {
       calcs[j].compile(funcs[j].c_str(),&vars);
+      calcs[j].compile_slots(col_names);
       newcols[j].resize(maxlines);
     }
     
     // Calculate all of the columns in the newcols list:
-    for(size_t i=0;i<nlines;i++) {
-      
-      // Record the values of the variables for this line:
-      for(size_t j=0;j<atree.size();j++) {
-	vars[get_column_name(j)]=(*this)[j][i];
-      }
-      
-      // Evaluate the new columns
+    if (nlines>0) {
       for(size_t j=0;j<funcs.size();j++) {
-	newcols[j][i]=calcs[j].eval(&vars);
+	calcs[j].eval_columns(nlines,&col_ptrs[0],&(newcols[j][0]));
       }
     }
 
@@ -3046,15 +3273,13 @@ namespace o2scl {
       hold the number of entries given by \ref get_nlines(), it is
       resized.
 
-      \verbatim embed:rst
-      .. todo:: 
-
-         In table::function_vector(): FIXME: there may be a problem
-         with the OpenMP code if an exception is thrown in the
-         calculator class and there is not a unique error handler for
-         each thread.
-
-      \endverbatim
+      The function is compiled once with \ref
+      calculator::compile_slots() and then evaluated in blocks of
+      rows with \ref calculator::eval_columns(), so the results are
+      identical to those from \ref calculator::eval() but no
+      variable lookups are required for each row. All of the
+      compilation (and thus any exceptions from the calculator
+      class) happens outside the OpenMP parallel region.
 
       \comment
       This function must return an int rather than void because
@@ -3065,12 +3290,34 @@ namespace o2scl {
   int function_vector(std::string function, resize_vec_t &vec,
 		      bool throw_on_err=true) {
 
+    // Resize vector if necessary (outside the parallel region)
+    if (vec.size()<nlines) vec.resize(nlines);
+
+    // Parse function and resolve the column names once. The
+    // calculator object is not modified by eval_columns(), so
+    // it can be shared by all threads.
+    calculator calc;
+    std::map<std::string,double> vars;
+    std::map<std::string,double>::const_iterator mit;
+    for(mit=constants.begin();mit!=constants.end();mit++) {
+      vars[mit->first]=mit->second;
+    }
+    calc.compile(function.c_str(),&vars);
+
+    std::vector<std::string> col_names;
+    std::vector<const double *> col_ptrs;
+    get_column_slots(col_names,col_ptrs);
+    calc.compile_slots(col_names);
+
+    if (nlines==0) return 0;
+    
+    // Columns are evaluated in blocks of this size
+    const size_t block=4096;
+    size_t n_blocks=(nlines+block-1)/block;
+    
     int n_threads=1;
     int i_thread=0;
     
-    // Resize vector if necessary (outside the parallel region)
-    if (vec.size()<nlines) vec.resize(nlines);
-      
 #ifdef O2SCL_OPENMP
 #pragma omp parallel private(i_thread)
 #endif
@@ -3081,21 +3328,22 @@ namespace o2scl {
       i_thread=omp_get_thread_num();
 #endif
 
-      // Parse function, separate calculator for each thread
-      calculator calc;
-      std::map<std::string,double> vars;
-      std::map<std::string,double>::const_iterator mit;
-      for(mit=constants.begin();mit!=constants.end();mit++) {
-	vars[mit->first]=mit->second;
-      }
-      calc.compile(function.c_str(),&vars);
-      
+      // Separate output and pointer storage for each thread
+      std::vector<double> out(block);
+      std::vector<const double *> ptrs(col_ptrs.size());
+
       // Create column from function
-      for(int j=i_thread;j<((int)nlines);j+=n_threads) {
-	for(aciter it=atree.begin();it!=atree.end();it++) {
-	  vars[it->first]=it->second.dat[j];
+      for(size_t ib=i_thread;ib<n_blocks;ib+=n_threads) {
+	size_t start=ib*block;
+	size_t nb=nlines-start;
+	if (nb>block) nb=block;
+	for(size_t k=0;k<col_ptrs.size();k++) {
+	  ptrs[k]=col_ptrs[k]+start;
+	}
+	calc.eval_columns(nb,ptrs.size()>0 ? &ptrs[0] : 0,&out[0]);
+	for(size_t j=0;j<nb;j++) {
+	  vec[start+j]=out[j];
 	}
-	vec[j]=calc.eval(&vars);
       }
 
       // End of parallel region
@@ -3138,13 +3386,19 @@ namespace o2scl {
     }
     calc.compile(function.c_str(),&vars);
 
+    std::vector<std::string> col_names;
+    std::vector<const double *> col_ptrs;
+    get_column_slots(col_names,col_ptrs);
+    calc.compile_slots(col_names);
+
     double best_val=0.0;
     size_t best_row=0;
+    std::vector<double> row_vals(col_ptrs.size());
     for(size_t row=0;row<nlines-1;row++) {
-      for(aciter it=atree.begin();it!=atree.end();it++) {
-	vars[it->first]=it->second.dat[row];
+      for(size_t k=0;k<col_ptrs.size();k++) {
+	row_vals[k]=col_ptrs[k][row];
       }
-      double dtemp=calc.eval(&vars);
+      double dtemp=calc.eval_slots(row_vals.size()>0 ? &row_vals[0] : 0);
       if (row==0) {
 	best_val=dtemp;
       } else {
@@ -3325,12 +3579,34 @@ namespace o2scl {
   size_t maxlines;
   /// The size of presently used memory
   size_t nlines;
+  /// The reserve hint (see \ref reserve_lines())
+  size_t reserve_hint;
   /// The tree of columns
   std::map<std::string,col,std::greater<std::string> > atree;
   /// The list of tree iterators
   std::vector<aiter> alist;
   //@}
   
+  /** \brief Return the number of lines to add to make room for
+      \c il lines, growing the table geometrically
+
+      The maximum number of lines is at least doubled. If a reserve
+      hint at least as large as \c il has been given, then the
+      growth is capped at the hint so that the data stays in the
+      reserved memory. If, in addition, the column storage does not
+      preserve its contents on resize, then the table grows directly
+      to the reserve hint.
+  */
+  size_t auto_inc(size_t il) {
+    size_t inc=il-maxlines;
+    if (inc<maxlines) inc=maxlines;
+    if (reserve_hint>=il && (!table_col_storage<vec_t>::preserves ||
+			     maxlines+inc>reserve_hint)) {
+      inc=reserve_hint-maxlines;
+    }
+    return inc;
+  }
+  
   /// \name Column manipulation methods
   //@{
   /// Return the iterator for a column
@@ -262,6 +262,7 @@ void table3d::set_xy(std::string x_name, uniform_grid<double> gx,
   gy.vector(yval);
   size_set=true;
   xy_set=true;
+  reset_icache();
 }
 
 int table3d::read_gen3_list(std::istream &fin, int verbose, double eps) {
@@ -534,6 +535,7 @@ void table3d::set_size(size_t nx, size_t ny) {
   numx=nx;
   numy=ny;
   size_set=true;
+  reset_icache();
   return;
 }
 
@@ -544,11 +546,13 @@ void table3d::set_slice_all(std::string name, double val) {
       (list[z])(i,j)=val;
     }
   }
+  reset_icache(z);
   return;
 }
 
 void table3d::set(size_t ix, size_t iy, std::string name, double val) {
   size_t z=lookup_slice(name);
+  reset_icache(z);
   (list[z])(ix,iy)=val;
   return;
 }
@@ -559,6 +563,7 @@ void table3d::set_val(double x, double y, std::string name, double val) {
   lookup_y(y,iy);
   
   size_t z=lookup_slice(name);
+  reset_icache(z);
   (list[z])(ix,iy)=val;
   return;
 }
@@ -571,11 +576,13 @@ void table3d::set_val_ret(double &x, double &y, std::string name, double val) {
   y=yval[iy];
 
   size_t z=lookup_slice(name);
+  reset_icache(z);
   (list[z])(ix,iy)=val;
   return;
 }
     
 void table3d::set(size_t ix, size_t iy, size_t z, double val) {
+  reset_icache(z);
   (list[z])(ix,iy)=val;
   return;
 }
@@ -587,6 +594,7 @@ void table3d::set_val(double x, double y, size_t z, double val) {
   x=xval[ix];
   y=yval[iy];
   
+  reset_icache(z);
   (list[z])(ix,iy)=val;
   return;
 }
@@ -596,12 +604,14 @@ void table3d::set_val_ret(double &x, double &y, size_t z, double val) {
   lookup_x(x,ix);
   lookup_y(y,iy);
 
+  reset_icache(z);
   (list[z])(ix,iy)=val;
   return;
 }
     
 double &table3d::get(size_t ix, size_t iy, std::string name) {
   size_t z=lookup_slice(name);
+  reset_icache(z);
   return (list[z])(ix,iy);
 }
 
@@ -617,6 +627,7 @@ double &table3d::get_val_ret(double &x, double &y, std::string name) {
   x=xval[ix];
   y=yval[iy];
   size_t z=lookup_slice(name);
+  reset_icache(z);
   return (list[z])(ix,iy);
 }
 
@@ -636,6 +647,7 @@ double &table3d::get_val(double x, double y, std::string name) {
   lookup_x(x,ix);
   lookup_y(y,iy);
   size_t z=lookup_slice(name);
+  reset_icache(z);
   return (list[z])(ix,iy);
 }
     
@@ -648,6 +660,7 @@ const double &table3d::get_val(double x, double y, std::string name) const {
 }
     
 double &table3d::get(size_t ix, size_t iy, size_t z) {
+  reset_icache(z);
   return (list[z])(ix,iy);
 }
 
@@ -661,6 +674,7 @@ double &table3d::get_val_ret(double &x, double &y, size_t z) {
   lookup_y(y,iy);
   x=xval[ix];
   y=yval[iy];
+  reset_icache(z);
   return (list[z])(ix,iy);
 }
 
@@ -677,6 +691,7 @@ double &table3d::get_val(double x, double y, size_t z) {
   size_t ix=0, iy=0;
   lookup_x(x,ix);
   lookup_y(y,iy);
+  reset_icache(z);
   return (list[z])(ix,iy);
 }
 
@@ -690,6 +705,7 @@ const double &table3d::get_val(double x, double y, size_t z) const {
 void table3d::set_grid_x(size_t ix, double val) {
   if (ix<numx) {
     (xval)[ix]=val;
+    reset_icache();
     return;
   }
   O2SCL_ERR((((string)"Index '")+itos(ix)+"' out of range ('"+itos(numx)+
@@ -700,6 +716,7 @@ void table3d::set_grid_x(size_t ix, double val) {
 void table3d::set_grid_y(size_t iy, double val) {
   if (iy<numy) {
     (yval)[iy]=val;
+    reset_icache();
     return;
   }
   O2SCL_ERR((((string)"Index '")+itos(iy)+"' out of range ('"+itos(numy)+
@@ -775,6 +792,8 @@ void table3d::new_slice(std::string name) {
   list.push_back(mp);
   tree.insert(make_pair(name,list.size()-1));
   has_slice=true;
+  // Adding a slice may move the other slices in memory
+  reset_icache();
   return;
 }
 
@@ -843,6 +862,7 @@ void table3d::init_slice(std::string scol, double val) {
       (list[sl1])(i,j)=val;
     }
   }
+  reset_icache(sl1);
   return;
 }
   
@@ -901,6 +921,7 @@ void table3d::lookup(double val, std::string slice, size_t &ix,
 
 void table3d::set_interp_type(size_t interp_type) {
   itype=interp_type;
+  reset_icache();
   return;
 }
 
@@ -908,10 +929,58 @@ size_t table3d::get_interp_type() const {
   return itype;
 }
 
+void table3d::clear_interp_cache() {
+  reset_icache();
+  return;
+}
+
+std::shared_ptr<table3d::interp2_t> table3d::get_icache(size_t z) const {
+
+  std::shared_ptr<interp2_t> ret;
+  
+  if (itype!=itp_linear && itype!=itp_cspline &&
+      itype!=itp_cspline_peri) {
+    return ret;
+  }
+  size_t n_min=2;
+  if (itype!=itp_linear) n_min=3;
+  if (numx<n_min || numy<n_min) return ret;
+
+#ifdef O2SCL_OPENMP
+#pragma omp critical (o2scl_table3d_icache)
+#endif
+  {
+    if (icache.size()!=list.size()) icache.resize(list.size());
+    ret=icache[z];
+  }
+  if (ret) return ret;
+
+  // Compute the coefficients outside of the critical region since
+  // set_data() may throw an exception. The interp2_direct object
+  // only reads the grid and the slice.
+  ret=std::make_shared<interp2_t>();
+  ret->set_data(numx,numy,const_cast<ubvector &>(xval),
+		const_cast<ubvector &>(yval),
+		const_cast<ubmatrix &>(list[z]),itype);
+  
+#ifdef O2SCL_OPENMP
+#pragma omp critical (o2scl_table3d_icache)
+#endif
+  {
+    if (icache.size()!=list.size()) icache.resize(list.size());
+    icache[z]=ret;
+  }
+  
+  return ret;
+}
+
 double table3d::interp(double x, double y, std::string name) const {
   double result;
   
   size_t z=lookup_slice(name);
+
+  std::shared_ptr<interp2_t> ic=get_icache(z);
+  if (ic) return ic->eval(x,y);
   
   interp_vec<ubvector,ubmatrix_column> itp;
   
@@ -945,6 +1014,16 @@ void table3d::deriv_y(std::string fname, std::string fpname) {
     new_slice(fpname);
     zp=lookup_slice(fpname);
   }
+
+  std::shared_ptr<interp2_t> ic=get_icache(z);
+  if (ic) {
+    for(size_t i=0;i<numx;i++) {
+      for(size_t j=0;j<numy;j++) {
+	set(i,j,zp,ic->deriv_y(xval[i],yval[j]));
+      }
+    }
+    return;
+  }
   
   interp_vec<ubvector,ubmatrix_row> itp;
 
@@ -952,7 +1031,7 @@ void table3d::deriv_y(std::string fname, std::string fpname) {
     ubmatrix_row row(list[z],i);
     itp.set(numy,yval,row,itype);
     for(size_t j=0;j<numy;j++) {
-      set(i,j,zp,itp.deriv(xval[i]));
+      set(i,j,zp,itp.deriv(yval[j]));
     }
   }
   
@@ -967,6 +1046,16 @@ void table3d::deriv_x(std::string fname, std::string fpname) {
     new_slice(fpname);
     zp=lookup_slice(fpname);
   }
+
+  std::shared_ptr<interp2_t> ic=get_icache(z);
+  if (ic) {
+    for(size_t i=0;i<numx;i++) {
+      for(size_t j=0;j<numy;j++) {
+	set(i,j,zp,ic->deriv_x(xval[i],yval[j]));
+      }
+    }
+    return;
+  }
   
   interp_vec<ubvector,ubmatrix_column> itp;
 
@@ -985,6 +1074,9 @@ double table3d::deriv_x(double x, double y, std::string name) const {
   double result;
   
   size_t z=lookup_slice(name);
+
+  std::shared_ptr<interp2_t> ic=get_icache(z);
+  if (ic) return ic->deriv_x(x,y);
   
   interp_vec<ubvector,ubmatrix_column> itp;
 
@@ -1005,6 +1097,9 @@ double table3d::deriv_y(double x, double y, std::string name) const {
   double result;
   
   size_t z=lookup_slice(name);
+
+  std::shared_ptr<interp2_t> ic=get_icache(z);
+  if (ic) return ic->deriv_y(x,y);
   
   interp_vec<ubvector,ubmatrix_column> itp;
 
@@ -1067,6 +1162,9 @@ double table3d::deriv_xy(double x, double y, std::string name) const {
   double result;
   
   size_t z=lookup_slice(name);
+
+  std::shared_ptr<interp2_t> ic=get_icache(z);
+  if (ic) return ic->deriv_xy(x,y);
   
   interp_vec<ubvector,ubmatrix_column> itp;
 
@@ -1091,6 +1189,7 @@ void table3d::zero_table() {
       }
     }
   }
+  reset_icache();
   return;
 }
 
@@ -1112,6 +1211,7 @@ void table3d::clear_data() {
     list[i].clear();
   }
   list.clear();
+  reset_icache();
       
   has_slice=false;
   return;
@@ -1304,10 +1404,12 @@ const boost::numeric::ublas::matrix<double> &table3d::get_slice
 boost::numeric::ublas::matrix<double> &table3d::get_slice
 (std::string name) {
   size_t z=lookup_slice(name);
+  reset_icache(z);
   return list[z];
 }
 
 boost::numeric::ublas::matrix<double> &table3d::get_slice(size_t iz) {
+  reset_icache(iz);
   return list[iz];
 }
 
@@ -1324,6 +1426,7 @@ void table3d::function_slice(string function, string scol) {
   }
 
   function_matrix(function,list[ic]);
+  reset_icache(ic);
 
   return;
 }
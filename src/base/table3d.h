@@ -33,6 +33,7 @@
 #include <string>
 #include <cmath>
 #include <sstream>
+#include <memory>
 
 #include <fnmatch.h>
 
@@ -46,6 +47,7 @@
 #include <o2scl/search_vec.h>
 #include <o2scl/uniform_grid.h>
 #include <o2scl/interp.h>
+#include <o2scl/interp2_direct.h>
 #include <o2scl/table_units.h>
 #include <o2scl/contour.h>
 #include <o2scl/shunting_yard.h>
@@ -73,6 +75,17 @@ namespace o2scl {
   /** \brief A data structure containing one or more slices of
       two-dimensional data points defined on a grid
 
+      For linear and cubic spline interpolation (the default), the
+      interpolation and derivative functions store the bilinear or
+      bicubic coefficients for each slice the first time they are
+      needed, so later calls only require a binary search in each
+      direction. This cache is reset by every function which can
+      modify the slice, including the functions which return a
+      non-const reference. If a slice is modified through a reference
+      obtained before the most recent call to interp(), then
+      clear_interp_cache() must be called. Other interpolation types
+      use successive one-dimensional interpolation for each call.
+
       \future Improve interpolation and derivative caching, possibly
       through non-const versions of the interpolation functions.
       \future Should there be a clear_grid() function separate from
@@ -144,6 +157,7 @@ namespace o2scl {
       for(size_t i=0;i<ny;i++) (yval)[i]=y[i];
       size_set=true;
       xy_set=true;
+      reset_icache();
       return;
     }
 
@@ -257,6 +271,7 @@ namespace o2scl {
       for(size_t i=0;i<nv && i<list.size();i++) {
 	list[i](ix,iy)=vals[i];
       }
+      reset_icache();
       return;
     }
     
@@ -338,6 +353,7 @@ namespace o2scl {
       for(size_t i=0;i<nv && i<list.size();i++) {
 	list[i](ix,iy)=vals[i];
       }
+      reset_icache();
       return;
     }
 
@@ -562,6 +578,14 @@ namespace o2scl {
     */
     double integ_y(double x, double y1, double y2, std::string name) const;
 
+    /** \brief Clear the cached interpolation coefficients for
+	all slices
+
+	This is only necessary if a slice was modified through a
+	reference obtained before the last interpolation.
+    */
+    void clear_interp_cache();
+
     /** \brief Fill a vector of interpolated values from each slice at the
 	point <tt>x,y</tt>
     */
@@ -1204,6 +1228,37 @@ namespace o2scl {
     /// The interpolation type
     size_t itype;
     //@}
+
+    /// \name Interpolation cache
+    //@{
+    /// The type of the cached interpolation objects
+    typedef interp2_direct<ubvector,ubmatrix> interp2_t;
+
+    /** \brief Cached interpolation objects for each slice (empty
+	pointers for slices which do not have a cache yet)
+    */
+    mutable std::vector<std::shared_ptr<interp2_t> > icache;
+
+    /** \brief Return the cached interpolation object for slice
+	\c z, creating it if necessary
+
+	This returns an empty pointer if the interpolation type or 
+	the grid size is not supported by \ref interp2_direct.
+    */
+    std::shared_ptr<interp2_t> get_icache(size_t z) const;
+
+    /// Reset the interpolation cache for slice \c z
+    void reset_icache(size_t z) {
+      if (z<icache.size() && icache[z]) icache[z].reset();
+      return;
+    }
+
+    /// Reset the interpolation cache for all slices
+    void reset_icache() {
+      icache.clear();
+      return;
+    }
+    //@}
   
     /// \name Tree iterator boundaries
     //@{
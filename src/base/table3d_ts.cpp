@@ -32,6 +32,28 @@ using namespace o2scl_hdf;
 #endif
 
 typedef boost::numeric::ublas::vector<double> ubvector;
+typedef boost::numeric::ublas::matrix<double> ubmatrix;
+typedef boost::numeric::ublas::matrix_column<const ubmatrix> ubmatrix_column;
+
+/* Successive one-dimensional interpolation along x and then y, with
+   derivatives in x if \c dx is true and in y if \c dy is true
+*/
+double interp_seq(table3d &t3, double x, double y, size_t itype,
+		  bool dx, bool dy) {
+  const ubmatrix &m=((const table3d &)t3).get_slice("z");
+  size_t nx=t3.get_nx(), ny=t3.get_ny();
+  ubvector icol(ny);
+  for(size_t j=0;j<ny;j++) {
+    ubmatrix_column col(m,j);
+    interp_vec<ubvector,ubmatrix_column> itp(nx,t3.get_x_data(),col,itype);
+    if (dx) icol[j]=itp.deriv(x);
+    else icol[j]=itp.eval(x);
+  }
+  interp_vec<ubvector> ity(ny,t3.get_y_data(),icol,itype);
+  if (dy) return ity.deriv(y);
+  return ity.eval(y);
+}
+
 
 int main(void) {
 
@@ -247,6 +269,56 @@ int main(void) {
     }
   */
 
+  // Compare the cached interpolation coefficients with successive
+  // one-dimensional interpolation and make sure the cache is reset
+  // when the slice is modified
+  {
+    table3d t3;
+    ubvector gx(7), gy(6);
+    for(size_t i=0;i<7;i++) gx[i]=((double)i)+0.1*((double)(i*i));
+    for(size_t j=0;j<6;j++) gy[j]=0.5*((double)j)-0.05*((double)(j*j));
+    t3.set_xy("x",7,gx,"y",6,gy);
+    t3.new_slice("z");
+    for(size_t i=0;i<7;i++) {
+      for(size_t j=0;j<6;j++) {
+	t3.set(i,j,"z",sin(gx[i])*exp(0.3*gy[j])+gx[i]*gy[j]);
+      }
+    }
+
+    for(size_t k=0;k<2;k++) {
+      size_t itype=itp_cspline;
+      if (k==1) {
+	itype=itp_linear;
+	t3.set_interp_type(itype);
+      }
+      for(double x=-0.3;x<9.5;x+=0.7) {
+	for(double y=-0.2;y<2.3;y+=0.3) {
+	  t.test_rel(t3.interp(x,y,"z"),
+		     interp_seq(t3,x,y,itype,false,false),
+		     1.0e-10,"cached interp");
+	  t.test_abs(t3.deriv_x(x,y,"z"),
+		     interp_seq(t3,x,y,itype,true,false),
+		     1.0e-9,"cached deriv_x");
+	  t.test_abs(t3.deriv_y(x,y,"z"),
+		     interp_seq(t3,x,y,itype,false,true),
+		     1.0e-9,"cached deriv_y");
+	}
+      }
+    }
+
+    t3.set_interp_type(itp_cspline);
+    double v1=t3.interp(2.5,1.1,"z");
+    t3.set(2,3,"z",10.0);
+    double v2=t3.interp(2.5,1.1,"z");
+    t.test_gen(v1!=v2,"cache reset by set()");
+    t.test_rel(v2,interp_seq(t3,2.5,1.1,itp_cspline,false,false),
+	       1.0e-12,"cache reset by set() 2");
+    t3.get_slice("z")(3,2)=-5.0;
+    t.test_rel(t3.interp(2.5,1.1,"z"),
+	       interp_seq(t3,2.5,1.1,itp_cspline,false,false),
+	       1.0e-12,"cache reset by get_slice()");
+  }
+
   t.report();
 
   return 0;
@@ -211,7 +211,85 @@ int main(void) {
   for(size_t i=0;i<tabx.get_nlines();i++) {
     cout << tabx.get("x",i) << " " << tabx.get("y",i) << endl;
   }
-  
+
+  // -------------------------------------------------------------
+  // Test select_rows(), delete_rows_func(), and copy_rows()
+
+  {
+    table<> tabs;
+    tabs.line_of_names("x y");
+    for(size_t i=0;i<100;i++) {
+      double line[2]={((double)i),((double)i)*3.0};
+      tabs.line_of_data(2,line);
+    }
+    tabs.add_constant("cut",50.0);
+
+    table<> tabs2;
+    tabs.copy_rows("x<cut && y>30",tabs2);
+    t.test_gen(tabs2.get_nlines()==39,"copy_rows 1");
+    t.test_rel(tabs2.get("x",0),11.0,1.0e-12,"copy_rows 2");
+    t.test_rel(tabs2.get("y",38),147.0,1.0e-12,"copy_rows 3");
+    t.test_gen(tabs.get_nlines()==100,"copy_rows 4");
+
+    size_t n_sel=tabs.select_rows("x<cut && y>30");
+    t.test_gen(n_sel==39,"select_rows 1");
+    t.test_gen(tabs.get_nlines()==39,"select_rows 2");
+    bool match=true;
+    for(size_t i=0;i<tabs.get_nlines();i++) {
+      if (tabs.get("x",i)!=tabs2.get("x",i) ||
+	  tabs.get("y",i)!=tabs2.get("y",i)) match=false;
+    }
+    t.test_gen(match,"select_rows 3");
+
+    tabs.delete_rows_func("x>=20 && x<30");
+    t.test_gen(tabs.get_nlines()==29,"delete_rows_func 1");
+    t.test_rel(tabs.get("x",8),19.0,1.0e-12,"delete_rows_func 2");
+    t.test_rel(tabs.get("x",9),30.0,1.0e-12,"delete_rows_func 3");
+    t.test_rel(tabs.get("y",9),90.0,1.0e-12,"delete_rows_func 4");
+
+    tabs.select_rows("x>1000");
+    t.test_gen(tabs.get_nlines()==0,"select_rows 4");
+  }
+
+  // -------------------------------------------------------------
+  // Test table growth and reserve_lines()
+
+  {
+    table<> tabg;
+    tabg.reserve_lines(1000);
+    tabg.line_of_names("x y");
+    tabg.new_column("z");
+    const double *p0=0;
+    for(size_t i=0;i<1000;i++) {
+      double line[3]={((double)i),((double)i)*3.0,((double)i)*5.0};
+      tabg.line_of_data(3,line);
+      if (i==0) p0=&(tabg.get_column("z")[0]);
+    }
+    t.test_gen(tabg.get_nlines()==1000,"reserve 1");
+    t.test_gen(tabg.get_maxlines()==1000,"reserve 2");
+    t.test_gen(p0==&(tabg.get_column("z")[0]),"reserve 3");
+    t.test_rel(tabg.get("x",999),999.0,1.0e-12,"reserve 4");
+    t.test_rel(tabg.get("z",500),2500.0,1.0e-12,"reserve 5");
+    tabg.set_maxlines(1000);
+    t.test_rel(tabg.get("y",999),2997.0,1.0e-12,"reserve 6");
+
+    table<ubvector> tabu;
+    tabu.reserve_lines(100);
+    tabu.line_of_names("x y");
+    for(size_t i=0;i<300;i++) {
+      double line[2]={((double)i),((double)i)*3.0};
+      tabu.line_of_data(2,line);
+    }
+    tabu.new_row(0);
+    bool match=true;
+    for(size_t i=0;i<300;i++) {
+      if (tabu.get("x",i+1)!=((double)i) ||
+	  tabu.get("y",i+1)!=((double)i)*3.0) match=false;
+    }
+    t.test_gen(tabu.get_nlines()==301,"growth ublas 1");
+    t.test_gen(match,"growth ublas 2");
+  }
+
   t.report();
 
   return 0;
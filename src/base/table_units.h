@@ -320,11 +320,13 @@ namespace o2scl {
 	dest.set_unit(cname,get_unit(cname));
       }
     
+      std::vector<char> mask;
+      size_t n_sel=this->row_mask(func,mask);
+      
       size_t new_lines=dest.get_nlines();
+      dest.set_nlines_auto(new_lines+n_sel);
       for(size_t i=0;i<this->get_nlines();i++) {
-	double val=this->row_function(func,i);
-	if (val>0.5) {
-	  this->set_nlines_auto(new_lines+1);
+	if (mask[i]) {
 	  for(size_t j=0;j<this->get_ncolumns();j++) {
 	    std::string cname=this->get_column_name(j);
 	    dest.set(cname,new_lines,this->get(cname,i));
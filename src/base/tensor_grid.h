@@ -33,6 +33,10 @@
 #include <fstream>
 #include <sstream>
 
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
+
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_ieee_utils.h>
 
@@ -1388,6 +1392,14 @@ namespace o2scl {
         O2SCL_ERR2("Tried to interpolate in empty tensor in ",
                    "tensor_grid::interp_linear().",o2scl::exc_einval);
       }
+
+      // For small ranks, use the allocation-free version with
+      // a temporary set of caches
+      if (this->rk<=max_cache_rank) {
+        size_t cache[max_cache_rank];
+        for(size_t i=0;i<this->rk;i++) cache[i]=this->size[i]/2;
+        return interp_linear_cache(v,cache);
+      }
       
       // Find the the corner of the hypercube containing v
       size_t rgs=0;
@@ -1469,6 +1481,167 @@ namespace o2scl {
       return tnew.interp_linear_power_two(v);
     }
 
+    /** \brief The largest rank supported by 
+        \ref interp_linear_cache()
+    */
+    static const size_t max_cache_rank=10;
+    
+    /** \brief Perform a linear interpolation of \c v using
+        the caller-specified search caches in \c cache
+
+        This function gives the same result as \ref interp_linear(),
+        but performs no heap allocations. The vector \c cache must
+        have one entry for each index of the tensor, and holds the
+        lower grid index of the interval found in the last call
+        (entries which are out of range are reset). When
+        consecutive points are close to each other, the grid search
+        in each direction is then typically \f$ {\cal O}(1) \f$ .
+        The \f$ 2^{\mathrm{rank}} \f$ corners of the hypercube
+        are stored in a stack-allocated array and then reduced in
+        place in the same order as \ref interp_linear_power_two(),
+        so the result is identical to that of \ref interp_linear().
+        
+        This function does not modify the tensor, so it may be
+        called from several threads simultaneously, so long as
+        each thread uses its own \c cache. The rank must be no
+        larger than \ref max_cache_rank . 
+    */
+    template<class vec2_t, class size_vec2_t>
+      double interp_linear_cache(const vec2_t &v, size_vec2_t &cache) const {
+
+      if (this->rk==0 || this->rk>max_cache_rank) {
+        O2SCL_ERR2("Rank zero or too large in ",
+                   "tensor_grid::interp_linear_cache().",o2scl::exc_einval);
+      }
+      
+      // Find the lower corner of the hypercube containing v and
+      // the corresponding fractions and the index strides
+      size_t loc[max_cache_rank];
+      size_t stride[max_cache_rank];
+      double glo[max_cache_rank], ghi[max_cache_rank];
+      size_t rgs=0;
+      for(size_t i=0;i<this->rk;i++) {
+        size_t n=this->size[i];
+        if (n<2) {
+          O2SCL_ERR2("Grid size smaller than two in ",
+                     "tensor_grid::interp_linear_cache().",
+                     o2scl::exc_einval);
+        }
+        size_t c=cache[i];
+        if (c>n-2) c=n/2;
+        if (c>n-2) c=n-2;
+        // Cached search, analogous to search_vec::find_const(),
+        // performed directly on the packed grid
+        double x0=v[i];
+        if (grid[rgs]<grid[rgs+n-1]) {
+          if (x0<grid[rgs+c]) {
+            c=vector_bsearch_inc<vec_t,double>(x0,grid,rgs,rgs+c)-rgs;
+          } else if (x0>=grid[rgs+c+1]) {
+            c=vector_bsearch_inc<vec_t,double>(x0,grid,rgs+c,
+                                               rgs+n-1)-rgs;
+          }
+        } else {
+          if (x0>grid[rgs+c]) {
+            c=vector_bsearch_dec<vec_t,double>(x0,grid,rgs,rgs+c)-rgs;
+          } else if (x0<=grid[rgs+c+1]) {
+            c=vector_bsearch_dec<vec_t,double>(x0,grid,rgs+c,
+                                               rgs+n-1)-rgs;
+          }
+        }
+        cache[i]=c;
+        loc[i]=c;
+        glo[i]=grid[rgs+c];
+        ghi[i]=grid[rgs+c+1];
+        rgs+=n;
+      }
+      stride[this->rk-1]=1;
+      for(size_t i=this->rk-1;i>0;i--) {
+        stride[i-1]=stride[i]*this->size[i];
+      }
+      size_t base=0;
+      for(size_t i=0;i<this->rk;i++) base+=loc[i]*stride[i];
+
+      // Fetch the corners of the hypercube, with the last index
+      // varying fastest
+      double corner[1 << max_cache_rank];
+      size_t ncorner=((size_t)1) << this->rk;
+      for(size_t k=0;k<ncorner;k++) {
+        size_t ix=base;
+        for(size_t i=0;i<this->rk;i++) {
+          if ((k >> (this->rk-1-i)) & 1) ix+=stride[i];
+        }
+        corner[k]=this->data[ix];
+      }
+
+      // Remove the last index through linear interpolation
+      // until only the first index remains
+      for(size_t i=this->rk-1;i>0;i--) {
+        double frac=(v[i]-glo[i])/(ghi[i]-glo[i]);
+        ncorner/=2;
+        for(size_t k=0;k<ncorner;k++) {
+          double val_lo=corner[2*k];
+          double val_hi=corner[2*k+1];
+          corner[k]=val_lo+frac*(val_hi-val_lo);
+        }
+      }
+
+      return corner[0]+(corner[1]-corner[0])/(ghi[0]-glo[0])*(v[0]-glo[0]);
+    }
+
+    /** \brief Perform linear interpolation for \c n points
+
+        The coordinates of point \c i are stored in
+        <tt>pts[i*rank]</tt> to <tt>pts[i*rank+rank-1]</tt> and the
+        results are stored in <tt>res[0]</tt> to <tt>res[n-1]</tt>,
+        which must already have sufficient size. The points are
+        divided into contiguous blocks, one per OpenMP thread, and
+        each thread uses its own set of caches for \ref
+        interp_linear_cache(). Interpolation is thus fastest if
+        nearby points are stored next to each other.
+    */
+    template<class vec2_t, class vec3_t>
+      void interp_linear_many(size_t n, const vec2_t &pts,
+                              vec3_t &res) const {
+
+      if (this->rk==0 || this->rk>max_cache_rank) {
+        O2SCL_ERR2("Rank zero or too large in ",
+                   "tensor_grid::interp_linear_many().",o2scl::exc_einval);
+      }
+      
+      int n_threads=1;
+      int i_thread=0;
+      
+#ifdef O2SCL_OPENMP
+#pragma omp parallel private(i_thread)
+#endif
+      {
+        
+#ifdef O2SCL_OPENMP
+        n_threads=omp_get_num_threads();
+        i_thread=omp_get_thread_num();
+#endif
+        
+        // Separate caches and point for each thread
+        size_t cache[max_cache_rank];
+        double pt[max_cache_rank];
+        for(size_t i=0;i<this->rk;i++) cache[i]=this->size[i]/2;
+
+        size_t chunk=(n+n_threads-1)/n_threads;
+        size_t start=chunk*i_thread;
+        size_t end=start+chunk;
+        if (end>n) end=n;
+        
+        for(size_t j=start;j<end;j++) {
+          for(size_t i=0;i<this->rk;i++) pt[i]=pts[j*this->rk+i];
+          res[j]=interp_linear_cache(pt,cache);
+        }
+        
+        // End of parallel region
+      }
+      
+      return;
+    }
+    
     /** \brief Perform a linear interpolation of <tt>v[1]</tt>
         to <tt>v[n-1]</tt> resulting in a vector
 
@@ -203,6 +203,59 @@ int main(void) {
       t.test_rel(res3[2],res2,1.0e-12,"interp_linear_vec 10");
     }
 
+    // Test interp_linear_many() and interp_linear_cache(),
+    // including points outside the grid
+    if (true) {
+      size_t np=50;
+      std::vector<double> pts(np*3), resm(np);
+      for(size_t j=0;j<np;j++) {
+	pts[j*3]=0.5+4.0*((double)j)/((double)np);
+	pts[j*3+1]=3.5-3.0*((double)j)/((double)np);
+	pts[j*3+2]=1.0+sin((double)j);
+      }
+      m3.interp_linear_many(np,pts,resm);
+      std::vector<size_t> cache(3,0);
+      bool match=true;
+      for(size_t j=0;j<np;j++) {
+	for(size_t i=0;i<3;i++) v[i]=pts[j*3+i];
+	if (resm[j]!=m3.interp_linear(v)) match=false;
+	if (resm[j]!=m3.interp_linear_cache(v,cache)) match=false;
+      }
+      t.test_gen(match,"interp_linear_many");
+
+      // Linear interpolation and extrapolation are exact for a
+      // function which is linear in each coordinate, so compare
+      // with the analytic values
+      tensor_grid<> m3l;
+      m3l.resize(3,i3);
+      m3l.set_grid_packed(grid);
+      for(size_t i=0;i<i3[0];i++) {
+	for(size_t j=0;j<i3[1];j++) {
+	  for(size_t k=0;k<i3[2];k++) {
+	    double x=m3l.get_grid(0,i);
+	    double y=m3l.get_grid(1,j);
+	    double z=m3l.get_grid(2,k);
+	    j3[0]=i;
+	    j3[1]=j;
+	    j3[2]=k;
+	    m3l.set(j3,1.5*x-2.0*y+0.5*z+0.25*x*y*z);
+	  }
+	}
+      }
+      m3l.interp_linear_many(np,pts,resm);
+      for(size_t j=0;j<np;j++) {
+	double x=pts[j*3], y=pts[j*3+1], z=pts[j*3+2];
+	t.test_rel(resm[j],1.5*x-2.0*y+0.5*z+0.25*x*y*z,1.0e-12,
+		   "interp_linear_many exact");
+      }
+      // A point below and a point above the grid in every direction
+      std::vector<double> pts2={0.0,-1.0,0.5,5.5,4.0,4.5}, resm2(2);
+      m3l.interp_linear_many(2,pts2,resm2);
+      t.test_rel(resm2[0],2.25,1.0e-12,"interp_linear_many below");
+      t.test_rel(resm2[1],27.25,1.0e-12,
+		 "interp_linear_many above");
+    }
+
   }
 
   // -------------------------------------------------------
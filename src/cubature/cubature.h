@@ -412,6 +412,33 @@ namespace o2scl {
     return;
   }
 
+  /** \brief Evaluate the integrand at \c npts points, dividing
+      the points among \ref n_threads threads
+
+      The points are divided into contiguous blocks, so each thread
+      writes to a separate part of \c vals and the results do not
+      depend on the number of threads.
+  */
+  int eval_points(func_t &f, size_t dim, size_t npts, const double *pts,
+		  size_t fdim, double *vals) {
+    
+#ifdef O2SCL_OPENMP
+    if (n_threads>1 && npts>=2*n_threads) {
+      int ret=0;
+      size_t nt=n_threads;
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(|:ret)
+      for(size_t it=0;it<nt;it++) {
+	size_t i0=it*npts/nt;
+	size_t i1=(it+1)*npts/nt;
+	if (f(dim,i1-i0,pts+i0*dim,fdim,vals+i0*fdim)) ret=1;
+      }
+      return ret;
+    }
+#endif
+    
+    return f(dim,npts,pts,fdim,vals);
+  }
+
   /** \brief Desc
 
       \note All regions must have same fdim 
@@ -722,7 +749,7 @@ namespace o2scl {
       }
 
       /* Evaluate the integrand function(s) at all the points */
-      if (f(dim, npts, &(pts2[0]), fdim, vals)) {
+      if (eval_points(f, dim, npts, &(pts2[0]), fdim, vals)) {
 	return o2scl::gsl_failure;
       }
 
@@ -914,7 +941,7 @@ namespace o2scl {
 	R[iR].splitDim = 0; /* no choice but to divide 0th dimension */
       }
 
-      if (f(1, npts, pts, fdim, vals)) {
+      if (eval_points(f, 1, npts, pts, fdim, vals)) {
 	return o2scl::gsl_failure;
       }
      
@@ -1344,6 +1371,10 @@ namespace o2scl {
 	    }
 	    R[nR] = heap_pop(regions);
 	    for (j = 0; j < fdim; ++j) ee[j].err -= R[nR].ee[j].err;
+	    if (cut_region(R[nR], R[nR+1])) {
+	      heap_free(regions);
+	      return o2scl::gsl_failure;
+	    }
 	    numEval += r.num_points * 2;
 	    nR += 2;
 	    if (converged(fdim, ee, reqAbsError, reqRelError, norm)) {
@@ -1441,11 +1472,34 @@ namespace o2scl {
     
   public:
 
-    /// Desc
+    /** \brief If true, evaluate all of the regions which must be
+	refined to reach the requested tolerance at once (default 0)
+
+	This increases the number of points passed to each call
+	of the integrand, which is helpful for integrands which
+	are vectorized or when \ref n_threads is greater than one.
+    */
     int use_parallel;
+
+    /** \brief Number of OpenMP threads used to evaluate the 
+	integrand (default 1)
+
+	If this is greater than one, the points in each call to the
+	integrand are divided into contiguous blocks and each block
+	is passed to the integrand from a separate thread. The
+	integrand must then be safe to call from several threads at
+	once. The points are always created and the results are
+	always combined in the same order, so the integral does not
+	depend on the number of threads. This is most useful when
+	\ref use_parallel is nonzero, since a single region has only
+	a small number of points. The threads are only used if
+	O2scl was compiled with OpenMP support.
+    */
+    size_t n_threads;
     
     inte_hcubature() {
       use_parallel=0;
+      n_threads=1;
     }
 
     /** \brief Desc
@@ -574,6 +574,23 @@ int main(void) {
     tmgr.test_rel(3.067993,dres2[0],1.0e-6,"pc mdim val 0");
     tmgr.test_rel(1.569270,dres2[1],1.0e-6,"pc mdim val 1");
     tmgr.test_rel(1.056968,dres2[2],1.0e-6,"pc mdim val 2");
+
+    // Compare the threaded evaluation of many regions at once
+    // with the serial result
+    vector<double> dres3(3), derr3(3);
+    hc.use_parallel=1;
+    ret=hc.integ(3,cfa2,2,vlow,vhigh,10000,0.0,1.0e-4,en,dres,derr);
+    tmgr.test_gen(ret==0,"hc parallel ret");
+    tmgr.test_rel(3.067993,dres[0],1.0e-6,"hc parallel val 0");
+    hc.n_threads=3;
+    ret=hc.integ(3,cfa2,2,vlow,vhigh,10000,0.0,1.0e-4,en,dres3,derr3);
+    tmgr.test_gen(ret==0,"hc threads ret");
+    tmgr.test_gen(dres[0]==dres3[0] && dres[1]==dres3[1] &&
+		  dres[2]==dres3[2],"hc threads val");
+    tmgr.test_gen(derr[0]==derr3[0] && derr[1]==derr3[1] &&
+		  derr[2]==derr3[2],"hc threads err");
+    hc.use_parallel=0;
+    hc.n_threads=1;
   }
     
   tmgr.report();
@@ -38,12 +38,145 @@ eos_nse::eos_nse() {
   def_mmin.err_nonconv=false;
 }
 
+void eos_nse_nuclides::set(const std::vector<nucleus> &nd) {
+  
+  size_t nnuc=nd.size();
+  Z.resize(nnuc);
+  N.resize(nnuc);
+  be.resize(nnuc);
+  g.resize(nnuc);
+  m.resize(nnuc);
+  gm32.resize(nnuc);
+  n.resize(nnuc);
+  
+  for(size_t i=0;i<nnuc;i++) {
+    Z[i]=nd[i].Z;
+    N[i]=nd[i].N;
+    be[i]=nd[i].be;
+    g[i]=nd[i].g;
+    m[i]=nd[i].m;
+    gm32[i]=nd[i].g*pow(nd[i].m,1.5);
+    n[i]=0.0;
+  }
+  
+  return;
+}
+
+void eos_nse_nuclides::get_densities(std::vector<nucleus> &nd) const {
+  if (nd.size()!=n.size()) {
+    O2SCL_ERR2("Distribution size does not match in ",
+	       "eos_nse_nuclides::get_densities().",exc_einval);
+  }
+  for(size_t i=0;i<n.size();i++) {
+    nd[i].n=n[i];
+  }
+  return;
+}
+
+void eos_nse::packed_kernel(double mun, double mup, double T,
+			    double &nn, double &np, thermo &th,
+			    eos_nse_nuclides &nl, ubmatrix *jac) {
+
+  if (T<0.0) {
+    O2SCL_ERR2("Temperature less than zero in ",
+	       "eos_nse::calc_mu_packed().",exc_einval);
+  }
+  
+  size_t nnuc=nl.size();
+  if (nl.n.size()!=nnuc) nl.n.resize(nnuc);
+
+  // Handle zero temperature, as in classical_thermo::calc_mu(),
+  // and an empty distribution
+  if (T==0.0 || nnuc==0) {
+    for(size_t i=0;i<nnuc;i++) nl.n[i]=0.0;
+    nn=0.0;
+    np=0.0;
+    th.ed=0.0;
+    th.pr=0.0;
+    th.en=0.0;
+    if (jac!=0) {
+      (*jac)(0,0)=0.0;
+      (*jac)(0,1)=0.0;
+      (*jac)(1,0)=0.0;
+      (*jac)(1,1)=0.0;
+    }
+    return;
+  }
+
+  // The factor (T/2/pi)^{3/2} which is common to all nuclei
+  double fac=pow(T/2.0/o2scl_const::pi,1.5);
+  double xmin=std::numeric_limits<double>::min_exponent10;
+
+  const double *Z=&nl.Z[0];
+  const double *N=&nl.N[0];
+  const double *be=&nl.be[0];
+  const double *gm32=&nl.gm32[0];
+  double *n=&nl.n[0];
+  
+  // The sums of the densities, the densities times N and Z, and the
+  // densities times mu/T
+  double sum_n=0.0, sum_nN=0.0, sum_nZ=0.0, sum_nx=0.0;
+  
+  if (jac==0) {
+    
+#ifdef O2SCL_OPENMP
+#pragma omp simd reduction(+:sum_n,sum_nN,sum_nZ,sum_nx)
+#endif
+    for(size_t i=0;i<nnuc;i++) {
+      double x=(mun*N[i]+mup*Z[i]-be[i])/T;
+      double ni=(x<xmin) ? 0.0 : exp(x)*gm32[i]*fac;
+      n[i]=ni;
+      sum_n+=ni;
+      sum_nN+=ni*N[i];
+      sum_nZ+=ni*Z[i];
+      sum_nx+=ni*x;
+    }
+    
+  } else {
+
+    double sum_nNN=0.0, sum_nNZ=0.0, sum_nZZ=0.0;
+    
+#ifdef O2SCL_OPENMP
+#pragma omp simd reduction(+:sum_n,sum_nN,sum_nZ,sum_nx,sum_nNN,sum_nNZ,sum_nZZ)
+#endif
+    for(size_t i=0;i<nnuc;i++) {
+      double x=(mun*N[i]+mup*Z[i]-be[i])/T;
+      double ni=(x<xmin) ? 0.0 : exp(x)*gm32[i]*fac;
+      n[i]=ni;
+      sum_n+=ni;
+      sum_nN+=ni*N[i];
+      sum_nZ+=ni*Z[i];
+      sum_nx+=ni*x;
+      sum_nNN+=ni*N[i]*N[i];
+      sum_nNZ+=ni*N[i]*Z[i];
+      sum_nZZ+=ni*Z[i]*Z[i];
+    }
+
+    // Since dn_i/dmu_i = n_i/T and mu_i = N_i mun + Z_i mup - be_i
+    (*jac)(0,0)=sum_nNN/T;
+    (*jac)(0,1)=sum_nNZ/T;
+    (*jac)(1,0)=sum_nNZ/T;
+    (*jac)(1,1)=sum_nZZ/T;
+  }
+
+  nn=sum_nN;
+  np=sum_nZ;
+  th.ed=1.5*T*sum_n;
+  th.pr=T*sum_n;
+  th.en=2.5*sum_n-sum_nx;
+
+  return;
+}
+
 void eos_nse::calc_mu(double mun, double mup, double T,
 		      double &nn, double &np, thermo &th, 
 		      vector<nucleus> &nd) {
 
   nn=0.0;
   np=0.0;
+  th.ed=0.0;
+  th.pr=0.0;
+  th.en=0.0;
 
   for(size_t i=0;i<nd.size();i++) {
     nd[i].mu=mun*nd[i].N+mup*nd[i].Z-nd[i].be;
@@ -130,13 +263,22 @@ int eos_nse::direct_solve(double nn, double np, double T,
   x[0]=mun/T;
   x[1]=mup/T;
 
+  eos_nse_nuclides nl;
+  nl.set(nd);
+  
   mm_funct mfm=std::bind
     (std::mem_fn<int(size_t,const ubvector &,ubvector &,double,
-		     double,double,vector<nucleus> &)>
+		     double,double,eos_nse_nuclides &)>
      (&eos_nse::solve_fun),this,std::placeholders::_1,std::placeholders::_2,
-     std::placeholders::_3,nn,np,T,std::ref(nd));
+     std::placeholders::_3,nn,np,T,std::ref(nl));
+  jac_funct jfm=std::bind
+    (std::mem_fn<int(size_t,ubvector &,size_t,ubvector &,ubmatrix &,
+		     double,double,double,eos_nse_nuclides &)>
+     (&eos_nse::solve_jac),this,std::placeholders::_1,std::placeholders::_2,
+     std::placeholders::_3,std::placeholders::_4,std::placeholders::_5,
+     nn,np,T,std::ref(nl));
   
-  int ret=mroot_ptr->msolve(2,x,mfm);
+  int ret=mroot_ptr->msolve_de(2,x,mfm,jfm);
 
   mun=x[0]*T;
   mup=x[1]*T;
@@ -149,7 +291,7 @@ int eos_nse::direct_solve(double nn, double np, double T,
 
 int eos_nse::solve_fun(size_t nv, const ubvector &x, ubvector &y, 
 		       double nn, double np, double T,
-		       vector<nucleus> &nd) {
+		       eos_nse_nuclides &nl) {
 
   double mun=x[0]*T;
   double mup=x[1]*T;
@@ -157,7 +299,7 @@ int eos_nse::solve_fun(size_t nv, const ubvector &x, ubvector &y,
   double nn2, np2;
   thermo th;
   
-  calc_mu(mun,mup,T,nn2,np2,th,nd);
+  calc_mu_packed(mun,mup,T,nn2,np2,th,nl);
 
   y[0]=(nn2-nn)/nn;
   y[1]=(np2-np)/np;
@@ -169,15 +311,46 @@ int eos_nse::solve_fun(size_t nv, const ubvector &x, ubvector &y,
   return success;
 }
 
+int eos_nse::solve_jac(size_t nv, ubvector &x, size_t ny, ubvector &y,
+		       ubmatrix &j, double nn, double np, double T,
+		       eos_nse_nuclides &nl) {
+
+  double mun=x[0]*T;
+  double mup=x[1]*T;
+
+  double nn2, np2;
+  thermo th;
+  ubmatrix dndmu(2,2);
+  
+  calc_mu_packed(mun,mup,T,nn2,np2,th,nl,dndmu);
+  
+  if (nn2<=0.0 || np2<=0.0 || std::isinf(nn2) || std::isinf(np2)) {
+    return exc_ebadfunc;
+  }
+
+  // The variables are the chemical potentials divided by the
+  // temperature and the functions are scaled by the densities
+  j(0,0)=dndmu(0,0)*T/nn;
+  j(0,1)=dndmu(0,1)*T/nn;
+  j(1,0)=dndmu(1,0)*T/np;
+  j(1,1)=dndmu(1,1)*T/np;
+
+  return success;
+}
+
 int eos_nse::make_guess(double &mun, double &mup, double T,
 			o2scl::thermo &th, std::vector<o2scl::nucleus> &nd,
 			double nn_min, double nn_max,
 			double np_min, double np_max, bool err_on_fail) {
   
   double nn, np;
+
+  // Use a packed copy of the distribution for the iterations
+  eos_nse_nuclides nl;
+  nl.set(nd);
     
   // Initial result
-  calc_mu(mun,mup,T,nn,np,th,nd);
+  calc_mu_packed(mun,mup,T,nn,np,th,nl);
   if (verbose>1) {
     cout << "In make_guess()." << endl;
     cout << mun << " " << mup << " " << nn << " " << np << endl;
@@ -186,6 +359,7 @@ int eos_nse::make_guess(double &mun, double &mup, double T,
   // If we're already done, return
   if (std::isfinite(nn) && std::isfinite(np) &&
       nn>nn_min && np>np_min && nn<nn_max && np<np_max) {
+    calc_mu(mun,mup,T,nn,np,th,nd);
     return o2scl::success;
   }
 
@@ -222,7 +396,7 @@ int eos_nse::make_guess(double &mun, double &mup, double T,
     } else {
       mup2=mup;
     }
-    calc_mu(mun2,mup2,T,nn2,np2,th,nd);
+    calc_mu_packed(mun2,mup2,T,nn2,np2,th,nl);
       
     if (verbose>1) {
       cout << "k=" << k << endl;
@@ -362,7 +536,7 @@ int eos_nse::make_guess(double &mun, double &mup, double T,
     if (accept) {
       mun=mun2;
       mup=mup2;
-      calc_mu(mun,mup,T,nn,np,th,nd);
+      calc_mu_packed(mun,mup,T,nn,np,th,nl);
       if (verbose>1) {
 	cout << "Accept." << endl;
       }
@@ -384,6 +558,9 @@ int eos_nse::make_guess(double &mun, double &mup, double T,
     k++;
   }
 
+  // Update the distribution with the final chemical potentials
+  calc_mu(mun,mup,T,nn,np,th,nd);
+
   if (done==false) {
     if (err_on_fail) {
       O2SCL_ERR("Failed in eos_nse::make_guess().",exc_efailed);
@@ -399,12 +576,14 @@ int eos_nse::density_min(double nn, double np, double T,
 			 double &mun, double &mup, o2scl::thermo &th, 
 			 std::vector<o2scl::nucleus> &nd) {
 
+  eos_nse_nuclides nl;
+  nl.set(nd);
+  
   o2scl::multi_funct mf=std::bind
     (std::mem_fn<double(size_t,const ubvector &, double, double,
-			double, o2scl::thermo &,
-			std::vector<o2scl::nucleus> &)>
+			double, eos_nse_nuclides &)>
      (&eos_nse::minimize_fun),this,std::placeholders::_1,
-     std::placeholders::_2,T,nn,np,std::ref(th),std::ref(nd));
+     std::placeholders::_2,T,nn,np,std::ref(nl));
   
   ubvector x(2);
   x[0]=mun;
@@ -423,15 +602,19 @@ int eos_nse::density_min(double nn, double np, double T,
 
   mun=x[0];
   mup=x[1];
+
+  // Update the distribution with the final chemical potentials
+  double nn2, np2;
+  calc_mu(mun,mup,T,nn2,np2,th,nd);
   
   return ret;
 }
   
 double eos_nse::minimize_fun(size_t nv, const ubvector &x, double T,
-			     double nn, double np, o2scl::thermo &th,
-			     std::vector<o2scl::nucleus> &nd) {
+			     double nn, double np, eos_nse_nuclides &nl) {
   double mun=x[0], mup=x[1], nn2, np2;
-  calc_mu(mun,mup,T,nn2,np2,th,nd);
+  thermo th;
+  calc_mu_packed(mun,mup,T,nn2,np2,th,nl);
   if (std::isinf(nn2) || std::isinf(np2) || nn2>10.0 || np2>10.0) {
     return 1.0e100;
   }
@@ -37,6 +37,54 @@
 namespace o2scl {
 #endif
 
+  /** \brief Packed nuclear distribution for \ref eos_nse
+
+      This class stores the proton number, neutron number, binding
+      energy, spin degeneracy, and mass of each nucleus in a
+      distribution in separate contiguous arrays, so that \ref
+      eos_nse::calc_mu_packed() can compute the Maxwell-Boltzmann
+      densities of all nuclei in a single vectorizable loop. It is
+      filled from a <tt>std::vector<nucleus></tt> with \ref set().
+  */
+  class eos_nse_nuclides {
+    
+  public:
+
+    /// Proton numbers
+    std::vector<double> Z;
+    /// Neutron numbers
+    std::vector<double> N;
+    /// Binding energies in \f$ \mathrm{fm}^{-1} \f$
+    std::vector<double> be;
+    /// Spin degeneracies
+    std::vector<double> g;
+    /// Masses in \f$ \mathrm{fm}^{-1} \f$
+    std::vector<double> m;
+    /** \brief The value of \f$ g m^{3/2} \f$ for each nucleus
+     */
+    std::vector<double> gm32;
+    /** \brief Number densities from the most recent call to 
+	\ref eos_nse::calc_mu_packed()
+    */
+    std::vector<double> n;
+
+    /// Return the number of nuclei
+    size_t size() const {
+      return Z.size();
+    }
+    
+    /// Fill the arrays from the distribution \c nd
+    void set(const std::vector<nucleus> &nd);
+
+    /** \brief Copy the densities to the distribution \c nd
+	
+	The distribution \c nd must be the same one which was
+	given to \ref set().
+     */
+    void get_densities(std::vector<nucleus> &nd) const;
+    
+  };
+
   /** \brief Equation of state for nuclei in statistical equilibrium
 
       This class computes the composition of matter in nuclear
@@ -82,12 +130,21 @@ namespace o2scl {
       no nuclei in the distribution which equal, or surround the
       requested value of \f$ Y_e=n_p/(n_n+n_p) \f$ determined from \c nn and 
       \c np .
+
+      The iterations in \ref make_guess(), \ref direct_solve(), and
+      \ref density_min() use a packed copy of the distribution (see
+      \ref eos_nse_nuclides and \ref calc_mu_packed()) and only
+      update the individual nuclei in \c nd after the iterations
+      are finished. The solver in \ref direct_solve() is given the
+      analytic Jacobian of the densities with respect to the 
+      chemical potentials.
   */
   class eos_nse {
 
   public:
 
     typedef boost::numeric::ublas::vector<double> ubvector;
+    typedef boost::numeric::ublas::matrix<double> ubmatrix;
     
 #ifndef DOXYGEN_INTERNAL
     
@@ -96,12 +153,25 @@ namespace o2scl {
     /// Function to solve to match neutron and proton densities
     int solve_fun(size_t nv, const ubvector &x, ubvector &y, 
 		  double nn, double np, double T,
-		  std::vector<o2scl::nucleus> &nd);
+		  eos_nse_nuclides &nl);
+
+    /// Jacobian of \ref solve_fun()
+    int solve_jac(size_t nv, ubvector &x, size_t ny, ubvector &y,
+		  ubmatrix &j, double nn, double np, double T,
+		  eos_nse_nuclides &nl);
 
     /// Function to minimize to match neutron and proton densities
     double minimize_fun(size_t nv, const ubvector &x, double T,
-			double nn, double np, o2scl::thermo &th,
-			std::vector<o2scl::nucleus> &nd);
+			double nn, double np, eos_nse_nuclides &nl);
+
+    /** \brief The Maxwell-Boltzmann kernel for \ref calc_mu_packed()
+
+	If \c jac is not null, it is set to the derivatives of \c nn
+	and \c np with respect to \c mun and \c mup.
+    */
+    void packed_kernel(double mun, double mup, double T,
+		       double &nn, double &np, thermo &th,
+		       eos_nse_nuclides &nl, ubmatrix *jac);
     
     /// Solver
     mroot<> *mroot_ptr;
@@ -135,13 +205,47 @@ namespace o2scl {
 	(the individual densities are stored in the distribution \c
 	nd), the neutron number density \c nn, and the proton number
 	density \c np. Note that the densities can be infinite if
-	the chemical potentials are sufficiently large.
+	the chemical potentials are sufficiently large. The energy
+	density, pressure, and entropy of the nuclei are stored 
+	in \c th.
 
 	This function does not use the solver or the minimizer.
     */
     void calc_mu(double mun, double mup, double T, double &nn, 
 		 double &np, thermo &th, std::vector<nucleus> &nd);
 
+    /** \brief Calculate the equation of state as a function of the
+	chemical potentials using a packed distribution
+
+	This computes the same quantities as \ref calc_mu(), but
+	stores the individual densities in <tt>nl.n</tt> instead of in
+	a vector of \ref nucleus objects.
+    */
+    void calc_mu_packed(double mun, double mup, double T, double &nn,
+			double &np, thermo &th, eos_nse_nuclides &nl) {
+      packed_kernel(mun,mup,T,nn,np,th,nl,0);
+      return;
+    }
+
+    /** \brief Calculate the equation of state and the derivatives
+	of the densities as a function of the chemical potentials
+	using a packed distribution
+
+	This is the same as the other version of \ref
+	calc_mu_packed(), but also computes the Jacobian \c jac,
+	which must be a \f$ 2 \times 2 \f$ matrix. The first row
+	holds \f$ \partial n_n / \partial \mu_n \f$ and \f$ \partial
+	n_n / \partial \mu_p \f$, and the second row holds \f$
+	\partial n_p / \partial \mu_n \f$ and \f$ \partial n_p /
+	\partial \mu_p \f$.
+    */
+    void calc_mu_packed(double mun, double mup, double T, double &nn,
+			double &np, thermo &th, eos_nse_nuclides &nl,
+			ubmatrix &jac) {
+      packed_kernel(mun,mup,T,nn,np,th,nl,&jac);
+      return;
+    }
+
   /** \brief Calculate the equation of state as a function of the densities
 
 	Given the neutron number density \c nn in \f$ \mathrm{fm}^{-3}
@@ -1180,31 +1180,26 @@ int eos_nse_full::calc_density_fixnp(dense_matter &dm, bool from_densities) {
   dm.eta_n=dm.n.mu;
   dm.eta_p=dm.p.mu+dm.e.mu;
 
-  for(size_t i=0;i<dm.dist.size();i++) {
+  // The sum over all nuclei of the derivative of the free energy
+  // density with respect to the negative charge density. This is
+  // the same for each nucleus, so it is computed only once.
+  double sum_dfdnneg=0.0;
+  for(size_t j=0;j<dm.dist.size();j++) {
+    double dmudm=-1.5*dm.T/dm.dist[j].m;
+    double dfdm=dm.dist[j].n*dmudm;
+    sum_dfdnneg+=(dm.dist[j].n+dfdm)*vec_dEdnneg[j]/hc_mev_fm;
+  }
+  
+  // In eta_p, we don't include dEdnp terms which are zero
+  dm.eta_p+=sum_dfdnneg;
 
-    double dmudm_i=-1.5*dm.T/dm.dist[i].m;
-    double dfdm_i=dm.dist[i].n*dmudm_i;
+  for(size_t i=0;i<dm.dist.size();i++) {
     if (dm.dist[i].n>0.0) {
-      dm.eta_nuc[i]=dm.dist[i].be+dm.dist[i].mu+dm.dist[i].Z*dm.e.mu;
+      dm.eta_nuc[i]=dm.dist[i].be+dm.dist[i].mu+dm.dist[i].Z*dm.e.mu+
+	dm.dist[i].Z*sum_dfdnneg;
     } else {
       dm.eta_nuc[i]=0.0;
     }
-    // In eta_p, we don't include dEdnp terms which are zero
-    dm.eta_p+=(dm.dist[i].n+dfdm_i)*(vec_dEdnneg[i])/hc_mev_fm;
-    
-    for(size_t j=0;j<dm.dist.size();j++) {
-      
-      if (dm.dist[i].n>0.0) {
-	
-	double dmudm=-1.5*dm.T/dm.dist[j].m;
-	double dfdm=dm.dist[j].n*dmudm;
-	
-	dm.eta_nuc[i]+=dm.dist[i].Z*(dm.dist[j].n+dfdm)*
-	  vec_dEdnneg[j]/hc_mev_fm;
-
-      }
-
-    }
   }
       
   // -----------------------------------------------------------
@@ -1458,24 +1453,26 @@ int eos_nse_full::calc_density_noneq(dense_matter &dm) {
   dm.eta_n=dm.n.mu;
   dm.eta_p=dm.p.mu+dm.e.mu;
 
+  // The sum over all nuclei of the derivative of the free energy
+  // density with respect to the negative charge density, computed
+  // once since it is the same for each nucleus
+  double sum_dfdnneg=0.0;
+  for(size_t j=0;j<dm.dist.size();j++) {
+    double dmudm=-1.5*dm.T/dm.dist[j].m;
+    double dfdm=dm.dist[j].n*dmudm;
+    sum_dfdnneg+=(dm.dist[j].n+dfdm)*vec_dEdnneg[j]/hc_mev_fm;
+  }
+
   for(size_t i=0;i<dm.dist.size();i++) {
 
     if (dm.dist[i].n>0.0) {
       
       double dmudm_i=-1.5*dm.T/dm.dist[i].m;
       double dfdm_i=dm.dist[i].n*dmudm_i;
-      dm.eta_nuc[i]=dm.dist[i].be+dm.dist[i].mu+dm.dist[i].Z*dm.e.mu;
+      dm.eta_nuc[i]=dm.dist[i].be+dm.dist[i].mu+dm.dist[i].Z*dm.e.mu+
+	dm.dist[i].Z*sum_dfdnneg;
       dm.eta_p+=(dm.dist[i].n+dfdm_i)*(vec_dEdnp[i]+vec_dEdnneg[i])/hc_mev_fm;
       
-      for(size_t j=0;j<dm.dist.size();j++) {
-	
-	double dmudm=-1.5*dm.T/dm.dist[j].m;
-	double dfdm=dm.dist[j].n*dmudm;
-	
-	dm.eta_nuc[i]+=dm.dist[i].Z*(dm.dist[j].n+dfdm)*
-	  vec_dEdnneg[j]/hc_mev_fm;
-      }
-
     } else {
       dm.eta_nuc[i]=0.0;
     }
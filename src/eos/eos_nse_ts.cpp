@@ -29,6 +29,8 @@ using namespace std;
 using namespace o2scl;
 using namespace o2scl_const;
 
+typedef boost::numeric::ublas::matrix<double> ubmatrix;
+
 int main(void) {
 
   cout.setf(ios::scientific);
@@ -143,6 +145,45 @@ int main(void) {
   t.test_rel(nBnew,0.03,1.0e-6,"nB match.");
   t.test_rel(Yenew,0.36,1.0e-6,"Ye match.");
 
+  // ---------------------------------------------------------
+  // Compare calc_mu_packed() with calc_mu() and test the
+  // Jacobian with finite differences
+
+  {
+    eos_nse_nuclides nl;
+    nl.set(ad);
+
+    double nn1, np1, nn2, np2;
+    thermo th1, th2;
+    en.calc_mu(mun,mup,T,nn1,np1,th1,ad);
+    en.calc_mu_packed(mun,mup,T,nn2,np2,th2,nl);
+    t.test_rel(nn2,nn1,1.0e-12,"packed nn");
+    t.test_rel(np2,np1,1.0e-12,"packed np");
+    t.test_rel(th2.ed,th1.ed,1.0e-12,"packed ed");
+    t.test_rel(th2.pr,th1.pr,1.0e-12,"packed pr");
+    t.test_rel(th2.en,th1.en,1.0e-10,"packed en");
+    double max_diff=0.0;
+    for(size_t i=0;i<ad.size();i++) {
+      if (ad[i].n>0.0) {
+	double diff=fabs(nl.n[i]-ad[i].n)/ad[i].n;
+	if (diff>max_diff) max_diff=diff;
+      }
+    }
+    t.test_abs(max_diff,0.0,1.0e-12,"packed densities");
+
+    ubmatrix jac(2,2);
+    en.calc_mu_packed(mun,mup,T,nn2,np2,th2,nl,jac);
+    double h=1.0e-6*T, nn3, np3, nn4, np4;
+    en.calc_mu_packed(mun+h,mup,T,nn3,np3,th2,nl);
+    en.calc_mu_packed(mun-h,mup,T,nn4,np4,th2,nl);
+    t.test_rel(jac(0,0),(nn3-nn4)/2.0/h,1.0e-6,"jac nn mun");
+    t.test_rel(jac(1,0),(np3-np4)/2.0/h,1.0e-6,"jac np mun");
+    en.calc_mu_packed(mun,mup+h,T,nn3,np3,th2,nl);
+    en.calc_mu_packed(mun,mup-h,T,nn4,np4,th2,nl);
+    t.test_rel(jac(0,1),(nn3-nn4)/2.0/h,1.0e-6,"jac nn mup");
+    t.test_rel(jac(1,1),(np3-np4)/2.0/h,1.0e-6,"jac np mup");
+  }
+
   // ---------------------------------------------------------
   // Test with a more complete distribution at large and
   // small Ye
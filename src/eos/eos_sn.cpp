@@ -20,6 +20,14 @@
 
   -------------------------------------------------------------------
 */
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <o2scl/eos_sn.h>
 #include <o2scl/test_mgr.h>
 #include <o2scl/hdf_file.h>
@@ -67,6 +75,12 @@ eos_sn_base::eos_sn_base() : cu(o2scl_settings.get_convert_units()) {
   with_leptons_loaded=false;
   baryons_only_loaded=false;
 
+  for(size_t i=0;i<3;i++) fused_cache[i]=0;
+  fused_ptr=0;
+  map_addr=0;
+  map_size=0;
+  binary_verify=false;
+
   m_neut=o2scl_mks::mass_neutron*
     o2scl_settings.get_convert_units().convert("kg","1/fm",1.0)*
     o2scl_const::hc_mev_fm;
@@ -77,6 +91,7 @@ eos_sn_base::eos_sn_base() : cu(o2scl_settings.get_convert_units()) {
 
 eos_sn_base::~eos_sn_base() {
   if (loaded) free();
+  fused_free();
 }
 
 void eos_sn_base::output(std::string fname) {
@@ -278,6 +293,7 @@ void eos_sn_base::free() {
   loaded=false;
   oth_names.clear();
   oth_units.clear();
+  fused_free();
   return;
 }
 
@@ -292,6 +308,538 @@ void eos_sn_base::set_interp_type(size_t interp_type) {
   return;
 }
 
+void eos_sn_base::fused_init(const std::vector<size_t> &list) {
+
+  if (!loaded) {
+    O2SCL_ERR("File not loaded in eos_sn_base::fused_init().",
+	      exc_einval);
+  }
+  if (list.size()==0) {
+    O2SCL_ERR("No quantities specified in eos_sn_base::fused_init().",
+	      exc_einval);
+  }
+  size_t ntot=n_nB*n_Ye*n_T;
+  for(size_t k=0;k<list.size();k++) {
+    if (list[k]>=n_base+n_oth || arr[list[k]]->total_size()!=ntot) {
+      O2SCL_ERR2("Invalid or empty data set specified in ",
+		 "eos_sn_base::fused_init().",exc_einval);
+    }
+  }
+
+  // Remove any previous interleaved data or memory map
+  std::vector<size_t> list_copy=list;
+  fused_free();
+  
+  // Use the grid from the tensor objects so that the results
+  // are identical to those from tensor_grid3::interp_linear()
+  for(size_t i=0;i<3;i++) {
+    arr[list_copy[0]]->copy_grid(i,fused_grid[i]);
+    if (fused_grid[i].size()<2) {
+      O2SCL_ERR2("Grid too small in ",
+		 "eos_sn_base::fused_init().",exc_einval);
+    }
+  }
+  
+  fused_list=list_copy;
+  size_t nq=list_copy.size();
+  fused_data.resize(ntot*nq);
+  for(size_t k=0;k<nq;k++) {
+    const std::vector<double> &d=arr[list_copy[k]]->get_data();
+    for(size_t j=0;j<ntot;j++) {
+      fused_data[j*nq+k]=d[j];
+    }
+  }
+  fused_ptr=&fused_data[0];
+  for(size_t i=0;i<3;i++) fused_cache[i]=0;
+  
+  return;
+}
+
+void eos_sn_base::fused_init() {
+  std::vector<size_t> list;
+  size_t ntot=n_nB*n_Ye*n_T;
+  for(size_t i=0;i<n_base+n_oth;i++) {
+    if (arr[i]->total_size()==ntot) list.push_back(i);
+  }
+  fused_init(list);
+  return;
+}
+
+void eos_sn_base::fused_free() {
+  // If the memory mapped file is in use, fused_data is empty
+  fused_list.clear();
+  fused_data.clear();
+  fused_ptr=0;
+  for(size_t i=0;i<3;i++) fused_grid[i].clear();
+  if (map_addr!=0) {
+    munmap(map_addr,map_size);
+    map_addr=0;
+    map_size=0;
+  }
+  return;
+}
+
+void eos_sn_base::interp_fused(double nB, double Ye, double T,
+			       fused_result &res) {
+  interp_fused(nB,Ye,T,res,fused_cache);
+  return;
+}
+
+void eos_sn_base::interp_fused(double nB, double Ye, double T,
+			       fused_result &res, size_t cache[3]) const {
+
+  if (fused_list.size()==0) {
+    O2SCL_ERR2("Function fused_init() not called before ",
+	       "eos_sn_base::interp_fused().",exc_einval);
+  }
+
+  // Locate the cell, once for all quantities
+  double x[3]={nB,Ye,T};
+  double frac[3], glo[3], ghi[3];
+  size_t loc[3];
+  for(size_t i=0;i<3;i++) {
+    size_t n=fused_grid[i].size();
+    if (cache[i]>n-2) cache[i]=n/2-1;
+    search_vec<std::vector<double> > sv(n,fused_grid[i]);
+    loc[i]=sv.find_const(x[i],cache[i]);
+    glo[i]=fused_grid[i][loc[i]];
+    ghi[i]=fused_grid[i][loc[i]+1];
+    frac[i]=(x[i]-glo[i])/(ghi[i]-glo[i]);
+  }
+
+  // Pointers to the eight corners, with the last index varying
+  // fastest as in tensor_grid
+  size_t nq=fused_list.size();
+  size_t s2=fused_grid[2].size();
+  size_t s12=fused_grid[1].size()*s2;
+  const double *c[8];
+  for(size_t k=0;k<8;k++) {
+    size_t ix=(loc[0]+((k>>2)&1))*s12+(loc[1]+((k>>1)&1))*s2+
+      loc[2]+(k&1);
+    c[k]=fused_ptr+ix*nq;
+  }
+
+  for(size_t i=0;i<n_base+30;i++) res.vals[i]=0.0;
+
+  // Perform the interpolation in the same order as
+  // tensor_grid::interp_linear()
+  for(size_t q=0;q<nq;q++) {
+    double v00=c[0][q]+frac[2]*(c[1][q]-c[0][q]);
+    double v01=c[2][q]+frac[2]*(c[3][q]-c[2][q]);
+    double v10=c[4][q]+frac[2]*(c[5][q]-c[4][q]);
+    double v11=c[6][q]+frac[2]*(c[7][q]-c[6][q]);
+    double v0=v00+frac[1]*(v01-v00);
+    double v1=v10+frac[1]*(v11-v10);
+    res.vals[fused_list[q]]=v0+(v1-v0)/(ghi[0]-glo[0])*(nB-glo[0]);
+  }
+  
+  return;
+}
+
+/** \brief Header for the binary cache files used by 
+    \ref eos_sn_base::binary_output() and 
+    \ref eos_sn_base::binary_load()
+*/
+typedef struct eos_sn_binary_header_s {
+  /// Magic string, "O2SNEOS" 
+  char magic[8];
+  /// File format version
+  uint64_t version;
+  /// Size of this header in bytes
+  uint64_t header_size;
+  /// The total size of the file
+  uint64_t file_size;
+  /// The checksum of the file after the header
+  uint64_t checksum;
+  /// Grid sizes
+  uint64_t n_nB, n_Ye, n_T;
+  /// Number of additional data sets
+  uint64_t n_oth;
+  /// Number of interleaved data sets
+  uint64_t n_q;
+  /// Offset of the interleaved data (a multiple of 64)
+  uint64_t data_offset;
+  /// Flags (baryons only, with leptons, include muons)
+  uint64_t flags;
+  /// The mode passed to load()
+  uint64_t mode;
+  /// The size of the source file
+  uint64_t src_size;
+  /// The modification time of the source file
+  int64_t src_mtime;
+  /// Nucleon masses
+  double m_neut, m_prot;
+} eos_sn_binary_header;
+
+/// Current version of the binary cache format
+static const uint64_t eos_sn_binary_version=1;
+
+/// Initial value for \ref eos_sn_checksum()
+static const uint64_t eos_sn_checksum_init=14695981039346656037ULL;
+
+/** \brief Update a simple 64-bit checksum \c h with \c n bytes of
+    \c data
+
+    The checksum can be computed incrementally provided that all
+    but the last block have sizes which are a multiple of 8 bytes.
+*/
+static uint64_t eos_sn_checksum(const char *data, size_t n,
+				uint64_t h=eos_sn_checksum_init) {
+  // FNV-1a applied to 64-bit words and then to the remaining bytes
+  const uint64_t prime=1099511628211ULL;
+  size_t nw=n/8;
+  for(size_t i=0;i<nw;i++) {
+    uint64_t w;
+    std::memcpy(&w,data+i*8,8);
+    h=(h^w)*prime;
+  }
+  for(size_t i=nw*8;i<n;i++) {
+    h=(h^((unsigned char)data[i]))*prime;
+  }
+  return h;
+}
+
+void eos_sn_base::binary_output(std::string fname, std::string src_fname,
+				size_t mode) {
+
+  if (loaded==false) {
+    O2SCL_ERR("Not loaded in eos_sn_base::binary_output().",
+	      exc_efailed);
+  }
+  
+  wordexp_single_file(fname);
+  
+  if (verbose>0) {
+    cout << "eos_sn_base::binary_output(): Output to file named '"
+	 << fname << "'." << endl;
+  }
+
+  // Output all of the data sets which are present. This does not
+  // use or modify the object's interleaved data from fused_init().
+  size_t ntot=n_nB*n_Ye*n_T;
+  std::vector<size_t> list;
+  for(size_t i=0;i<n_base+n_oth;i++) {
+    if (arr[i]->total_size()==ntot) list.push_back(i);
+  }
+  size_t nq=list.size();
+  if (nq==0) {
+    O2SCL_ERR("No data sets in eos_sn_base::binary_output().",
+	      exc_efailed);
+  }
+  std::vector<double> grid[3];
+  for(size_t i=0;i<3;i++) {
+    arr[list[0]]->copy_grid(i,grid[i]);
+  }
+
+  eos_sn_binary_header hdr;
+  std::memset(&hdr,0,sizeof(hdr));
+  std::memcpy(hdr.magic,"O2SNEOS",8);
+  hdr.version=eos_sn_binary_version;
+  hdr.header_size=sizeof(hdr);
+  hdr.n_nB=n_nB;
+  hdr.n_Ye=n_Ye;
+  hdr.n_T=n_T;
+  hdr.n_oth=n_oth;
+  hdr.n_q=nq;
+  hdr.flags=(baryons_only_loaded ? 1 : 0)+(with_leptons_loaded ? 2 : 0)+
+    (include_muons ? 4 : 0);
+  hdr.mode=mode;
+  hdr.m_neut=m_neut;
+  hdr.m_prot=m_prot;
+  if (src_fname.length()>0) {
+    wordexp_single_file(src_fname);
+    struct stat st;
+    if (stat(src_fname.c_str(),&st)==0) {
+      hdr.src_size=st.st_size;
+      hdr.src_mtime=st.st_mtime;
+    }
+  }
+
+  // Construct the section between the header and the data
+  std::string meta;
+  meta.append((const char *)&list[0],nq*sizeof(size_t));
+  for(size_t i=0;i<3;i++) {
+    meta.append((const char *)&(grid[i][0]),grid[i].size()*sizeof(double));
+  }
+  for(size_t i=0;i<n_oth;i++) {
+    for(size_t k=0;k<2;k++) {
+      const std::string &str=(k==0 ? oth_names[i] : oth_units[i]);
+      uint64_t len=str.length();
+      meta.append((const char *)&len,sizeof(uint64_t));
+      meta.append(str);
+    }
+  }
+  size_t off=sizeof(hdr)+meta.length();
+  size_t pad=(64-off%64)%64;
+  meta.append(pad,'\0');
+  hdr.data_offset=off+pad;
+  hdr.file_size=hdr.data_offset+ntot*nq*sizeof(double);
+
+  // Write the header (with the checksum filled in at the end),
+  // then the metadata, then the data, interleaving it in blocks
+  // so that only one block is held in memory at a time. The file
+  // is written to a temporary and then renamed, so that other
+  // processes never see a partially written file.
+  std::string tmp_fname=fname+".tmp."+o2scl::itos(getpid());
+  FILE *fp=fopen(tmp_fname.c_str(),"wb");
+  if (fp==0) {
+    O2SCL_ERR2("Failed to open file in ",
+	       "eos_sn_base::binary_output().",exc_efilenotfound);
+  }
+  bool ok=true;
+  ok=ok && fwrite(&hdr,sizeof(hdr),1,fp)==1;
+  ok=ok && fwrite(meta.c_str(),1,meta.length(),fp)==meta.length();
+  uint64_t h=eos_sn_checksum(meta.c_str(),meta.length());
+
+  const size_t block=65536;
+  std::vector<double> buf(block*nq);
+  for(size_t j0=0;j0<ntot;j0+=block) {
+    size_t nj=std::min(block,ntot-j0);
+    for(size_t k=0;k<nq;k++) {
+      const std::vector<double> &d=arr[list[k]]->get_data();
+      for(size_t j=0;j<nj;j++) {
+	buf[j*nq+k]=d[j0+j];
+      }
+    }
+    size_t nbytes=nj*nq*sizeof(double);
+    h=eos_sn_checksum((const char *)&buf[0],nbytes,h);
+    ok=ok && fwrite(&buf[0],1,nbytes,fp)==nbytes;
+  }
+  
+  hdr.checksum=h;
+  ok=ok && fseek(fp,0,SEEK_SET)==0;
+  ok=ok && fwrite(&hdr,sizeof(hdr),1,fp)==1;
+  ok=ok && fflush(fp)==0;
+  ok=ok && fsync(fileno(fp))==0;
+  ok=(fclose(fp)==0) && ok;
+  if (!ok || rename(tmp_fname.c_str(),fname.c_str())!=0) {
+    std::remove(tmp_fname.c_str());
+    O2SCL_ERR2("Failed to write file in ",
+	       "eos_sn_base::binary_output().",exc_efilenotfound);
+  }
+
+  if (verbose>0) {
+    cout << "eos_sn_base::binary_output(): Done with output." << endl;
+  }
+  
+  return;
+}
+
+bool eos_sn_base::binary_check(std::string fname, std::string src_fname,
+			       size_t mode) {
+
+  wordexp_single_file(fname);
+  wordexp_single_file(src_fname);
+  
+  eos_sn_binary_header hdr;
+  std::ifstream fin(fname.c_str(),std::ios::binary);
+  if (!fin) return false;
+  fin.read((char *)&hdr,sizeof(hdr));
+  if (!fin) return false;
+  fin.close();
+
+  if (std::memcmp(hdr.magic,"O2SNEOS",8)!=0 ||
+      hdr.version!=eos_sn_binary_version ||
+      hdr.header_size!=sizeof(hdr) || hdr.mode!=mode) {
+    return false;
+  }
+
+  struct stat st;
+  if (stat(fname.c_str(),&st)!=0 ||
+      ((uint64_t)st.st_size)!=hdr.file_size) {
+    return false;
+  }
+  if (stat(src_fname.c_str(),&st)!=0 ||
+      ((uint64_t)st.st_size)!=hdr.src_size ||
+      ((int64_t)st.st_mtime)!=hdr.src_mtime) {
+    return false;
+  }
+  
+  return true;
+}
+
+void eos_sn_base::binary_load(std::string fname, bool fill_tensors) {
+
+  wordexp_single_file(fname);
+  
+  if (verbose>0) {
+    cout << "In eos_sn_base::binary_load(), loading EOS from file\n\t'"
+	 << fname << "'." << endl;
+  }
+
+  if (loaded) free();
+  fused_free();
+
+  int fd=open(fname.c_str(),O_RDONLY);
+  if (fd<0) {
+    O2SCL_ERR2("Could not open file in ",
+	       "eos_sn_base::binary_load().",exc_efilenotfound);
+  }
+  struct stat st;
+  if (fstat(fd,&st)!=0 || ((size_t)st.st_size)<sizeof(eos_sn_binary_header)) {
+    close(fd);
+    O2SCL_ERR2("File too small in ",
+	       "eos_sn_base::binary_load().",exc_efailed);
+  }
+  size_t fsize=st.st_size;
+  void *addr=mmap(0,fsize,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  if (addr==MAP_FAILED) {
+    O2SCL_ERR2("Function mmap() failed in ",
+	       "eos_sn_base::binary_load().",exc_efailed);
+  }
+  
+  const char *base=(const char *)addr;
+  eos_sn_binary_header hdr;
+  std::memcpy(&hdr,base,sizeof(hdr));
+  
+  if (std::memcmp(hdr.magic,"O2SNEOS",8)!=0 ||
+      hdr.header_size!=sizeof(hdr)) {
+    munmap(addr,fsize);
+    O2SCL_ERR2("Not a valid binary EOS file in ",
+	       "eos_sn_base::binary_load().",exc_efailed);
+  }
+  if (hdr.version!=eos_sn_binary_version) {
+    munmap(addr,fsize);
+    O2SCL_ERR2("Binary EOS file version mismatch in ",
+	       "eos_sn_base::binary_load().",exc_efailed);
+  }
+  size_t ntot=hdr.n_nB*hdr.n_Ye*hdr.n_T;
+  if (hdr.file_size!=fsize || hdr.data_offset%64!=0 ||
+      hdr.data_offset+ntot*hdr.n_q*sizeof(double)!=fsize) {
+    munmap(addr,fsize);
+    O2SCL_ERR2("Binary EOS file is truncated or corrupt in ",
+	       "eos_sn_base::binary_load().",exc_efailed);
+  }
+  if (binary_verify) {
+    uint64_t cs=eos_sn_checksum(base+sizeof(hdr),fsize-sizeof(hdr));
+    if (cs!=hdr.checksum) {
+      munmap(addr,fsize);
+      O2SCL_ERR2("Checksum failed in ",
+		 "eos_sn_base::binary_load().",exc_efailed);
+    }
+  }
+
+  // Read the data set indices, the grid, and the names and
+  // units, checking that they lie between the header and the data
+  const char *ptr=base+sizeof(hdr);
+  const char *end=base+hdr.data_offset;
+  size_t nq=hdr.n_q;
+  size_t sz[3]={hdr.n_nB,hdr.n_Ye,hdr.n_T};
+  bool meta_ok=(hdr.data_offset>=sizeof(hdr) && hdr.n_oth<=30 &&
+		nq>0 && nq<=n_base+hdr.n_oth && sz[0]>=2 && sz[1]>=2 &&
+		sz[2]>=2 && nq*sizeof(size_t)+
+		(sz[0]+sz[1]+sz[2])*sizeof(double)<=((size_t)(end-ptr)));
+  std::vector<size_t> list;
+  std::vector<double> grid_meta[3];
+  std::vector<std::string> names, units;
+  if (meta_ok) {
+    list.resize(nq);
+    std::memcpy(&list[0],ptr,nq*sizeof(size_t));
+    ptr+=nq*sizeof(size_t);
+    for(size_t k=0;k<nq;k++) {
+      if (list[k]>=n_base+hdr.n_oth) meta_ok=false;
+    }
+    for(size_t i=0;i<3;i++) {
+      grid_meta[i].resize(sz[i]);
+      std::memcpy(&(grid_meta[i][0]),ptr,sz[i]*sizeof(double));
+      ptr+=sz[i]*sizeof(double);
+    }
+    for(size_t i=0;i<hdr.n_oth && meta_ok;i++) {
+      for(size_t k=0;k<2 && meta_ok;k++) {
+	uint64_t len;
+	if (((size_t)(end-ptr))<sizeof(uint64_t)) {
+	  meta_ok=false;
+	} else {
+	  std::memcpy(&len,ptr,sizeof(uint64_t));
+	  ptr+=sizeof(uint64_t);
+	  if (((size_t)(end-ptr))<len) {
+	    meta_ok=false;
+	  } else {
+	    std::string str(ptr,len);
+	    ptr+=len;
+	    if (k==0) names.push_back(str);
+	    else units.push_back(str);
+	  }
+	}
+      }
+    }
+  }
+  if (!meta_ok) {
+    munmap(addr,fsize);
+    O2SCL_ERR2("Invalid metadata in binary EOS file in ",
+	       "eos_sn_base::binary_load().",exc_efailed);
+  }
+
+  n_nB=hdr.n_nB;
+  n_Ye=hdr.n_Ye;
+  n_T=hdr.n_T;
+  n_oth=hdr.n_oth;
+  fused_list=list;
+  std::vector<double> grid;
+  for(size_t i=0;i<3;i++) {
+    fused_grid[i]=grid_meta[i];
+    grid.insert(grid.end(),fused_grid[i].begin(),fused_grid[i].end());
+  }
+  nB_grid=fused_grid[0];
+  Ye_grid=fused_grid[1];
+  T_grid=fused_grid[2];
+  oth_names=names;
+  oth_units=units;
+
+  baryons_only_loaded=((hdr.flags & 1)!=0);
+  with_leptons_loaded=((hdr.flags & 2)!=0);
+  include_muons=((hdr.flags & 4)!=0);
+  m_neut=hdr.m_neut;
+  m_prot=hdr.m_prot;
+
+  map_addr=addr;
+  map_size=fsize;
+  fused_ptr=(const double *)(base+hdr.data_offset);
+  for(size_t i=0;i<3;i++) fused_cache[i]=0;
+
+  if (fill_tensors) {
+    
+    alloc();
+    for(size_t i=0;i<n_base+n_oth;i++) {
+      arr[i]->set_grid_packed(grid);
+    }
+    for(size_t k=0;k<nq;k++) {
+      std::vector<double> d(ntot);
+      for(size_t j=0;j<ntot;j++) {
+	d[j]=fused_ptr[j*nq+k];
+      }
+      arr[fused_list[k]]->swap_data(d);
+    }
+    
+    loaded=true;
+    
+    // It is important that 'loaded' is set to true before the call to
+    // set_interp_type().
+    set_interp_type(itp_linear);
+  }
+  
+  if (verbose>0) {
+    cout << "Done in eos_sn_base::binary_load()." << endl;
+  }
+  
+  return;
+}
+
+void eos_sn_base::load_cached(std::string fname, std::string cache_fname,
+			      size_t mode, bool fill_tensors) {
+  if (binary_check(cache_fname,fname,mode)) {
+    binary_load(cache_fname,fill_tensors);
+  } else {
+    load(fname,mode);
+    binary_output(cache_fname,fname,mode);
+    // Switch to the memory-mapped data so that the result is
+    // the same as when the cache is already present
+    if (!fill_tensors) binary_load(cache_fname,false);
+  }
+  return;
+}
+
 void eos_sn_base::compute_eg_point(double nB, double Ye, double T,
 				   thermo &th, double &mue) {
   
@@ -211,6 +211,178 @@ namespace o2scl {
     void set_interp_type(size_t interp_type);
     //@}
 
+    /// \name Fused interpolation
+    //@{
+    /** \brief The result of a fused table lookup from
+        \ref interp_fused()
+
+        Quantities which were not included in the call to
+        \ref fused_init() are set to zero.
+    */
+    typedef struct fused_result_s {
+      /// Values, in the same order as \ref arr
+      double vals[n_base+30];
+      /// Total free energy per baryon in MeV
+      double &F() { return vals[0]; }
+      /// Free energy per baryon without leptons and photons in MeV
+      double &Fint() { return vals[1]; }
+      /// Total internal energy per baryon in MeV
+      double &E() { return vals[2]; }
+      /// Internal energy per baryon without leptons and photons in MeV
+      double &Eint() { return vals[3]; }
+      /// Total pressure in \f$ \mathrm{MeV}/\mathrm{fm}^3 \f$
+      double &P() { return vals[4]; }
+      /// Pressure without leptons and photons
+      double &Pint() { return vals[5]; }
+      /// Total entropy per baryon
+      double &S() { return vals[6]; }
+      /// Entropy per baryon without leptons and photons
+      double &Sint() { return vals[7]; }
+      /// Neutron chemical potential in MeV
+      double &mun() { return vals[8]; }
+      /// Proton chemical potential in MeV
+      double &mup() { return vals[9]; }
+      /// Proton number
+      double &Z() { return vals[10]; }
+      /// Mass number
+      double &A() { return vals[11]; }
+      /// Neutron baryon fraction
+      double &Xn() { return vals[12]; }
+      /// Proton baryon fraction
+      double &Xp() { return vals[13]; }
+      /// Alpha particle baryon fraction
+      double &Xalpha() { return vals[14]; }
+      /// Heavy nuclei baryon fraction
+      double &Xnuclei() { return vals[15]; }
+      /// Other data set with index \c i
+      double &other(size_t i) { return vals[n_base+i]; }
+    } fused_result;
+    
+    /** \brief Create an interleaved copy of the data sets with
+        indices (in \ref arr) given in \c list for use in
+        \ref interp_fused()
+
+        The interleaved copy stores all of the requested quantities
+        for each grid point next to each other, so that a single
+        grid search and a single pass over the eight corners of the
+        enclosing cell give all of the quantities at once. This
+        copy must be recreated if the data is modified. 
+    */
+    void fused_init(const std::vector<size_t> &list);
+
+    /** \brief Create an interleaved copy of all of the data sets
+        which have been loaded
+    */
+    void fused_init();
+
+    /** \brief Free the memory for the interleaved copy of the table
+     */
+    void fused_free();
+    
+    /** \brief Perform linear interpolation of all of the quantities
+        specified in \ref fused_init() at the point (\c nB, \c Ye,
+        \c T)
+
+        The results are identical to those obtained from
+        <tt>tensor_grid3::interp_linear()</tt> for each quantity.
+        This version uses internal search caches and thus is not
+        thread-safe.
+    */
+    void interp_fused(double nB, double Ye, double T, fused_result &res);
+
+    /** \brief Perform linear interpolation of all of the quantities
+        specified in \ref fused_init() using the caller-specified
+        search caches in \c cache
+
+        The array \c cache must have three elements, and may be
+        initialized to zero. This function does not modify the
+        object, so it can be called from several threads at once
+        so long as each uses a separate \c cache.
+    */
+    void interp_fused(double nB, double Ye, double T, fused_result &res,
+                      size_t cache[3]) const;
+    //@}
+
+    /// \name Binary cache files
+    //@{
+    /** \brief Output the full table to a native binary file
+        which can be read with \ref binary_load()
+
+        The file consists of a header (containing a version number,
+        the grid sizes, a checksum of the remainder of the file, and
+        the size and modification time of the source file \c
+        src_fname, if specified), followed by the grids, the names
+        and units of the additional data sets, and then all of the
+        loaded data sets in the interleaved format used by \ref
+        interp_fused(). The value of \c mode is also stored so that
+        a cache created with a different mode is not reused.
+        The binary file is specific to the machine architecture.
+
+        The file is first written to a temporary file in the same
+        directory, which is then renamed to \c fname, so that
+        concurrent readers never see a partially written file.
+    */
+    void binary_output(std::string fname, std::string src_fname="",
+                       size_t mode=0);
+
+    /** \brief Load a table from a binary file created by 
+        \ref binary_output()
+
+        The file is mapped into memory read-only with <tt>mmap()</tt>
+        and the mapped data is used directly by \ref interp_fused(),
+        so all processes on the same node which load the same file
+        share the same physical pages for that data. By default, only
+        \ref interp_fused() can be used afterwards and \ref
+        is_loaded() returns false. If \c fill_tensors is true, the
+        data is also copied into the tensor objects, e.g. \ref F and
+        \ref P, so that the rest of the class functions normally,
+        but then each process holds a private copy of the full table
+        in addition to the shared mapping.
+
+        If \ref binary_verify is true, the checksum of the entire
+        file is verified, which requires reading every page of the
+        file. The error handler is called if the file is not a
+        valid binary cache file, if the version does not match, if
+        the file size or metadata are inconsistent with the header,
+        or if the checksum fails.
+    */
+    void binary_load(std::string fname, bool fill_tensors=false);
+
+    /** \brief Return true if \c fname is a valid binary cache
+        file created from source \c src_fname with mode \c mode
+
+        This compares the version number and the size and
+        modification time of the source file with those stored in
+        the cache. It does not verify the checksum.
+    */
+    bool binary_check(std::string fname, std::string src_fname,
+                      size_t mode);
+
+    /** \brief Load the EOS from the binary cache file \c cache_fname
+        if it is up to date, otherwise load it from \c fname with
+        \ref load() and then create the cache
+
+        This allows the slow conversion from the original table
+        format to be performed only once. The value of \c
+        fill_tensors is passed to \ref binary_load(), so by default
+        the table is only available through the shared read-only
+        mapping used by \ref interp_fused(). If the cache is
+        created, the tensors are freed and the new cache is mapped
+        unless \c fill_tensors is true.
+    */
+    void load_cached(std::string fname, std::string cache_fname,
+                     size_t mode=0, bool fill_tensors=false);
+
+    /** \brief If true, verify the checksum in \ref binary_load()
+        (default false)
+
+        The checksum covers the full table, so verifying it reads
+        the whole file and removes the benefit of the shared
+        memory mapping for fast startup.
+    */
+    bool binary_verify;
+    //@}
+
     /// \name Nucleon masses
     //@{
     /** \brief Neutron mass in \f$ \mathrm{MeV} \f$ 
@@ -443,6 +615,24 @@ namespace o2scl {
     void alloc();
     //@}
 
+    /// \name Interleaved data for interp_fused()
+    //@{
+    /// The indices in \ref arr of the interleaved quantities
+    std::vector<size_t> fused_list;
+    /// The interleaved data, if not memory mapped
+    std::vector<double> fused_data;
+    /// Pointer to the interleaved data
+    const double *fused_ptr;
+    /// The memory-mapped binary file, if any
+    void *map_addr;
+    /// The size of the memory-mapped binary file
+    size_t map_size;
+    /// The grids for the interleaved data
+    std::vector<double> fused_grid[3];
+    /// The search caches for \ref interp_fused()
+    size_t fused_cache[3];
+    //@}
+
   };
 
   /** \brief The Lattimer-Swesty supernova EOS 
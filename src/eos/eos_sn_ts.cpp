@@ -0,0 +1,288 @@
+/*
+  -------------------------------------------------------------------
+
+  Copyright (C) 2021, Andrew W. Steiner
+
+  This file is part of O2scl.
+
+  O2scl is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  O2scl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with O2scl. If not, see <http://www.gnu.org/licenses/>.
+
+  -------------------------------------------------------------------
+*/
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+#include <utime.h>
+
+#include <o2scl/test_mgr.h>
+#include <o2scl/exception.h>
+#include <o2scl/eos_sn.h>
+
+using namespace std;
+using namespace o2scl;
+
+/** \brief A small synthetic table which does not require
+    an external data file
+*/
+class eos_sn_synth : public eos_sn_base {
+
+public:
+
+  virtual void load(std::string fname, size_t mode) {
+
+    n_nB=5;
+    n_Ye=4;
+    n_T=3;
+    n_oth=1;
+    oth_names.push_back("X3");
+    oth_units.push_back("");
+    alloc();
+
+    std::vector<double> grid={0.01,0.02,0.04,0.07,0.1,
+			      0.1,0.2,0.3,0.5,
+			      1.0,2.0,5.0};
+    for(size_t i=0;i<n_base+n_oth;i++) {
+      arr[i]->set_grid_packed(grid);
+    }
+    nB_grid.assign(grid.begin(),grid.begin()+n_nB);
+    Ye_grid.assign(grid.begin()+n_nB,grid.begin()+n_nB+n_Ye);
+    T_grid.assign(grid.begin()+n_nB+n_Ye,grid.end());
+    // A different smooth nonlinear function for each data set
+    for(size_t i=0;i<n_base+n_oth;i++) {
+      for(size_t j=0;j<n_nB;j++) {
+	for(size_t k=0;k<n_Ye;k++) {
+	  for(size_t ell=0;ell<n_T;ell++) {
+	    double nB=grid[j], Ye=grid[n_nB+k], T=grid[n_nB+n_Ye+ell];
+	    arr[i]->set(j,k,ell,((double)(i+1))*sin(30.0*nB)+
+			Ye*Ye*T+((double)i)*T*T/(nB+1.0));
+	  }
+	}
+      }
+    }
+
+    loaded=true;
+    with_leptons_loaded=true;
+    baryons_only_loaded=true;
+    return;
+  }
+
+};
+
+/// Return true if \ref eos_sn_base::binary_load() calls the error handler
+bool load_fails(eos_sn_base &eos, std::string fname) {
+  bool failed=false;
+  try {
+    eos.binary_load(fname);
+  } catch (std::exception &e) {
+    failed=true;
+    err_hnd->reset();
+  }
+  return failed;
+}
+
+/// Copy the first \c n bytes of \c src to \c dest
+void copy_bytes(std::string src, std::string dest, size_t n) {
+  std::ifstream fin(src.c_str(),std::ios::binary);
+  std::vector<char> buf(n);
+  fin.read(&buf[0],n);
+  fin.close();
+  std::ofstream fout(dest.c_str(),std::ios::binary);
+  fout.write(&buf[0],n);
+  fout.close();
+  return;
+}
+
+int main(void) {
+
+  cout.setf(ios::scientific);
+
+  test_mgr t;
+  t.set_output_level(1);
+
+  err_hnd_cpp ee;
+  err_hnd=&ee;
+
+  // -------------------------------------------------------------
+  // Binary cache round trip
+
+  {
+    std::string src="eos_sn_ts_src.txt";
+    std::string bin="eos_sn_ts.bin";
+    std::ofstream fout(src.c_str());
+    fout << "synthetic table" << endl;
+    fout.close();
+
+    eos_sn_synth es;
+    es.verbose=0;
+    es.load(src,0);
+    es.binary_output(bin,src,1);
+    t.test_gen(es.binary_check(bin,src,1),"binary_check()");
+
+    // The mapped data must agree with the tensors at every grid
+    // point for every data set
+    eos_sn_synth es2;
+    es2.verbose=0;
+    es2.binary_load(bin);
+    t.test_gen(es2.is_loaded()==false,"no tensors");
+    double max_diff=0.0;
+    eos_sn_base::fused_result res;
+    for(size_t j=0;j<es.n_nB;j++) {
+      for(size_t k=0;k<es.n_Ye;k++) {
+	for(size_t ell=0;ell<es.n_T;ell++) {
+	  es2.interp_fused(es.nB_grid[j],es.Ye_grid[k],es.T_grid[ell],res);
+	  for(size_t i=0;i<es.n_base+es.n_oth;i++) {
+	    double v=es.arr[i]->get(j,k,ell);
+	    max_diff=std::max(max_diff,fabs(res.vals[i]-v)/fabs(v));
+	  }
+	}
+      }
+    }
+    t.test_abs(max_diff,0.0,1.0e-14,"mapped values");
+
+    eos_sn_synth es3;
+    es3.verbose=0;
+    es3.binary_load(bin,true);
+    t.test_gen(es3.is_loaded(),"fill_tensors");
+    t.test_gen(es3.n_oth==1 && es3.oth_names[0]=="X3","names");
+    bool match=true;
+    for(size_t i=0;i<es.n_base+es.n_oth;i++) {
+      for(size_t j=0;j<es.n_nB;j++) {
+	for(size_t k=0;k<es.n_Ye;k++) {
+	  for(size_t ell=0;ell<es.n_T;ell++) {
+	    if (es3.arr[i]->get(j,k,ell)!=es.arr[i]->get(j,k,ell)) {
+	      match=false;
+	    }
+	  }
+	}
+      }
+    }
+    t.test_gen(match,"filled values");
+
+    // A cache with a different mode is not reused
+    t.test_gen(es.binary_check(bin,src,0)==false,"wrong mode");
+
+    // A modified source file invalidates the cache
+    struct utimbuf ut;
+    ut.actime=1000000;
+    ut.modtime=1000000;
+    utime(src.c_str(),&ut);
+    t.test_gen(es.binary_check(bin,src,1)==false,"stale mtime");
+    es.binary_output(bin,src,1);
+    t.test_gen(es.binary_check(bin,src,1),"binary_check() 2");
+    fout.open(src.c_str(),std::ios::app);
+    fout << "more" << endl;
+    fout.close();
+    utime(src.c_str(),&ut);
+    t.test_gen(es.binary_check(bin,src,1)==false,"stale size");
+    t.test_gen(es.binary_check("nonexistent.bin",src,1)==false,
+	       "missing cache");
+
+    // A truncated file calls the error handler
+    es.binary_output(bin,src,1);
+    std::ifstream fin(bin.c_str(),std::ios::binary|std::ios::ate);
+    size_t fsize=fin.tellg();
+    fin.close();
+    copy_bytes(bin,"eos_sn_ts_trunc.bin",fsize-8);
+    t.test_gen(es.binary_check("eos_sn_ts_trunc.bin",src,1)==false,
+	       "truncated check");
+    eos_sn_synth es4;
+    es4.verbose=0;
+    t.test_gen(load_fails(es4,"eos_sn_ts_trunc.bin"),"truncated data");
+    copy_bytes(bin,"eos_sn_ts_trunc.bin",100);
+    t.test_gen(load_fails(es4,"eos_sn_ts_trunc.bin"),"truncated header");
+
+    // A corrupted data value is only detected with binary_verify
+    copy_bytes(bin,"eos_sn_ts_trunc.bin",fsize);
+    std::fstream fcor("eos_sn_ts_trunc.bin",std::ios::binary|
+		      std::ios::in|std::ios::out);
+    fcor.seekp(fsize-4);
+    fcor.put(1);
+    fcor.close();
+    t.test_gen(load_fails(es4,"eos_sn_ts_trunc.bin")==false,"no verify");
+    es4.binary_verify=true;
+    t.test_gen(load_fails(es4,"eos_sn_ts_trunc.bin"),"verify");
+    es4.binary_verify=false;
+
+    std::remove(src.c_str());
+    std::remove(bin.c_str());
+    std::remove("eos_sn_ts_trunc.bin");
+  }
+
+  // -------------------------------------------------------------
+  // Compare interp_fused() with interp_linear() for each data set
+  
+  {
+    eos_sn_synth es;
+    es.verbose=0;
+    es.load("",0);
+    std::vector<size_t> list={0,4,6,11,16};
+    es.fused_init(list);
+
+    // Points inside cells, on cell edges, and on the grid
+    // boundaries, in each direction
+    std::vector<double> nBv={0.01,0.015,0.02,0.055,0.07,0.1};
+    std::vector<double> Yev={0.1,0.13,0.3,0.45,0.5};
+    std::vector<double> Tv={1.0,1.7,2.0,4.2,5.0};
+    
+    eos_sn_base::fused_result res;
+    double max_diff=0.0;
+    bool others_zero=true;
+    for(size_t j=0;j<nBv.size();j++) {
+      for(size_t k=0;k<Yev.size();k++) {
+	for(size_t ell=0;ell<Tv.size();ell++) {
+	  es.interp_fused(nBv[j],Yev[k],Tv[ell],res);
+	  for(size_t i=0;i<es.n_base+es.n_oth;i++) {
+	    if (std::find(list.begin(),list.end(),i)!=list.end()) {
+	      double v=es.arr[i]->interp_linear(nBv[j],Yev[k],Tv[ell]);
+	      max_diff=std::max(max_diff,fabs(res.vals[i]-v)/fabs(v));
+	    } else if (res.vals[i]!=0.0) {
+	      others_zero=false;
+	    }
+	  }
+	}
+      }
+    }
+    t.test_abs(max_diff,0.0,1.0e-14,"interp_fused() vs. interp_linear()");
+    t.test_gen(others_zero,"interp_fused() unused quantities");
+    t.test_rel(res.P(),es.P.interp_linear(0.1,0.5,5.0),1.0e-14,
+	       "interp_fused() upper corner");
+
+    // The thread-safe version with a user-specified cache
+    size_t cache[3]={0,0,0};
+    eos_sn_base::fused_result res2;
+    es.interp_fused(0.055,0.13,1.7,res2,cache);
+    t.test_rel(res2.other(0),es.arr[16]->interp_linear(0.055,0.13,1.7),
+	       1.0e-14,"interp_fused() with cache");
+
+    // Using all of the quantities
+    es.fused_init();
+    es.interp_fused(0.03,0.4,3.0,res);
+    max_diff=0.0;
+    for(size_t i=0;i<es.n_base+es.n_oth;i++) {
+      double v=es.arr[i]->interp_linear(0.03,0.4,3.0);
+      max_diff=std::max(max_diff,fabs(res.vals[i]-v)/fabs(v));
+    }
+    t.test_abs(max_diff,0.0,1.0e-14,"fused_init() all quantities");
+  }
+
+  t.report();
+
+  return 0;
+}
+
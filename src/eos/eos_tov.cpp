@@ -1492,12 +1492,46 @@ void eos_tov_interp::ed_nb_from_pr(double pr, double &ed, double &nb) {
   return;
 }
 
+void eos_tov_interp::ed_nb_from_pr_acc(double pr, double &ed, double &nb,
+					eos_tov_accel &acc) {
+
+  if (!std::isfinite(pr)) {
+    O2SCL_ERR2("Pressure not finite in ",
+	       "eos_tov_interp::ed_nb_from_pr_acc().",exc_efailed);
+  }
+
+  size_t n=full_vecp.size();
+  if (n<2) {
+    O2SCL_ERR2("EOS not specified in ",
+	       "eos_tov_interp::ed_nb_from_pr_acc().",exc_einval);
+  }
+  
+  ed=acc.interp(pr,n,full_vecp,full_vece);
+  if (baryon_column) {
+    nb=acc.interp(pr,n,full_vecp,full_vecnb);
+  }
+
+  if (err_nonconv) {
+    if (!std::isfinite(ed) || (baryon_column && !std::isfinite(nb))) {
+      string s="Energy density or baryon density not finite at pressure ";
+      s+=dtos(pr)+" in eos_tov_interp::ed_nb_from_pr_acc().";
+      O2SCL_ERR(s.c_str(),exc_efailed);
+    }
+  }
+  
+  return;
+}
+
 double eos_tov_interp::ed_from_pr(double pr) {
   return pe_int.eval(pr);
 }
 
+// The functions below use a temporary accelerator rather than
+// gen_int so that they do not modify the object
+
 double eos_tov_interp::ed_from_nb(double nb) {
-  return gen_int.eval(nb,full_vece.size(),full_vecnb,full_vece);
+  eos_tov_accel acc;
+  return acc.interp(nb,full_vece.size(),full_vecnb,full_vece);
 }
 
 double eos_tov_interp::nb_from_pr(double pr) {
@@ -1505,15 +1539,18 @@ double eos_tov_interp::nb_from_pr(double pr) {
 }
 
 double eos_tov_interp::nb_from_ed(double ed) {
-  return gen_int.eval(ed,full_vece.size(),full_vece,full_vecnb);
+  eos_tov_accel acc;
+  return acc.interp(ed,full_vece.size(),full_vece,full_vecnb);
 }
 
 double eos_tov_interp::pr_from_nb(double nb) {
-  return gen_int.eval(nb,full_vece.size(),full_vecnb,full_vecp);
+  eos_tov_accel acc;
+  return acc.interp(nb,full_vece.size(),full_vecnb,full_vecp);
 }
 
 double eos_tov_interp::pr_from_ed(double ed) {
-  return gen_int.eval(ed,full_vece.size(),full_vece,full_vecp);
+  eos_tov_accel acc;
+  return acc.interp(ed,full_vece.size(),full_vece,full_vecp);
 }
 
 void eos_tov_interp::get_eden_user(double pres, double &ed, double &nb) {
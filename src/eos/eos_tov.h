@@ -43,6 +43,83 @@
 namespace o2scl {
 #endif
 
+  /** \brief Search state for interpolated EOSs owned by the 
+      caller of \ref eos_tov::ed_nb_from_pr_acc()
+
+      This object stores the index of the last interval found
+      in the EOS table, so that one EOS object can be shared among
+      several threads, each with its own accelerator. When
+      successive pressures are in the same or in a neighboring
+      interval, as in an outward TOV integration, the lookup
+      requires no binary search.
+  */
+  class eos_tov_accel {
+
+  public:
+
+    eos_tov_accel() {
+      index=0;
+    }
+
+    /// Index of the last interval
+    size_t index;
+
+    /// Forget the last interval
+    void reset() {
+      index=0;
+      return;
+    }
+
+    /** \brief Find the interval \c i containing \c x0 in the 
+	first \c n elements of the increasing vector \c x
+
+	The result satisfies <tt>x[i]<=x0<x[i+1]</tt>, except that
+	it is set to zero for values below <tt>x[0]</tt> and to
+	<tt>n-2</tt> for values above <tt>x[n-2]</tt>, consistent
+	with \ref o2scl::search_vec .
+    */
+    template<class vec_t>
+    size_t find(double x0, size_t n, const vec_t &x) {
+      if (n<2) {
+	O2SCL_ERR2("Need at least two points in ",
+		   "eos_tov_accel::find().",exc_einval);
+      }
+      if (index>n-2) index=n-2;
+      if (x0<x[index]) {
+	if (index>0 && x0>=x[index-1]) {
+	  index--;
+	} else if (index>0) {
+	  index=vector_bsearch_inc<vec_t,double>(x0,x,0,index);
+	}
+      } else if (x0>=x[index+1]) {
+	if (index+2<n && x0<x[index+2]) {
+	  index++;
+	} else if (index+2<n) {
+	  index=vector_bsearch_inc<vec_t,double>(x0,x,index+1,n-1);
+	}
+      }
+      if (index>n-2) index=n-2;
+      return index;
+    }
+
+    /** \brief Linearly interpolate \c y at \c x0 using the
+	first \c n elements of \c x and \c y
+
+	This gives the same result as \ref o2scl::interp_linear .
+    */
+    template<class vec_t>
+    double interp(double x0, size_t n, const vec_t &x, const vec_t &y) {
+      size_t i=find(x0,n,x);
+      double x_lo=x[i];
+      double x_hi=x[i+1];
+      double y_lo=y[i];
+      double y_hi=y[i+1];
+      double dx=x_hi-x_lo;
+      return y_lo+(x0-x_lo)/dx*(y_hi-y_lo);
+    }
+
+  };
+  
   /** \brief A EOS base class for the TOV solver
    */
   class eos_tov {
@@ -107,6 +184,26 @@ namespace o2scl {
     */
     virtual void ed_nb_from_pr(double pr, double &ed, double &nb)=0;
 
+    /** \brief Given the pressure, produce the energy and number 
+	densities using the caller-owned accelerator \c acc
+
+	The default version ignores \c acc and calls \ref
+	ed_nb_from_pr().
+    */
+    virtual void ed_nb_from_pr_acc(double pr, double &ed, double &nb,
+				   eos_tov_accel &acc) {
+      ed_nb_from_pr(pr,ed,nb);
+      return;
+    }
+
+    /** \brief Return true if \ref ed_nb_from_pr_acc() may be 
+	called from several threads at once, each with its own
+	accelerator (default false)
+    */
+    virtual bool is_thread_safe() const {
+      return false;
+    }
+
   };
 
   /** \brief The Buchdahl EOS for the TOV solver
@@ -260,6 +357,11 @@ namespace o2scl {
     */
     virtual void ed_nb_from_pr(double pr, double &ed, double &nb);
 
+    /// This EOS has no internal state, so it is thread safe
+    virtual bool is_thread_safe() const {
+      return true;
+    }
+
     /** \brief Given the gravitational mass, compute the radius
      */
     virtual double rad_from_gm(double gm);
@@ -397,6 +499,11 @@ namespace o2scl {
      */
     virtual void ed_nb_from_pr(double pr, double &ed, double &nb);
 
+    /// This EOS has no internal state, so it is thread safe
+    virtual bool is_thread_safe() const {
+      return true;
+    }
+
   };
 
   /** \brief Linear EOS \f$ P = c_s^2 (\varepsilon-\varepsilon_0) \f$
@@ -484,6 +591,11 @@ namespace o2scl {
      */
     virtual void ed_nb_from_pr(double pr, double &ed, double &nb);
 
+    /// This EOS has no internal state, so it is thread safe
+    virtual bool is_thread_safe() const {
+      return true;
+    }
+
   };
 
   /** \brief Provide an EOS for TOV solvers based on 
@@ -494,6 +606,7 @@ namespace o2scl {
     /** \brief Internal function to reset the interpolation
      */
     void reset_interp(size_t n) {
+      n_eos=n;
       pe_int.set(n,pr_vec,ed_vec,itp_linear);
       ep_int.set(n,ed_vec,pr_vec,itp_linear);
       return;
@@ -513,6 +626,10 @@ namespace o2scl {
     
   public:
 
+    eos_tov_vectors() {
+      n_eos=0;
+    }
+
     /** \brief Read the EOS from a set of equal length
         vectors for energy density, pressure, and baryon density
 
@@ -631,12 +748,41 @@ namespace o2scl {
       }
       return;
     }
+
+    /** \brief Given the pressure, produce the energy and number 
+	densities using the accelerator \c acc
+
+	This function does not modify the EOS object and gives the
+	same results as \ref ed_nb_from_pr(), assuming the pressures
+	are increasing.
+    */
+    virtual void ed_nb_from_pr_acc(double pr, double &ed, double &nb,
+				   eos_tov_accel &acc) {
+      if (n_eos<2) {
+        O2SCL_ERR2("EOS not specified in ",
+                   "eos_tov_vectors::ed_nb_from_pr_acc().",exc_einval);
+      }
+      ed=acc.interp(pr,n_eos,pr_vec,ed_vec);
+      if (this->baryon_column) {
+        nb=acc.interp(pr,n_eos,pr_vec,nb_vec);
+      }
+      return;
+    }
+
+    /** \brief Return true, since the interpolation objects are not
+	modified after the vectors are read
+    */
+    virtual bool is_thread_safe() const {
+      return true;
+    }
     //@}
     
   protected:
     
     /// \name EOS storage
     //@{
+    /// Number of points in the EOS
+    size_t n_eos;
     /// Energy densities from full EOS
     vec_t ed_vec;
     /// Pressures from full EOS
@@ -901,6 +1047,24 @@ namespace o2scl {
         zero or \ref baryon_column should be set to false
     */
     virtual void ed_nb_from_pr(double pr, double &ed, double &nb);
+
+    /** \brief Given the pressure, produce the energy and number 
+	densities using the accelerator \c acc
+
+	This function does not modify the EOS object, so several
+	threads may share one EOS table as long as each uses its own
+	accelerator. The results are the same as those from \ref
+	ed_nb_from_pr().
+    */
+    virtual void ed_nb_from_pr_acc(double pr, double &ed, double &nb,
+				   eos_tov_accel &acc);
+
+    /** \brief Return true, since the EOS functions do not modify
+	the object once the table has been read
+    */
+    virtual bool is_thread_safe() const {
+      return true;
+    }
     //@}
 
     /// \name Other functions
@@ -284,7 +284,26 @@ int main(void) {
   t.test_rel(te.nb_from_pr(te.pr_from_nb(0.02)),0.02,1.0e-12,"prnb2");
   t.test_rel(te.ed_from_pr(te.pr_from_ed(1.0)),1.0,1.0e-12,"edpr1");
   t.test_rel(te.ed_from_pr(te.pr_from_ed(0.01)),0.01,1.0e-12,"edpr2");
-  
+
+  // Test the accelerated version with decreasing pressures as
+  // in a TOV integration and then with a random jump
+  {
+    t.test_gen(te.is_thread_safe(),"interp thread safe");
+    eos_tov_accel acc;
+    bool match=true;
+    for(double pr=1.0e-3;pr>1.0e-10;pr/=1.01) {
+      double ed1, nb1, ed2, nb2;
+      te.ed_nb_from_pr(pr,ed1,nb1);
+      te.ed_nb_from_pr_acc(pr,ed2,nb2,acc);
+      if (ed1!=ed2 || nb1!=nb2) match=false;
+    }
+    double ed1, nb1, ed2, nb2;
+    te.ed_nb_from_pr(2.0e-4,ed1,nb1);
+    te.ed_nb_from_pr_acc(2.0e-4,ed2,nb2,acc);
+    if (ed1!=ed2 || nb1!=nb2) match=false;
+    t.test_gen(match,"ed_nb_from_pr_acc");
+  }
+
   //test_crust(te,cu,pr_low,pr_high,true,t);
 
   cout << "-------------------------------------------------------------- "
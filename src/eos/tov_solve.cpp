@@ -31,6 +31,10 @@
 #include <o2scl/tov_solve.h>
 #include <o2scl/root_cern.h>
 
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace o2scl;
 using namespace o2scl_const;
@@ -113,6 +117,9 @@ tov_solve::tov_solve() : out_table(new table_units<>) {
   tmass=0.0;
 
   max_integ_steps=100000;
+  warm_start=false;
+  warm_step=0.0;
+  n_threads=1;
   pmax_default=1.0e20;
   pcent_max=pmax_default;
   reformat_results=true;
@@ -239,7 +246,7 @@ int tov_solve::derivs(double r, size_t nv, const ubvector &y,
   // The function get_eden() is now already in the proper units,
   // so there's no need for unit conversion here
   double ed, nb;
-  te->ed_nb_from_pr(pres,ed,nb);
+  te->ed_nb_from_pr_acc(pres,ed,nb,eos_acc);
   
   if (!std::isfinite(ed)) {
     return exc_efailed;
@@ -607,6 +614,10 @@ int tov_solve::integ_star(size_t ndvar, const ubvector &ndx,
   size_t ix=0, ix_next=1;
   int test;
 
+  // Step size carried between steps if warm_start is true
+  double h_warm=step_start;
+  if (warm_start && warm_step>0.0) h_warm=warm_step;
+
   // ---------------------------------------------------------------
   // Main loop
 
@@ -618,6 +629,7 @@ int tov_solve::integ_star(size_t ndvar, const ubvector &ndx,
     // Fix step size if too large or too small
     
     double h=step_start;
+    if (warm_start) h=h_warm;
     if (h>step_max) h=step_max;
     if (h<step_min) h=step_min;
 
@@ -637,6 +649,13 @@ int tov_solve::integ_star(size_t ndvar, const ubvector &ndx,
       ix++;
       ix_next++;
 
+      // Store the step size for the next step and, after the first
+      // step, for the next star
+      if (warm_start) {
+	h_warm=h;
+	if (it==0) warm_step=h;
+      }
+
       // ---------------------------------------------------------------
       // Verbose output
     
@@ -835,10 +854,126 @@ int tov_solve::integ_star(size_t ndvar, const ubvector &ndx,
   return 0;
 }
 
+int tov_solve::mvsr_row(double pcent, std::vector<double> &line) {
+
+  ubvector x(1), y(1);
+  x[0]=pcent;
+  integ_star_final=true;
+  int ret=integ_star(1,x,y);
+
+  // --------------------------------------------------------------
+  // Fill line of data for table
+
+  line.clear();
+
+  // output mass and radius
+  line.push_back(mass);
+  line.push_back(rad);
+
+  // Gravitational potential and angular velocity columns
+  if (calc_gpot) {
+    line.push_back(gpot);
+    if (ang_vel) {
+      line.push_back(last_rjw);
+      line.push_back(last_f);
+    }
+  }
+
+  // output baryon mass
+  if (te->has_baryons()) line.push_back(bmass);
+
+  // output central pressure, energy density, and baryon density
+
+  double ed, nb;
+  if (!std::isfinite(pcent)) {
+    O2SCL_ERR2("Central pressure not finite in ",
+	       "tov_solve::mvsr_row().",exc_efailed);
+  }
+  te->ed_nb_from_pr(pcent,ed,nb);
+
+  // Convert pressure, energy density, and baryon density to user 
+  // units by dividing by their factors
+  line.push_back(pcent/pfactor);
+  line.push_back(ed/efactor);
+  if (te->has_baryons()) {
+    line.push_back(nb/nfactor);
+  }
+
+  // output surface gravity and redshift
+
+  if (rad!=0.0) {
+    line.push_back(schwarz_km/2.0*mass/rad/rad/
+		   sqrt(1.0-schwarz_km*mass/rad));
+    line.push_back(1.0/sqrt(1.0-mass*schwarz_km/rad)-1.0);
+  } else {
+    line.push_back(0.0);
+    line.push_back(0.0);
+  }
+
+  // output derivatives
+
+  line.push_back(0.0);
+  line.push_back(0.0);
+  if (calc_gpot) line.push_back(0.0);
+  if (te->has_baryons()) line.push_back(0.0);
+
+  // Radius interpolation
+  if (pr_list.size()>0) {
+    iop.set_type(itp_linear);
+    ubvector lpr_col(rky.size()), gm_col(rky.size()), bm_col(rky.size());
+    for(size_t ii=0;ii<rky.size();ii++) {
+      lpr_col[ii]=rky[ii][1];
+      gm_col[ii]=rky[ii][0];
+      if (te->has_baryons()) {
+	size_t index=2;
+	if (calc_gpot) {
+	  index++;
+	  if (ang_vel) index+=2;
+	}
+	bm_col[ii]=rky[ii][index];
+      }
+    }
+    for(size_t ii=0;ii<pr_list.size();ii++) {
+      double thisr=iop.eval(log(pr_list[ii]*pfactor),
+			      ix_last-1,lpr_col,rkx);
+      double thisgm=iop.eval(log(pr_list[ii]*pfactor),
+			       ix_last-1,lpr_col,gm_col);
+      if (!std::isfinite(thisr)) {
+	string str=((string)"Obtained non-finite value when ")+
+	  "interpolating radius for pressure "+dtos(pr_list[ii])+
+	  " in tov_solve::mvsr_row().";
+	O2SCL_ERR(str.c_str(),exc_efailed);
+      }
+      line.push_back(thisr);
+      if (!std::isfinite(thisgm)) {
+	string str=((string)"Obtained non-finite value when ")+
+	  "interpolating gravitational mass for pressure "+dtos(pr_list[ii])+
+	  " in tov_solve::mvsr_row().";
+	O2SCL_ERR(str.c_str(),exc_efailed);
+      }
+      line.push_back(thisgm);
+      if (te->has_baryons()) {
+	double thisbm=iop.eval(log(pr_list[ii]*pfactor),
+			       ix_last-1,lpr_col,bm_col);
+	if (!std::isfinite(thisbm)) {
+	  string str=((string)"Obtained non-finite value when ")+
+	    "interpolating baryon mass for pressure "+dtos(pr_list[ii])+
+	    " in tov_solve::mvsr_row().";
+	  O2SCL_ERR(str.c_str(),exc_efailed);
+	}
+	line.push_back(thisbm);
+      }
+    }
+  }
+
+  return ret;
+}
+
 int tov_solve::mvsr() {
 
   int info=0;
   pcent_max=pmax_default;
+  warm_step=0.0;
 
   if (eos_set==false) {
     O2SCL_ERR
@@ -854,140 +989,169 @@ int tov_solve::mvsr() {
   column_setup(true);
 
   // ---------------------------------------------------------------
-  // Main loop
-
-  ubvector x(1), y(1);
-  for (x[0]=prbegin;((prend>prbegin && x[0]<=prend) ||
-		     (prend<prbegin && x[0]>=prend));) {
-    
-    integ_star_final=true;
-    int ret=integ_star(1,x,y);
-    if (ret!=0 && info==0) {
-      O2SCL_CONV((((string)"Integration of star with central pressure ")
-		  +dtos(x[0])+" failed in mvsr().").c_str(),exc_efailed,
-		 err_nonconv);
-      info+=mvsr_integ_star_failed+ret;
-    }
-      
-    // --------------------------------------------------------------
-    // Fill line of data for table
+  // List of central pressures
 
-    std::vector<double> line;
+  std::vector<double> pr_vals;
+  for (double pr=prbegin;((prend>prbegin && pr<=prend) ||
+			  (prend<prbegin && pr>=prend));pr*=princ) {
+    pr_vals.push_back(pr);
+  }
+  size_t npr=pr_vals.size();
 
-    // output mass and radius
-    line.push_back(mass);
-    line.push_back(rad);
+  // ---------------------------------------------------------------
+  // Determine the number of threads
 
-    // Gravitational potential and angular velocity columns
-    if (calc_gpot) {
-      line.push_back(gpot);
-      if (ang_vel) {
-	line.push_back(last_rjw);
-	line.push_back(last_f);
+  size_t nt=n_threads;
+#ifdef O2SCL_OPENMP
+  if (nt>1 && (as_ptr!=&def_stepper || !def_stepper.using_def_step())) {
+    if (verbose>0) {
+      cout << "Non-default stepper selected, so tov_solve::mvsr() "
+	   << "is using only one thread." << endl;
+    }
+    nt=1;
+  }
+  if (nt>npr) nt=npr;
+  if (nt>1 && !te->is_thread_safe()) {
+    for(size_t it=0;it<nt;it++) {
+      if (it>=thread_eos.size() || thread_eos[it]==0) {
+	if (verbose>0) {
+	  cout << "EOS is not thread safe, so tov_solve::mvsr() "
+	       << "is using only one thread." << endl;
+	}
+	nt=1;
       }
     }
+  }
+#else
+  nt=1;
+#endif
 
-    // output baryon mass
-    if (te->has_baryons()) line.push_back(bmass);
+  if (nt<=1) {
     
-    // output central pressure, energy density, and baryon density
-
-    double ed, nb;
-    if (!std::isfinite(x[0])) {
-      O2SCL_ERR2("Central pressure not finite in ",
-		 "tov_solve::mvsr().",exc_efailed);
-    }
-    te->ed_nb_from_pr(x[0],ed,nb);
+    // ---------------------------------------------------------------
+    // Main loop
     
-    // Convert pressure, energy density, and baryon density to user 
-    // units by dividing by their factors
-    line.push_back(x[0]/pfactor);
-    line.push_back(ed/efactor);
-    if (te->has_baryons()) {
-      line.push_back(nb/nfactor);
+    for(size_t i=0;i<npr;i++) {
+    
+      std::vector<double> line;
+      int ret=mvsr_row(pr_vals[i],line);
+      if (ret!=0 && info==0) {
+	O2SCL_CONV((((string)"Integration of star with central pressure ")
+		    +dtos(pr_vals[i])+" failed in mvsr().").c_str(),
+		   exc_efailed,err_nonconv);
+	info+=mvsr_integ_star_failed+ret;
+      }
+      
+      // --------------------------------------------------------------
+      // Copy line of data to table
+      
+      out_table->line_of_data(line.size(),&(line[0]));
+      if (line.size()!=out_table->get_ncolumns()) {
+	O2SCL_ERR("Table size problem in tov_solve::mvsr().",
+		  exc_esanity);
+      }
+      
     }
 
-    // output surface gravity and redshift
+  } else {
 
-    if (rad!=0.0) {
-      line.push_back(schwarz_km/2.0*mass/rad/rad/
-		     sqrt(1.0-schwarz_km*mass/rad));
-      line.push_back(1.0/sqrt(1.0-mass*schwarz_km/rad)-1.0);
-    } else {
-      line.push_back(0.0);
-      line.push_back(0.0);
+    // ---------------------------------------------------------------
+    // Set up a separate solver for each thread
+
+    std::vector<std::shared_ptr<tov_solve> > workers(nt);
+    for(size_t it=0;it<nt;it++) {
+      workers[it]=std::make_shared<tov_solve>();
+      workers[it]->copy_settings(*this);
+      if (it<thread_eos.size() && thread_eos[it]!=0) {
+	workers[it]->te=thread_eos[it];
+      }
+      // Convergence failures and output are handled below 
+      workers[it]->err_nonconv=false;
+      workers[it]->verbose=0;
     }
     
-    // output derivatives
+    std::vector<std::vector<std::vector<double> > > lines(nt);
+    std::vector<std::vector<int> > rets(nt);
+    std::vector<std::string> errors(nt);
 
-    line.push_back(0.0);
-    line.push_back(0.0);
-    if (calc_gpot) line.push_back(0.0);
-    if (te->has_baryons()) line.push_back(0.0);
-
-    // Radius interpolation
-    if (pr_list.size()>0) {
-      iop.set_type(itp_linear);
-      ubvector lpr_col(rky.size()), gm_col(rky.size()), bm_col(rky.size());
-      for(size_t ii=0;ii<rky.size();ii++) {
-	lpr_col[ii]=rky[ii][1];
-	gm_col[ii]=rky[ii][0];
-	if (te->has_baryons()) {
-	  size_t index=2;
-	  if (calc_gpot) {
-	    index++;
-	    if (ang_vel) index+=2;
+    // ---------------------------------------------------------------
+    // Each thread computes a contiguous block of central pressures
+    
+#ifdef O2SCL_OPENMP
+    omp_set_num_threads(nt);
+#pragma omp parallel default(shared)
+#endif
+    {
+#ifdef O2SCL_OPENMP
+#pragma omp for schedule(static,1)
+#endif
+      for(size_t it=0;it<nt;it++) {
+	size_t i_start=it*npr/nt, i_end=(it+1)*npr/nt;
+	// Exceptions cannot leave the parallel region, so we store
+	// the message and call the error handler afterwards
+	try {
+	  for(size_t i=i_start;i<i_end;i++) {
+	    std::vector<double> line;
+	    rets[it].push_back(workers[it]->mvsr_row(pr_vals[i],line));
+	    lines[it].push_back(line);
 	  }
-	  bm_col[ii]=rky[ii][index];
+	} catch (std::exception &e) {
+	  errors[it]=e.what();
 	}
       }
-      for(size_t ii=0;ii<pr_list.size();ii++) {
-	double thisr=iop.eval(log(pr_list[ii]*pfactor),
-				ix_last-1,lpr_col,rkx);
-	double thisgm=iop.eval(log(pr_list[ii]*pfactor),
-				 ix_last-1,lpr_col,gm_col);
-	if (!std::isfinite(thisr)) {
-	  string str=((string)"Obtained non-finite value when ")+
-	    "interpolating radius for pressure "+dtos(pr_list[ii])+
-	    " in tov_solve::mvsr().";
-	  O2SCL_ERR(str.c_str(),exc_efailed);
-	}
-	line.push_back(thisr);
-	if (!std::isfinite(thisgm)) {
-	  string str=((string)"Obtained non-finite value when ")+
-	    "interpolating gravitational mass for pressure "+dtos(pr_list[ii])+
-	    " in tov_solve::mvsr().";
-	  O2SCL_ERR(str.c_str(),exc_efailed);
-	}
-	line.push_back(thisgm);
-	if (te->has_baryons()) {
-	  double thisbm=iop.eval(log(pr_list[ii]*pfactor),
-				 ix_last-1,lpr_col,bm_col);
-	  if (!std::isfinite(thisbm)) {
-	    string str=((string)"Obtained non-finite value when ")+
-	      "interpolating baryon mass for pressure "+dtos(pr_list[ii])+
-	      " in tov_solve::mvsr().";
-	    O2SCL_ERR(str.c_str(),exc_efailed);
-	  }
-	  line.push_back(thisbm);
-	}
+    }
+    // End of parallel region
+    
+    for(size_t it=0;it<nt;it++) {
+      if (errors[it].length()>0) {
+	O2SCL_ERR(errors[it].c_str(),exc_efailed);
       }
     }
 
-    // --------------------------------------------------------------
-    // Copy line of data to table
+    // ---------------------------------------------------------------
+    // Merge the rows in order
     
-    out_table->line_of_data(line.size(),&(line[0]));
-    if (line.size()!=out_table->get_ncolumns()) {
-      O2SCL_ERR("Table size problem in tov_solve::mvsr().",
-		exc_esanity);
+    for(size_t it=0;it<nt;it++) {
+      size_t i_start=it*npr/nt;
+      for(size_t k=0;k<lines[it].size();k++) {
+	std::vector<double> &line=lines[it][k];
+	if (rets[it][k]!=0 && info==0) {
+	  O2SCL_CONV((((string)"Integration of star with central ")+
+		      "pressure "+dtos(pr_vals[i_start+k])+
+		      " failed in mvsr().").c_str(),exc_efailed,
+		     err_nonconv);
+	  info+=mvsr_integ_star_failed+rets[it][k];
+	}
+	if (verbose>0) {
+	  cout.precision(4);
+	  cout << "Central P: " << pr_vals[i_start+k]
+	       << " (Msun/km^3), M: " << line[0] << " (Msun), R: "
+	       << line[1] << " (km)" << endl;
+	  cout.precision(6);
+	}
+	out_table->line_of_data(line.size(),&(line[0]));
+	if (line.size()!=out_table->get_ncolumns()) {
+	  O2SCL_ERR("Table size problem in tov_solve::mvsr().",
+		    exc_esanity);
+	}
+      }
     }
-    
-    // --------------------------------------------------------------
-    // Get next central pressure
-
-    x[0]*=princ;
 
+    // ---------------------------------------------------------------
+    // Copy the profile of the last star, as in the serial case
+
+    tov_solve &last=*workers[nt-1];
+    rkx=last.rkx;
+    rky=last.rky;
+    rkdydx=last.rkdydx;
+    ix_last=last.ix_last;
+    mass=last.mass;
+    rad=last.rad;
+    bmass=last.bmass;
+    gpot=last.gpot;
+    last_rjw=last.last_rjw;
+    last_f=last.last_f;
+    domega_rat=last.domega_rat;
   }
 
   // Find the row that refers to the maximum mass star
@@ -997,6 +1161,56 @@ int tov_solve::mvsr() {
   return info;
 }
 
+void tov_solve::copy_settings(const tov_solve &ts) {
+  
+  te=ts.te;
+  eos_set=ts.eos_set;
+
+  eunits=ts.eunits;
+  punits=ts.punits;
+  nunits=ts.nunits;
+  efactor=ts.efactor;
+  pfactor=ts.pfactor;
+  nfactor=ts.nfactor;
+
+  min_log_pres=ts.min_log_pres;
+  buffer_size=ts.buffer_size;
+  max_table_size=ts.max_table_size;
+  pcent_max=ts.pcent_max;
+  tmass=ts.tmass;
+  
+  baryon_mass=ts.baryon_mass;
+  ang_vel=ts.ang_vel;
+  gen_rel=ts.gen_rel;
+  calc_gpot=ts.calc_gpot;
+  step_min=ts.step_min;
+  step_max=ts.step_max;
+  step_start=ts.step_start;
+  verbose=ts.verbose;
+  max_integ_steps=ts.max_integ_steps;
+  err_nonconv=ts.err_nonconv;
+  warm_start=ts.warm_start;
+  pmax_default=ts.pmax_default;
+  pr_list=ts.pr_list;
+  reformat_results=ts.reformat_results;
+
+  prbegin=ts.prbegin;
+  prend=ts.prend;
+  princ=ts.princ;
+  fixed_pr_guess=ts.fixed_pr_guess;
+  max_begin=ts.max_begin;
+  max_end=ts.max_end;
+  max_inc=ts.max_inc;
+
+  // The stepper itself cannot be shared between threads, so only
+  // the settings of the default stepper are copied. The function
+  // mvsr() uses only one thread if a different stepper is selected.
+  def_stepper.con=ts.def_stepper.con;
+  def_stepper.verbose=ts.def_stepper.verbose;
+  
+  return;
+}
+
 int tov_solve::max() {
   
   int info=0;
@@ -486,6 +486,29 @@ namespace o2scl {
      */
     virtual int integ_star(size_t ndvar, const ubvector &ndx, 
 			ubvector &ndy);
+
+    /** \brief Integrate the star with central pressure \c pcent
+	and fill one row of the \ref mvsr() table in \c line
+	
+	The return value is the value returned by \ref integ_star().
+     */
+    int mvsr_row(double pcent, std::vector<double> &line);
+
+    /** \brief Copy the numerical and unit parameters from \c ts
+	(used to set up the threads in \ref mvsr())
+     */
+    void copy_settings(const tov_solve &ts);
+
+    /** \brief The initial step size from the previous star, used
+	when \ref warm_start is true (zero if there is none)
+     */
+    double warm_step;
+
+    /// The EOS objects for each thread in \ref mvsr()
+    std::vector<eos_tov *> thread_eos;
+
+    /// The EOS search state used in \ref derivs()
+    eos_tov_accel eos_acc;
     
 #endif
 
@@ -569,6 +592,18 @@ namespace o2scl {
 	not converge (default true)
     */
     bool err_nonconv;
+    /** \brief If true, reuse the adaptive step size from the 
+	previous step instead of restarting with \ref step_start
+	(default false)
+
+	When this is true, the step size is carried from one step to
+	the next in \ref integ_star(), and each star in \ref mvsr()
+	begins with the initial step size chosen for the previous
+	(neighboring) star. This reduces the number of rejected
+	steps, but it changes the radial grid so the results are
+	not identical to those with the default setting.
+    */
+    bool warm_start;
     //@}
 
     /** \brief Default value of maximum pressure for maximum mass star
@@ -600,6 +635,28 @@ namespace o2scl {
 	<tt>r0, gm0, bm0, r1, gm1, bm1,</tt> etc.
     */
     std::vector<double> pr_list;
+    /** \brief Number of OpenMP threads for \ref mvsr() (default 1)
+
+	If this is greater than one, the central pressures are divided
+	into contiguous blocks, one for each thread. Each thread uses
+	a separate copy of the solver with its own stepper and
+	integration storage, and the rows are added to the table in
+	order of increasing central pressure. The threads share the
+	EOS object unless separate objects are given with \ref
+	set_thread_eos(). If the EOS is shared and \ref
+	eos_tov::is_thread_safe() is false, only one thread is used.
+	Threads are only used if the default adaptive stepper
+	(\ref def_stepper) is selected and it uses its default ODE
+	stepper, and only its control parameters (\ref
+	astep_gsl::con) and verbosity are copied to the threads.
+	After \ref mvsr() returns, the profile information (e.g. \ref
+	get_rkx()) refers to the last star as in the serial case.
+	If \ref warm_start is true, the first star in each block
+	begins with \ref step_start rather than the step size from the
+	neighboring star. The radial grid, and thus the results, then
+	differ slightly from the serial calculation.
+    */
+    size_t n_threads;
     //@}
 
     /// \name Fixed mass parameter
@@ -638,6 +695,22 @@ namespace o2scl {
       return;
     }
 
+    /** \brief Set a separate EOS object for each thread in 
+	\ref mvsr()
+
+	This is only necessary if the EOS object given in \ref
+	set_eos() cannot be safely used by several threads at once
+	(see \ref eos_tov::is_thread_safe()).
+	Thread \c i uses <tt>eos_list[i]</tt>, and the EOS from \ref
+	set_eos() is used by any thread which does not have an entry
+	in the list. Call this function with an empty vector to
+	share the EOS among all threads.
+    */
+    void set_thread_eos(std::vector<eos_tov *> &eos_list) {
+      thread_eos=eos_list;
+      return;
+    }
+
     /** \brief Set output units for the table
      */
     void set_units(double s_efactor=1.0, double s_pfactor=1.0, 
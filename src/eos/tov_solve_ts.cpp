@@ -83,6 +83,27 @@ public:
   
 };
 
+/** \brief A linear EOS which counts the number of calls
+ */
+class eos_tov_linear_count : public eos_tov_linear {
+  
+public:
+
+  eos_tov_linear_count() {
+    count=0;
+  }
+  
+  /// The number of calls to ed_nb_from_pr()
+  size_t count;
+  
+  virtual void ed_nb_from_pr(double pr, double &ed, double &nb) {
+    count++;
+    eos_tov_linear::ed_nb_from_pr(pr,ed,nb);
+    return;
+  }
+  
+};
+
 int main(void) {
 
   cout.setf(ios::scientific);
@@ -387,6 +408,50 @@ int main(void) {
   }
   cout << endl;
 
+  // --------------------------------------------------------------
+  // Test threaded and warm-started mass-radius curves
+
+  cout << "----------------------------------------------------" << endl;
+  cout << "Linear EOS, threads and warm start: " << endl;
+
+  lin.set_cs2_eps0(1.0/3.0,1.0e-4);
+  at.verbose=0;
+  at.mvsr();
+  size_t nl_serial=tab->get_nlines();
+  double gm_serial=tab->max("gm");
+  double r_serial=tab->get("r",nl_serial/2);
+
+  // Give each thread its own EOS object so that we can verify
+  // that all of the threads were used. This test fails if OpenMP
+  // is not enabled.
+  std::vector<eos_tov_linear_count> lin_thr(3);
+  std::vector<eos_tov *> thr_eos(3);
+  for(size_t it=0;it<3;it++) {
+    lin_thr[it].set_cs2_eps0(1.0/3.0,1.0e-4);
+    thr_eos[it]=&lin_thr[it];
+  }
+  at.set_thread_eos(thr_eos);
+  at.n_threads=3;
+  info=at.mvsr();
+  t.test_gen(info==0,"threaded mvsr");
+  t.test_gen(lin_thr[0].count>0 && lin_thr[1].count>0 &&
+	     lin_thr[2].count>0,"threaded mvsr used all threads");
+  t.test_gen(tab->get_nlines()==nl_serial,"threaded nlines");
+  t.test_rel(tab->max("gm"),gm_serial,1.0e-14,"threaded max gm");
+  t.test_rel(tab->get("r",nl_serial/2),r_serial,1.0e-14,"threaded r");
+  at.n_threads=1;
+  thr_eos.clear();
+  at.set_thread_eos(thr_eos);
+
+  at.warm_start=true;
+  info=at.mvsr();
+  t.test_gen(info==0,"warm start mvsr");
+  t.test_rel(tab->max("gm"),2.880345e-2/sqrt(1.0e-4),4.0e-4,
+	     "warm start max gm");
+  t.test_rel(tab->get("r",nl_serial/2),r_serial,1.0e-4,"warm start r");
+  at.warm_start=false;
+  cout << endl;
+
   t.report();
 
   return 0;
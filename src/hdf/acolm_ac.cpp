@@ -29,6 +29,10 @@
 #include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace o2scl;
 using namespace o2scl_hdf;
@@ -211,12 +215,12 @@ int acol_manager::comm_autocorr(std::vector<std::string> &sv,
       for(size_t i=1;i<sv.size();i++) in.push_back(sv[i]);
     }
 
-    vector<vector<double> > ac_all;
+    vector<vector<double> > v_all, ac_all;
     size_t max_ac_size=0;
     
     for(size_t ix=2;ix<in.size();ix++) {
       
-      vector<double> v, ac, ftom;
+      vector<double> v;
 
       // If the argument is not a vector specification, then look
       // for the column in the table
@@ -240,9 +244,23 @@ int acol_manager::comm_autocorr(std::vector<std::string> &sv,
 	  return 1;
 	}
       }
+
+      v_all.push_back(v);
+    }
+
+    // Compute the autocorrelation vectors for all of the data sets
+    size_t n_threads=1;
+#ifdef O2SCL_OPENMP
+    n_threads=omp_get_max_threads();
+#endif
+    vector_autocorr_vectors(v_all,ac_all,n_threads);
+    
+    for(size_t ix=0;ix<ac_all.size();ix++) {
+      
+      vector<double> &ac=ac_all[ix];
+      vector<double> ftom;
       
       // Compute autocorrelation length and sample size
-      vector_autocorr_vector(v,ac);
       size_t len=vector_autocorr_tau(ac,ftom);
       if (len>0) {
 	cout << "Autocorrelation length: " << len << " sample size: "
@@ -251,10 +269,9 @@ int acol_manager::comm_autocorr(std::vector<std::string> &sv,
 	cout << "Autocorrelation length determination failed." << endl;
       }
 
-      if (ix==2 || ac.size()>max_ac_size) {
+      if (ix==0 || ac.size()>max_ac_size) {
 	max_ac_size=ac.size();
       }
-      ac_all.push_back(ac);
     }
 
     if (max_ac_size==0) {
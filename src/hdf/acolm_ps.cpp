@@ -1241,9 +1241,15 @@ int acol_manager::comm_set_data(std::vector<std::string> &sv, bool itive_com) {
     return exc_efailed;
   }
 
+  // Compile and evaluate both functions once for all rows
+  std::vector<char> mask;
+  table_obj.row_mask(in[0],mask);
+  std::vector<double> vals;
+  table_obj.function_vector(in[2],vals);
+  
   for(size_t i=0;i<table_obj.get_nlines();i++) {
-    if (table_obj.row_function(in[0],i)>0.5) {
-      table_obj.set(in[1],i,table_obj.row_function(in[2],i));
+    if (mask[i]) {
+      table_obj.set(in[1],i,vals[i]);
     }
   }
 
@@ -2062,82 +2068,13 @@ int acol_manager::comm_select_rows2(std::vector<std::string> &sv,
     return exc_efailed;
   }
     
-  // ---------------------------------------------------------------------
-  // Create new table
-  // ---------------------------------------------------------------------
-  
-  table_units<> new_table;
-  
-  // ---------------------------------------------------------------------
-  // Copy constants from old to new table
-  // ---------------------------------------------------------------------
-
-  for(size_t i=0;i<table_obj.get_nconsts();i++) {
-    string tnam;
-    double tval;
-    table_obj.get_constant(i,tnam,tval);
-    new_table.add_constant(tnam,tval);
-  }
-  
-  // ---------------------------------------------------------------------
-  // Add column names to new table
-  // ---------------------------------------------------------------------
-
-  for(int i=0;i<((int)table_obj.get_ncolumns());i++) {
-    new_table.new_column(table_obj.get_column_name(i));
-  }
-
-  // ---------------------------------------------------------------------
-  // Copy data from selected rows
-  // ---------------------------------------------------------------------
-
-  calculator calc;
-  calc.compile(i1.c_str(),0);
-  
-  vector<string> cols=calc.get_var_list();
-  std::map<std::string,double> vars;
-
-  int new_lines=0;
-  for(int i=0;i<((int)table_obj.get_nlines());i++) {
-    
-    if (verbose>0 && i%10000==0) {
-      std::cout << "Finished " << i << " of "
-		<< table_obj.get_nlines() << " lines." << endl;
-    }
-    
-    for(size_t j=0;j<cols.size();j++) {
-      vars[cols[j]]=table_obj.get(cols[j],i);
-    }
-    
-    //calc.compile(i1.c_str(),&vars);
-    if (calc.eval(&vars)>0.5) {
-      
-      // It is important to use set_nlines_auto() here because it
-      // increases the table size fast enough to avoid poor scaling
-      new_table.set_nlines_auto(new_lines+1);
-
-      // Trivially parallize the assignment over all columns
-#ifdef O2SCL_OPENMP
-#pragma omp parallel
-#endif
-      {
-#ifdef O2SCL_OPENMP
-#pragma omp for
-#endif
-	for(int j=0;j<((int)table_obj.get_ncolumns());j++) {
-	  new_table.set(j,new_lines,table_obj.get(j,i));
-	}
-	
-	// End of parallel region
-      }
-      
-      new_lines++;
-    }
+  // Compile the function once, evaluate it for all rows, and
+  // then compact the columns
+  size_t n_sel=table_obj.select_rows(i1);
+  if (verbose>0) {
+    cout << "Selected " << n_sel << " rows." << endl;
   }
   
-  // Swap the old table with the new one
-  std::swap(table_obj,new_table);
-  
   return 0;
 }
 
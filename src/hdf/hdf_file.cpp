@@ -1505,6 +1505,104 @@ int hdf_file::setc_arr(std::string name, size_t n, const char *c) {
   return 0;
 }
 
+int hdf_file::setd_arr_part(std::string name, size_t offset, size_t n,
+			    const double *d, size_t chunk_hint) {
+  
+  if (write_access==false) {
+    O2SCL_ERR2("File not opened with write access in ",
+	       "hdf_file::setd_arr_part().",exc_efailed);
+  }
+
+  hid_t dset, space, dcpl=0;
+  bool chunk_alloc=false;
+  hsize_t new_dims=offset+n;
+
+  H5E_BEGIN_TRY
+    {
+      // See if the dataspace already exists first
+      dset=H5Dopen(current,name.c_str(),H5P_DEFAULT);
+    } 
+  H5E_END_TRY 
+#ifdef O2SCL_NEVER_DEFINED
+    {
+    }
+#endif
+      
+  // If it doesn't exist, create it
+  if (dset<0) {
+    
+    // Create the dataspace
+    hsize_t max=H5S_UNLIMITED;
+    space=H5Screate_simple(1,&new_dims,&max);
+
+    // Set chunk with size determined by def_chunk()
+    dcpl=H5Pcreate(H5P_DATASET_CREATE);
+    size_t nchunk=offset+n;
+    if (chunk_hint>nchunk) nchunk=chunk_hint;
+    hsize_t chunk=def_chunk(nchunk);
+    int status2=H5Pset_chunk(dcpl,1,&chunk);
+
+#ifdef O2SCL_HDF5_COMP    
+    if (nchunk>=min_compr_size) {
+      // Compression part
+      if (compr_type==1) {
+	int status3=H5Pset_deflate(dcpl,6);
+      } else if (compr_type==2) {
+	int status3=H5Pset_szip(dcpl,H5_SZIP_NN_OPTION_MASK,16);
+      } else if (compr_type!=0) {
+	O2SCL_ERR2("Invalid compression type in ",
+		   "hdf_file::setd_arr_part().",exc_einval);
+      }
+    }
+#endif
+
+    // Create the dataset
+    dset=H5Dcreate(current,name.c_str(),H5T_IEEE_F64LE,space,H5P_DEFAULT,
+		   dcpl,H5P_DEFAULT);
+    chunk_alloc=true;
+
+  } else {
+    
+    // Get current dimensions
+    space=H5Dget_space(dset);  
+    hsize_t dims;
+    int ndims=H5Sget_simple_extent_dims(space,&dims,0);
+
+    // Set error if this dataset is more than 1-dimensional
+    if (ndims!=1) {
+      O2SCL_ERR2("Tried to set a multidimensional dataset with an ",
+		 "array in hdf_file::setd_arr_part().",exc_einval);
+    }
+
+    // If necessary, resize the dataset and obtain the new dataspace
+    if (new_dims!=dims) {
+      int status3=H5Dset_extent(dset,&new_dims);
+      H5Sclose(space);
+      space=H5Dget_space(dset);
+    }
+    
+  }
+
+  // Write only the requested elements
+  int status;
+  if (n>0) {
+    hsize_t start=offset, count=n;
+    status=H5Sselect_hyperslab(space,H5S_SELECT_SET,&start,0,&count,0);
+    hid_t mem_space=H5Screate_simple(1,&count,0);
+    status=H5Dwrite(dset,H5T_NATIVE_DOUBLE,mem_space,
+		    space,H5P_DEFAULT,d);
+    H5Sclose(mem_space);
+  }
+  
+  status=H5Dclose(dset);
+  status=H5Sclose(space);
+  if (chunk_alloc) {
+    status=H5Pclose(dcpl);
+  }
+      
+  return 0;
+}
+
 int hdf_file::setd_arr(std::string name, size_t n, const double *d) {
   
   if (write_access==false) {
@@ -984,6 +984,19 @@ namespace o2scl_hdf {
 
     /// Set a integer array named \c name of size \c n to value \c i
     int set_szt_arr(std::string name, size_t n, const size_t *u);
+
+    /** \brief Set elements \c offset through <tt>offset+n-1</tt> of
+	the double array named \c name to the values in \c d
+
+	The dataset is resized to have exactly <tt>offset+n</tt>
+	elements, and elements before \c offset which are already
+	present in the file are not modified, so a long array can be
+	written incrementally. If the dataset is not present, it is
+	created with a chunk size given by \ref def_chunk() applied
+	to the larger of <tt>offset+n</tt> and \c chunk_hint. 
+    */
+    int setd_arr_part(std::string name, size_t offset, size_t n,
+		      const double *d, size_t chunk_hint=0);
     //@}
 
     /** \name Fixed-length array set functions
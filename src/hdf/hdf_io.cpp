@@ -356,6 +356,79 @@ void o2scl_hdf::hdf_output(hdf_file &hf, o2scl::table_units<> &t,
   return;
 }
 
+void o2scl_hdf::hdf_output_rows(hdf_file &hf, o2scl::table_units<> &t, 
+				std::string name, size_t row_start,
+				size_t chunk_hint) {
+
+  if (hf.has_write_access()==false) {
+    O2SCL_ERR2("File not opened with write access in hdf_output_rows",
+	       "(hdf_file,table_units<>,string,size_t,size_t).",
+	       exc_efailed);
+  }
+
+  size_t nlines=t.get_nlines();
+  if (row_start>nlines) row_start=nlines;
+
+  // Start group
+  hid_t top=hf.get_current_id();
+  hid_t group=hf.open_group(name);
+  hf.set_current_id(group);
+      
+  // Add typename
+  hf.sets_fixed("o2scl_type","table");
+
+  // Restructure and output constants
+  std::vector<std::string> cnames, cols, units;
+  std::vector<double> cvalues;
+  for(size_t i=0;i<t.get_nconsts();i++) {
+    std::string cname;
+    double val;
+    t.get_constant(i,cname,val);
+    cnames.push_back(cname);
+    cvalues.push_back(val);
+  }
+  hf.sets_vec("con_names",cnames);
+  hf.setd_vec("con_values",cvalues);
+      
+  // Restructure and output column names and units
+  for(size_t i=0;i<t.get_ncolumns();i++) {
+    cols.push_back(t.get_column_name(i));
+    units.push_back(t.get_unit(t.get_column_name(i)));
+  }
+  hf.sets_vec("col_names",cols);
+  hf.seti("unit_flag",1);
+  hf.sets_vec("units",units);
+      
+  // Output number of lines and the interpolation type
+  hf.seti("nlines",((int)nlines));
+  hf.set_szt("itype",t.get_interp_type());
+      
+  // Create data group
+  hid_t group2=hf.open_group("data");
+  hf.set_current_id(group2);
+      
+  // Output the new rows, resizing each column in the file
+  // to the current number of lines
+  for(size_t i=0;i<t.get_ncolumns();i++) {
+    const std::vector<double> &col=t.get_column(t.get_column_name(i));
+    const double *ptr=0;
+    if (nlines>row_start) ptr=&(col[row_start]);
+    hf.setd_arr_part(t.get_column_name(i),row_start,nlines-row_start,
+		     ptr,chunk_hint);
+  }
+
+  // Close data group
+  hf.close_group(group2);
+
+  // Close table_units group
+  hf.close_group(group);
+      
+  // Return location to previous value
+  hf.set_current_id(top);
+
+  return;
+}
+
 void o2scl_hdf::hdf_output_data(hdf_file &hf, o2scl::table_units<> &t) {
       
   // Output base table object
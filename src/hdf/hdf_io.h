@@ -261,6 +261,22 @@ namespace o2scl_hdf {
   void hdf_output(hdf_file &hf, o2scl::table_units<> &t, 
 		  std::string name);
 
+  /** \brief Output a \ref o2scl::table_units object to a \ref
+      hdf_file, writing only the rows starting with \c row_start
+
+      This produces the same group as \ref hdf_output(), but
+      assumes that rows before \c row_start are already present
+      in the file and unchanged, so that a growing table can be
+      written incrementally. The table metadata (constants, column
+      names, units, and number of lines) is always rewritten. If the
+      column datasets do not exist yet, they are created with
+      a chunk size based on \c chunk_hint (see \ref
+      hdf_file::setd_arr_part()).
+  */
+  void hdf_output_rows(hdf_file &hf, o2scl::table_units<> &t, 
+		       std::string name, size_t row_start,
+		       size_t chunk_hint=0);
+
   /** \brief Input a \ref o2scl::table_units object from a \ref hdf_file
 
       \comment
@@ -0,0 +1,596 @@
+/*
+  -------------------------------------------------------------------
+
+  Copyright (C) 2006-2021, Andrew W. Steiner
+
+  This file is part of O2scl.
+
+  O2scl is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  O2scl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with O2scl. If not, see <http://www.gnu.org/licenses/>.
+
+  -------------------------------------------------------------------
+*/
+#include <vector>
+#include <algorithm>
+
+#include <o2scl/cblas.h>
+
+using namespace std;
+using namespace o2scl_cblas;
+
+typedef boost::numeric::ublas::matrix<double> ubmatrix;
+typedef boost::numeric::ublas::matrix
+<double,boost::numeric::ublas::row_major,std::vector<double> > ubmatrix_vec;
+
+namespace {
+
+  /// \name Block sizes for the packed matrix multiplication
+  //@{
+  /// Rows in the register block
+  const size_t gemm_mr=4;
+  /// Columns in the register block
+  const size_t gemm_nr=8;
+  /// Rows of A in a packed block (multiple of gemm_mr)
+  const size_t gemm_mc=128;
+  /// Inner dimension of a packed block
+  const size_t gemm_kc=256;
+  /// Columns of B in a packed block (multiple of gemm_nr)
+  const size_t gemm_nc=2048;
+  /// Triangular block size for dtrsm() and dsyrk()
+  const size_t gemm_nb=128;
+  /// Size of the diagonal tiles computed in full in dsyrk()
+  const size_t syrk_sb=32;
+  //@}
+
+  /** \brief Return a pointer to the first element of the
+      row-major matrix \c m or zero if the matrix is empty
+   */
+  template<class mat_t> inline const double *ub_ptr(const mat_t &m) {
+    if (m.size1()==0 || m.size2()==0) return 0;
+    return &m(0,0);
+  }
+
+  /// Non-const version of ub_ptr()
+  template<class mat_t> inline double *ub_ptr(mat_t &m) {
+    if (m.size1()==0 || m.size2()==0) return 0;
+    return &m(0,0);
+  }
+
+  /** \brief Element <tt>(i,j)</tt> of \f$ \mathrm{op}(X) \f$ for a
+      row-major array \c x with leading dimension \c ld
+  */
+  inline double op_elem(bool trans, const double *x, size_t ld,
+			size_t i, size_t j) {
+    if (trans) return x[j*ld+i];
+    return x[i*ld+j];
+  }
+
+  /** \brief Pointer to element <tt>(i,j)</tt> of \f$ \mathrm{op}(X)
+      \f$, to be used with the same value of \c trans
+  */
+  inline const double *op_ptr(bool trans, const double *x, size_t ld,
+			      size_t i, size_t j) {
+    if (trans) return x+j*ld+i;
+    return x+i*ld+j;
+  }
+
+  /** \brief Pack rows <tt>[0,mc)</tt> and columns <tt>[0,kc)</tt>
+      of \f$ \mathrm{op}(A) \f$ into panels of \c gemm_mr rows,
+      padding with zeros
+  */
+  void pack_a(bool trans, size_t mc, size_t kc, const double *a,
+	      size_t lda, double *ap) {
+    for(size_t ir=0;ir<mc;ir+=gemm_mr) {
+      size_t mr=std::min(gemm_mr,mc-ir);
+      for(size_t p=0;p<kc;p++) {
+	for(size_t r=0;r<mr;r++) {
+	  ap[r]=op_elem(trans,a,lda,ir+r,p);
+	}
+	for(size_t r=mr;r<gemm_mr;r++) ap[r]=0.0;
+	ap+=gemm_mr;
+      }
+    }
+    return;
+  }
+
+  /** \brief Pack rows <tt>[0,kc)</tt> and columns <tt>[0,nc)</tt>
+      of \f$ \mathrm{op}(B) \f$ into panels of \c gemm_nr columns,
+      padding with zeros
+  */
+  void pack_b(bool trans, size_t kc, size_t nc, const double *b,
+	      size_t ldb, double *bp) {
+    for(size_t jr=0;jr<nc;jr+=gemm_nr) {
+      size_t nr=std::min(gemm_nr,nc-jr);
+      for(size_t p=0;p<kc;p++) {
+	if (trans) {
+	  for(size_t c=0;c<nr;c++) bp[c]=b[(jr+c)*ldb+p];
+	} else {
+	  const double *brow=b+p*ldb+jr;
+	  for(size_t c=0;c<nr;c++) bp[c]=brow[c];
+	}
+	for(size_t c=nr;c<gemm_nr;c++) bp[c]=0.0;
+	bp+=gemm_nr;
+      }
+    }
+    return;
+  }
+
+  /** \brief Multiply a packed panel of A by a packed panel of B
+      and add \c alpha times the result to the \c mr by \c nr
+      block of \c c
+  */
+  void gemm_kernel(size_t kc, const double *ap, const double *bp,
+		   double alpha, double *c, size_t ldc, size_t mr,
+		   size_t nr) {
+
+    double acc[gemm_mr][gemm_nr];
+    for(size_t r=0;r<gemm_mr;r++) {
+      for(size_t q=0;q<gemm_nr;q++) {
+	acc[r][q]=0.0;
+      }
+    }
+
+    for(size_t p=0;p<kc;p++) {
+      for(size_t r=0;r<gemm_mr;r++) {
+	double av=ap[r];
+	for(size_t q=0;q<gemm_nr;q++) {
+	  acc[r][q]+=av*bp[q];
+	}
+      }
+      ap+=gemm_mr;
+      bp+=gemm_nr;
+    }
+
+    for(size_t r=0;r<mr;r++) {
+      double *crow=c+r*ldc;
+      for(size_t q=0;q<nr;q++) {
+	crow[q]+=alpha*acc[r][q];
+      }
+    }
+
+    return;
+  }
+
+  /** \brief Compute \f$ C=C+\alpha \mathrm{op}(A) \mathrm{op}(B)
+      \f$ for row-major arrays, where \f$ C \f$ has \c m rows and
+      \c n columns and \c k is the inner dimension
+  */
+  void gemm_acc(bool ta, bool tb, size_t m, size_t n, size_t k,
+		double alpha, const double *a, size_t lda,
+		const double *b, size_t ldb, double *c, size_t ldc) {
+
+    if (m==0 || n==0 || k==0 || alpha==0.0) return;
+
+    // For small matrices, packing is not worth the overhead
+    if (m*n*k<=32768) {
+      for(size_t i=0;i<m;i++) {
+	double *crow=c+i*ldc;
+	for(size_t p=0;p<k;p++) {
+	  double temp=alpha*op_elem(ta,a,lda,i,p);
+	  if (temp!=0.0) {
+	    if (tb) {
+	      for(size_t j=0;j<n;j++) crow[j]+=temp*b[j*ldb+p];
+	    } else {
+	      const double *brow=b+p*ldb;
+	      for(size_t j=0;j<n;j++) crow[j]+=temp*brow[j];
+	    }
+	  }
+	}
+      }
+      return;
+    }
+
+    size_t nc_max=std::min(gemm_nc,((n+gemm_nr-1)/gemm_nr)*gemm_nr);
+    std::vector<double> bp(gemm_kc*nc_max);
+
+    for(size_t jc=0;jc<n;jc+=gemm_nc) {
+      size_t nc=std::min(gemm_nc,n-jc);
+
+      for(size_t pc=0;pc<k;pc+=gemm_kc) {
+	size_t kc=std::min(gemm_kc,k-pc);
+
+	pack_b(tb,kc,nc,op_ptr(tb,b,ldb,pc,jc),ldb,&bp[0]);
+
+	size_t n_blocks=(m+gemm_mc-1)/gemm_mc;
+
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for schedule(dynamic) if (m*nc*kc>1000000)
+#endif
+	for(size_t ib=0;ib<n_blocks;ib++) {
+	  size_t ic=ib*gemm_mc;
+	  size_t mc=std::min(gemm_mc,m-ic);
+	  std::vector<double> ap(gemm_mc*gemm_kc);
+	  pack_a(ta,mc,kc,op_ptr(ta,a,lda,ic,pc),lda,&ap[0]);
+
+	  for(size_t jr=0;jr<nc;jr+=gemm_nr) {
+	    size_t nr=std::min(gemm_nr,nc-jr);
+	    for(size_t ir=0;ir<mc;ir+=gemm_mr) {
+	      size_t mr=std::min(gemm_mr,mc-ir);
+	      gemm_kernel(kc,&ap[ir*kc],&bp[jr*kc],alpha,
+			  c+(ic+ir)*ldc+jc+jr,ldc,mr,nr);
+	    }
+	  }
+	}
+      }
+    }
+
+    return;
+  }
+
+  /** \brief Solve \f$ T X = B \f$ in place for the \c n by \c n
+      diagonal block of a triangular matrix and \c n2 columns of
+      \f$ B \f$
+  */
+  void trsm_left_block(bool lower, bool ta, bool nonunit, size_t n,
+		       size_t n2, const double *a, size_t lda,
+		       double *b, size_t ldb) {
+    if (lower) {
+      for(size_t i=0;i<n;i++) {
+	double *bi=b+i*ldb;
+	for(size_t k=0;k<i;k++) {
+	  double tik=op_elem(ta,a,lda,i,k);
+	  const double *bk=b+k*ldb;
+	  for(size_t j=0;j<n2;j++) bi[j]-=tik*bk[j];
+	}
+	if (nonunit) {
+	  double tii=op_elem(ta,a,lda,i,i);
+	  for(size_t j=0;j<n2;j++) bi[j]/=tii;
+	}
+      }
+    } else {
+      for(size_t i=n;i>0 && i--;) {
+	double *bi=b+i*ldb;
+	for(size_t k=i+1;k<n;k++) {
+	  double tik=op_elem(ta,a,lda,i,k);
+	  const double *bk=b+k*ldb;
+	  for(size_t j=0;j<n2;j++) bi[j]-=tik*bk[j];
+	}
+	if (nonunit) {
+	  double tii=op_elem(ta,a,lda,i,i);
+	  for(size_t j=0;j<n2;j++) bi[j]/=tii;
+	}
+      }
+    }
+    return;
+  }
+
+  /** \brief Solve \f$ X T = B \f$ in place for the \c n by \c n
+      diagonal block of a triangular matrix and \c n1 rows of
+      \f$ B \f$
+  */
+  void trsm_right_block(bool lower, bool ta, bool nonunit, size_t n1,
+			size_t n, const double *a, size_t lda,
+			double *b, size_t ldb) {
+    for(size_t i=0;i<n1;i++) {
+      double *bi=b+i*ldb;
+      if (lower) {
+	for(size_t j=n;j>0 && j--;) {
+	  for(size_t k=j+1;k<n;k++) {
+	    bi[j]-=bi[k]*op_elem(ta,a,lda,k,j);
+	  }
+	  if (nonunit) bi[j]/=op_elem(ta,a,lda,j,j);
+	}
+      } else {
+	for(size_t j=0;j<n;j++) {
+	  for(size_t k=0;k<j;k++) {
+	    bi[j]-=bi[k]*op_elem(ta,a,lda,k,j);
+	  }
+	  if (nonunit) bi[j]/=op_elem(ta,a,lda,j,j);
+	}
+      }
+    }
+    return;
+  }
+
+  /** \brief Blocked version of \ref o2scl_cblas::dgemm() for
+      contiguous row-major matrices
+  */
+  template<class mat_t>
+  void dgemm_rm(const enum o2cblas_order Order,
+		const enum o2cblas_transpose TransA,
+		const enum o2cblas_transpose TransB, const size_t M,
+		const size_t N, const size_t K, const double alpha,
+		const mat_t &A, const mat_t &B, const double beta,
+		mat_t &C) {
+
+    if (alpha==0.0 && beta==1.0) return;
+    if (M==0 || N==0) return;
+
+    // In the column-major case, the matrix objects hold the
+    // transposes, so compute C^T = op(B)^T op(A)^T instead
+    bool ta=(TransA!=o2cblas_NoTrans);
+    bool tb=(TransB!=o2cblas_NoTrans);
+    size_t m=M, n=N;
+    const mat_t *F=&A, *G=&B;
+    if (Order==o2cblas_ColMajor) {
+      m=N;
+      n=M;
+      F=&B;
+      G=&A;
+      std::swap(ta,tb);
+    }
+
+    double *c=ub_ptr(C);
+    size_t ldc=C.size2();
+
+    if (beta==0.0) {
+      for(size_t i=0;i<m;i++) {
+	for(size_t j=0;j<n;j++) c[i*ldc+j]=0.0;
+      }
+    } else if (beta!=1.0) {
+      for(size_t i=0;i<m;i++) {
+	for(size_t j=0;j<n;j++) c[i*ldc+j]*=beta;
+      }
+    }
+
+    if (alpha==0.0 || K==0) return;
+
+    gemm_acc(ta,tb,m,n,K,alpha,ub_ptr(*F),F->size2(),
+	     ub_ptr(*G),G->size2(),c,ldc);
+
+    return;
+  }
+
+  /** \brief Blocked version of \ref o2scl_cblas::dtrsm() for
+      contiguous row-major matrices
+  */
+  template<class mat_t>
+  void dtrsm_rm(const enum o2cblas_order Order,
+		const enum o2cblas_side Side,
+		const enum o2cblas_uplo Uplo,
+		const enum o2cblas_transpose TransA,
+		const enum o2cblas_diag Diag, const size_t M,
+		const size_t N, const double alpha, const mat_t &A,
+		mat_t &B) {
+
+    size_t n1, n2;
+    bool left, upper;
+    bool ta=(TransA!=o2cblas_NoTrans);
+    bool nonunit=(Diag==o2cblas_NonUnit);
+
+    if (Order==o2cblas_RowMajor) {
+      n1=M;
+      n2=N;
+      left=(Side==o2cblas_Left);
+      upper=(Uplo==o2cblas_Upper);
+    } else {
+      n1=N;
+      n2=M;
+      left=(Side!=o2cblas_Left);
+      upper=(Uplo!=o2cblas_Upper);
+    }
+    if (n1==0 || n2==0) return;
+
+    const double *a=ub_ptr(A);
+    size_t lda=A.size2();
+    double *b=ub_ptr(B);
+    size_t ldb=B.size2();
+
+    if (alpha!=1.0) {
+      for(size_t i=0;i<n1;i++) {
+	for(size_t j=0;j<n2;j++) b[i*ldb+j]*=alpha;
+      }
+    }
+
+    // The triangular matrix is T=op(A), which is lower triangular if
+    // A is lower triangular and not transposed or upper triangular and
+    // transposed
+    bool lower=(upper==ta);
+
+    if (left) {
+
+      // Solve T X = B, with T of size n1 by n1
+      if (lower) {
+	for(size_t ib=0;ib<n1;ib+=gemm_nb) {
+	  size_t nb=std::min(gemm_nb,n1-ib);
+	  trsm_left_block(true,ta,nonunit,nb,n2,op_ptr(ta,a,lda,ib,ib),
+			lda,b+ib*ldb,ldb);
+	  if (ib+nb<n1) {
+	    gemm_acc(ta,false,n1-ib-nb,n2,nb,-1.0,
+		   op_ptr(ta,a,lda,ib+nb,ib),lda,b+ib*ldb,ldb,
+		   b+(ib+nb)*ldb,ldb);
+	  }
+	}
+      } else {
+	size_t n_blocks=(n1+gemm_nb-1)/gemm_nb;
+	for(size_t kb=n_blocks;kb>0 && kb--;) {
+	  size_t ib=kb*gemm_nb;
+	  size_t nb=std::min(gemm_nb,n1-ib);
+	  trsm_left_block(false,ta,nonunit,nb,n2,op_ptr(ta,a,lda,ib,ib),
+			lda,b+ib*ldb,ldb);
+	  if (ib>0) {
+	    gemm_acc(ta,false,ib,n2,nb,-1.0,op_ptr(ta,a,lda,0,ib),lda,
+		   b+ib*ldb,ldb,b,ldb);
+	  }
+	}
+      }
+
+    } else {
+
+      // Solve X T = B, with T of size n2 by n2
+      if (lower) {
+	size_t n_blocks=(n2+gemm_nb-1)/gemm_nb;
+	for(size_t kb=n_blocks;kb>0 && kb--;) {
+	  size_t jb=kb*gemm_nb;
+	  size_t nb=std::min(gemm_nb,n2-jb);
+	  trsm_right_block(true,ta,nonunit,n1,nb,op_ptr(ta,a,lda,jb,jb),
+			 lda,b+jb,ldb);
+	  if (jb>0) {
+	    gemm_acc(false,ta,n1,jb,nb,-1.0,b+jb,ldb,
+		   op_ptr(ta,a,lda,jb,0),lda,b,ldb);
+	  }
+	}
+      } else {
+	for(size_t jb=0;jb<n2;jb+=gemm_nb) {
+	  size_t nb=std::min(gemm_nb,n2-jb);
+	  trsm_right_block(false,ta,nonunit,n1,nb,op_ptr(ta,a,lda,jb,jb),
+			 lda,b+jb,ldb);
+	  if (jb+nb<n2) {
+	    gemm_acc(false,ta,n1,n2-jb-nb,nb,-1.0,b+jb,ldb,
+		   op_ptr(ta,a,lda,jb,jb+nb),lda,b+jb+nb,ldb);
+	  }
+	}
+      }
+
+    }
+
+    return;
+  }
+
+  /** \brief Blocked version of \ref o2scl_cblas::dsyrk() for
+      contiguous row-major matrices
+  */
+  template<class mat_t>
+  void dsyrk_rm(const enum o2cblas_order Order,
+		const enum o2cblas_uplo Uplo,
+		const enum o2cblas_transpose Trans, const size_t N,
+		const size_t K, const double alpha, const mat_t &A,
+		const double beta, mat_t &C) {
+
+    if (alpha==0.0 && beta==1.0) return;
+    if (N==0) return;
+
+    bool upper, ta;
+    if (Order==o2cblas_RowMajor) {
+      upper=(Uplo==o2cblas_Upper);
+      ta=(Trans!=o2cblas_NoTrans);
+    } else {
+      upper=(Uplo!=o2cblas_Upper);
+      ta=(Trans==o2cblas_NoTrans);
+    }
+
+    const double *a=ub_ptr(A);
+    size_t lda=A.size2();
+    double *c=ub_ptr(C);
+    size_t ldc=C.size2();
+
+    if (beta!=1.0) {
+      for(size_t i=0;i<N;i++) {
+	size_t jmin=upper ? i : 0;
+	size_t jmax=upper ? N : i+1;
+	for(size_t j=jmin;j<jmax;j++) {
+	  if (beta==0.0) c[i*ldc+j]=0.0;
+	  else c[i*ldc+j]*=beta;
+	}
+      }
+    }
+
+    if (alpha==0.0 || K==0) return;
+
+    // C = alpha op(A) op(A)^T, where op(A) is N by K. The second factor
+    // is op(A)^T, which is op(A) read with the opposite transpose flag.
+    std::vector<double> tmp(syrk_sb*syrk_sb);
+
+    for(size_t ib=0;ib<N;ib+=gemm_nb) {
+      size_t mb=std::min(gemm_nb,N-ib);
+      const double *ai=op_ptr(ta,a,lda,ib,0);
+
+      size_t jb_min=upper ? ib+gemm_nb : 0;
+      size_t jb_max=upper ? N : ib;
+      for(size_t jb=jb_min;jb<jb_max;jb+=gemm_nb) {
+	size_t nb=std::min(gemm_nb,jb_max-jb);
+	gemm_acc(ta,!ta,mb,nb,K,alpha,ai,lda,op_ptr(ta,a,lda,jb,0),lda,
+		 c+ib*ldc+jb,ldc);
+      }
+
+      // The diagonal block is divided into smaller tiles. The tiles
+      // off the diagonal are added directly to C, and the diagonal
+      // tiles are computed in full and then the appropriate triangle
+      // is added to C
+      for(size_t is=0;is<mb;is+=syrk_sb) {
+	size_t ms=std::min(syrk_sb,mb-is);
+	const double *as=op_ptr(ta,a,lda,ib+is,0);
+
+	size_t js_min=upper ? is+syrk_sb : 0;
+	size_t js_max=upper ? mb : is;
+	if (js_min<js_max) {
+	  gemm_acc(ta,!ta,ms,js_max-js_min,K,alpha,as,lda,
+		   op_ptr(ta,a,lda,ib+js_min,0),lda,
+		   c+(ib+is)*ldc+ib+js_min,ldc);
+	}
+	
+	for(size_t i=0;i<ms*ms;i++) tmp[i]=0.0;
+	gemm_acc(ta,!ta,ms,ms,K,alpha,as,lda,as,lda,&tmp[0],ms);
+	for(size_t i=0;i<ms;i++) {
+	  size_t jmin=upper ? i : 0;
+	  size_t jmax=upper ? ms : i+1;
+	  for(size_t j=jmin;j<jmax;j++) {
+	    c[(ib+is+i)*ldc+ib+is+j]+=tmp[i*ms+j];
+	  }
+	}
+      }
+    }
+
+    return;
+  }
+
+}
+
+template<>
+void o2scl_cblas::dgemm<ubmatrix>
+(const enum o2cblas_order Order, const enum o2cblas_transpose TransA,
+ const enum o2cblas_transpose TransB, const size_t M, const size_t N,
+ const size_t K, const double alpha, const ubmatrix &A,
+ const ubmatrix &B, const double beta, ubmatrix &C) {
+  dgemm_rm(Order,TransA,TransB,M,N,K,alpha,A,B,beta,C);
+  return;
+}
+
+template<>
+void o2scl_cblas::dgemm<ubmatrix_vec>
+(const enum o2cblas_order Order, const enum o2cblas_transpose TransA,
+ const enum o2cblas_transpose TransB, const size_t M, const size_t N,
+ const size_t K, const double alpha, const ubmatrix_vec &A,
+ const ubmatrix_vec &B, const double beta, ubmatrix_vec &C) {
+  dgemm_rm(Order,TransA,TransB,M,N,K,alpha,A,B,beta,C);
+  return;
+}
+
+template<>
+void o2scl_cblas::dtrsm<ubmatrix>
+(const enum o2cblas_order Order, const enum o2cblas_side Side,
+ const enum o2cblas_uplo Uplo, const enum o2cblas_transpose TransA,
+ const enum o2cblas_diag Diag, const size_t M, const size_t N,
+ const double alpha, const ubmatrix &A, ubmatrix &B) {
+  dtrsm_rm(Order,Side,Uplo,TransA,Diag,M,N,alpha,A,B);
+  return;
+}
+
+template<>
+void o2scl_cblas::dtrsm<ubmatrix_vec>
+(const enum o2cblas_order Order, const enum o2cblas_side Side,
+ const enum o2cblas_uplo Uplo, const enum o2cblas_transpose TransA,
+ const enum o2cblas_diag Diag, const size_t M, const size_t N,
+ const double alpha, const ubmatrix_vec &A, ubmatrix_vec &B) {
+  dtrsm_rm(Order,Side,Uplo,TransA,Diag,M,N,alpha,A,B);
+  return;
+}
+
+template<>
+void o2scl_cblas::dsyrk<ubmatrix>
+(const enum o2cblas_order Order, const enum o2cblas_uplo Uplo,
+ const enum o2cblas_transpose Trans, const size_t N, const size_t K,
+ const double alpha, const ubmatrix &A, const double beta, ubmatrix &C) {
+  dsyrk_rm(Order,Uplo,Trans,N,K,alpha,A,beta,C);
+  return;
+}
+
+template<>
+void o2scl_cblas::dsyrk<ubmatrix_vec>
+(const enum o2cblas_order Order, const enum o2cblas_uplo Uplo,
+ const enum o2cblas_transpose Trans, const size_t N, const size_t K,
+ const double alpha, const ubmatrix_vec &A, const double beta,
+ ubmatrix_vec &C) {
+  dsyrk_rm(Order,Uplo,Trans,N,K,alpha,A,beta,C);
+  return;
+}
@@ -1082,6 +1082,102 @@ namespace o2scl_cblas {
     
     return;
   }
+
+  /** \brief Compute \f$ C=\alpha \mathrm{op}(A) \mathrm{op}(A)^{T} +
+      \beta C \f$ where \f$ C \f$ is symmetric
+
+      Only the triangle of C given in \c Uplo is referenced and
+      modified. If \c Trans is \c NoTrans, this function operates on
+      the first N rows and K columns of matrix A, and otherwise on
+      the first K rows and N columns of matrix A. In both cases, C
+      has N rows and N columns.
+
+      This function works for all values of \c Order, \c Uplo, and
+      \c Trans.
+  */
+  template<class mat_t>
+  void dsyrk(const enum o2cblas_order Order, 
+	     const enum o2cblas_uplo Uplo,
+	     const enum o2cblas_transpose Trans, const size_t N,
+	     const size_t K, const double alpha, const mat_t &A,
+	     const double beta, mat_t &C) {
+
+    size_t i, j, k;
+    int uplo, trans;
+
+    if (alpha == 0.0 && beta == 1.0) {
+      return;
+    }
+
+    if (Order == o2cblas_RowMajor) {
+      uplo = Uplo;
+      trans = (Trans == o2cblas_ConjTrans) ? o2cblas_Trans : Trans;
+    } else {
+      uplo = (Uplo == o2cblas_Upper) ? o2cblas_Lower : o2cblas_Upper;
+      trans = (Trans == o2cblas_NoTrans) ? o2cblas_Trans : o2cblas_NoTrans;
+    }
+
+    /* form  y := beta*y */
+    if (beta == 0.0) {
+      for (i = 0; i < N; i++) {
+	size_t jmin = (uplo == o2cblas_Upper) ? i : 0;
+	size_t jmax = (uplo == o2cblas_Upper) ? N : i+1;
+	for (j = jmin; j < jmax; j++) {
+	  O2SCL_IX2(C,i,j)=0.0;
+	}
+      }
+    } else if (beta != 1.0) {
+      for (i = 0; i < N; i++) {
+	size_t jmin = (uplo == o2cblas_Upper) ? i : 0;
+	size_t jmax = (uplo == o2cblas_Upper) ? N : i+1;
+	for (j = jmin; j < jmax; j++) {
+	  O2SCL_IX2(C,i,j)*=beta;
+	}
+      }
+    }
+
+    if (alpha == 0.0) {
+      return;
+    }
+
+    if (trans == o2cblas_NoTrans) {
+
+      /* form  C := alpha*A*A' + C */
+
+      for (i = 0; i < N; i++) {
+	size_t jmin = (uplo == o2cblas_Upper) ? i : 0;
+	size_t jmax = (uplo == o2cblas_Upper) ? N : i+1;
+	for (j = jmin; j < jmax; j++) {
+	  double temp = 0.0;
+	  for (k = 0; k < K; k++) {
+	    temp += O2SCL_IX2(A,i,k) * O2SCL_IX2(A,j,k);
+	  }
+	  O2SCL_IX2(C,i,j) += alpha * temp;
+	}
+      }
+
+    } else if (trans == o2cblas_Trans) {
+
+      /* form  C := alpha*A'*A + C */
+
+      for (i = 0; i < N; i++) {
+	size_t jmin = (uplo == o2cblas_Upper) ? i : 0;
+	size_t jmax = (uplo == o2cblas_Upper) ? N : i+1;
+	for (j = jmin; j < jmax; j++) {
+	  double temp = 0.0;
+	  for (k = 0; k < K; k++) {
+	    temp += O2SCL_IX2(A,k,i) * O2SCL_IX2(A,k,j);
+	  }
+	  O2SCL_IX2(C,i,j) += alpha * temp;
+	}
+      }
+
+    } else {
+      O2SCL_ERR("Bad operation in dsyrk().",o2scl::exc_einval);
+    }
+
+    return;
+  }
   //@}
   
   /// \name Helper Level-1 BLAS functions - Subvectors
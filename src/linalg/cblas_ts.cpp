@@ -34,6 +34,10 @@ using namespace o2scl;
 
 typedef boost::numeric::ublas::vector<double> ubvector;
 typedef boost::numeric::ublas::matrix<double> ubmatrix;
+typedef boost::numeric::ublas::matrix
+<double,boost::numeric::ublas::column_major> ubmatrix_cm;
+typedef boost::numeric::ublas::matrix
+<double,boost::numeric::ublas::row_major,std::vector<double> > ubmatrix_vec;
 
 void reset_data(ubvector &v1, ubvector &v2, ubvector &v3,
 		gsl_vector *g1, gsl_vector *g2, gsl_vector *g3,
@@ -448,6 +452,109 @@ int main(void) {
     t.test_rel_mat(5,5,m3,gsl_matrix_wrap(hm3),1.0e-12,
 		   "dgemmc2tt operator[] ");
 
+    // Compare the blocked specializations for ubmatrix with the
+    // generic templates for larger matrices, using a column-major
+    // ublas matrix to force the generic version. The sizes are not
+    // multiples of the block sizes.
+
+    {
+      const size_t nl=300, kl=270;
+      ubmatrix bA(nl,nl), bB(nl,nl), bC(nl,nl);
+      ubmatrix_cm cA(nl,nl), cB(nl,nl), cC(nl,nl);
+      for(size_t i=0;i<nl;i++) {
+	for(size_t j=0;j<nl;j++) {
+	  bA(i,j)=sin((double)(i*nl+j+1));
+	  bB(i,j)=cos((double)(3*i+j+1));
+	  bC(i,j)=sin((double)(i+2*j+1));
+	  // Make the diagonal dominant for dtrsm()
+	  if (i==j) bA(i,j)+=30.0;
+	}
+      }
+
+      o2scl_cblas::o2cblas_order ord[2]={o2scl_cblas::o2cblas_RowMajor,
+					 o2scl_cblas::o2cblas_ColMajor};
+      o2scl_cblas::o2cblas_transpose tr[2]={o2scl_cblas::o2cblas_NoTrans,
+					    o2scl_cblas::o2cblas_Trans};
+      o2scl_cblas::o2cblas_uplo ul[2]={o2scl_cblas::o2cblas_Upper,
+				       o2scl_cblas::o2cblas_Lower};
+      o2scl_cblas::o2cblas_side sd[2]={o2scl_cblas::o2cblas_Left,
+				       o2scl_cblas::o2cblas_Right};
+
+      for(size_t io=0;io<2;io++) {
+	for(size_t ia=0;ia<2;ia++) {
+	  for(size_t ib=0;ib<2;ib++) {
+	    ubmatrix C2=bC;
+	    cA=bA;
+	    cB=bB;
+	    cC=bC;
+	    o2scl_cblas::dgemm(ord[io],tr[ia],tr[ib],kl,nl-20,nl-10,
+			       0.3,bA,bB,0.7,C2);
+	    o2scl_cblas::dgemm(ord[io],tr[ia],tr[ib],kl,nl-20,nl-10,
+			       0.3,cA,cB,0.7,cC);
+	    t.test_rel_mat(nl,nl,C2,cC,1.0e-10,"blocked dgemm");
+	  }
+	}
+      }
+
+      for(size_t io=0;io<2;io++) {
+	for(size_t is=0;is<2;is++) {
+	  for(size_t iu=0;iu<2;iu++) {
+	    for(size_t ia=0;ia<2;ia++) {
+	      ubmatrix B2=bB;
+	      cA=bA;
+	      cB=bB;
+	      o2scl_cblas::dtrsm(ord[io],sd[is],ul[iu],tr[ia],
+				 o2scl_cblas::o2cblas_NonUnit,nl,kl,
+				 1.5,bA,B2);
+	      o2scl_cblas::dtrsm(ord[io],sd[is],ul[iu],tr[ia],
+				 o2scl_cblas::o2cblas_NonUnit,nl,kl,
+				 1.5,cA,cB);
+	      t.test_rel_mat(nl,nl,B2,cB,1.0e-10,"blocked dtrsm");
+	    }
+	  }
+	}
+      }
+
+      for(size_t io=0;io<2;io++) {
+	for(size_t iu=0;iu<2;iu++) {
+	  for(size_t ia=0;ia<2;ia++) {
+	    ubmatrix C2=bC;
+	    cA=bA;
+	    cC=bC;
+	    o2scl_cblas::dsyrk(ord[io],ul[iu],tr[ia],kl,nl-30,
+			       0.4,bA,0.6,C2);
+	    o2scl_cblas::dsyrk(ord[io],ul[iu],tr[ia],kl,nl-30,
+			       0.4,cA,0.6,cC);
+	    t.test_rel_mat(nl,nl,C2,cC,1.0e-10,"blocked dsyrk");
+	  }
+	}
+      }
+
+      // The specializations for matrices stored in std::vector
+      ubmatrix_vec vA(nl,nl), vB(nl,nl), vC(nl,nl);
+      for(size_t i=0;i<nl;i++) {
+	for(size_t j=0;j<nl;j++) {
+	  vA(i,j)=bA(i,j);
+	  vB(i,j)=bB(i,j);
+	  vC(i,j)=bC(i,j);
+	}
+      }
+      ubmatrix C2=bC, B2=bB;
+      o2scl_cblas::dgemm(ord[0],tr[0],tr[1],kl,nl-20,nl-10,
+			 0.3,bA,bB,0.7,C2);
+      o2scl_cblas::dgemm(ord[0],tr[0],tr[1],kl,nl-20,nl-10,
+			 0.3,vA,vB,0.7,vC);
+      t.test_rel_mat(nl,nl,C2,vC,1.0e-14,"blocked dgemm vector");
+      o2scl_cblas::dtrsm(ord[0],sd[0],ul[1],tr[0],
+			 o2scl_cblas::o2cblas_NonUnit,nl,kl,1.5,bA,B2);
+      o2scl_cblas::dtrsm(ord[0],sd[0],ul[1],tr[0],
+			 o2scl_cblas::o2cblas_NonUnit,nl,kl,1.5,vA,vB);
+      t.test_rel_mat(nl,nl,B2,vB,1.0e-14,"blocked dtrsm vector");
+      o2scl_cblas::dsyrk(ord[0],ul[0],tr[1],kl,nl-30,0.4,bA,0.6,C2);
+      o2scl_cblas::dsyrk(ord[0],ul[0],tr[1],kl,nl-30,0.4,vA,0.6,vC);
+      t.test_rel_mat(nl,nl,C2,vC,1.0e-14,"blocked dsyrk vector");
+    }
+
 #ifdef O2SCL_NEVER_DEFINED
 
     // daxpy_subvec
@@ -29,6 +29,8 @@
 
 #include <iostream>
 #include <random>
+#include <functional>
+#include <vector>
 
 #include <boost/numeric/ublas/vector.hpp>
 
@@ -39,11 +41,32 @@
 namespace o2scl {
 #endif
 
+  /** \brief Batch integrand for Monte Carlo integration
+
+      The first argument is the number of points, \c npts, and the
+      second is the number of dimensions, \c ndim. The points are
+      stored consecutively in the third argument, so that the
+      coordinates of point \c i are <tt>x[i*ndim]</tt> through
+      <tt>x[i*ndim+ndim-1]</tt>. The function values should be stored
+      in the first \c npts entries of the fourth argument. A nonzero
+      return value indicates failure.
+  */
+  typedef std::function<int(size_t,size_t,const double *,double *)>
+    mcarlo_batch_funct;
+
   /** \brief Monte-Carlo integration [abstract base]
       
       This class provides the generic Monte Carlo parameters and the
       random number generator. The default type for the random number
       generator is a \ref rng_gsl object. 
+
+      Children which support \ref n_threads divide the points in
+      each step among the threads, and each thread uses its own
+      random number generator. These generators are seeded with
+      values taken from \ref rng at the beginning of each
+      integration, so the results depend only on the seed of \ref
+      rng and on \ref n_threads. When \ref n_threads is 1, the
+      points are generated directly from \ref rng.
   */
   template<class func_t=multi_funct, 
     class vec_t=boost::numeric::ublas::vector<double>,
@@ -54,6 +77,10 @@ namespace o2scl {
   
   mcarlo() {
       n_points=1000;
+      n_threads=1;
+      n_batch=256;
+      func_ptr=0;
+      batch_ptr=0;
     }
 
     virtual ~mcarlo() {}
@@ -61,6 +88,20 @@ namespace o2scl {
     /** \brief Number of integration points (default 1000)
      */
     unsigned long n_points;
+
+    /** \brief Number of OpenMP threads (default 1)
+
+        If this is greater than one, then the integrand must be safe
+        to call from several threads at once. If O2scl was compiled
+        without OpenMP support, the points assigned to each thread
+        are computed serially, so the result is unchanged.
+    */
+    size_t n_threads;
+
+    /** \brief The maximum number of points sent to the integrand
+        in one block (default 256)
+    */
+    size_t n_batch;
   
   /** \brief The random number distribution
    */
@@ -71,6 +112,68 @@ namespace o2scl {
   
     /// Return string denoting type ("mcarlo")
     virtual const char *type() { return "mcarlo"; }
+
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+
+    /// The random number generators for each thread
+    std::vector<rng_t> rng_threads;
+
+    /// Storage for the integration point in each thread
+    std::vector<vec_t> x_threads;
+
+    /// The integrand, if \ref batch_ptr is zero
+    func_t *func_ptr;
+
+    /// The batch integrand, or zero if \ref func_ptr is to be used
+    mcarlo_batch_funct *batch_ptr;
+
+    /** \brief Set the integrand and seed the random number 
+        generators for each thread
+    */
+    void init_threads(func_t *fp, mcarlo_batch_funct *bp, size_t ndim) {
+      if (n_threads==0) n_threads=1;
+      func_ptr=fp;
+      batch_ptr=bp;
+      if (n_threads>1) {
+        rng_threads.resize(n_threads);
+        for(size_t it=0;it<n_threads;it++) {
+          rng_threads[it].set_seed(rng());
+        }
+      }
+      x_threads.resize(n_threads);
+      for(size_t it=0;it<n_threads;it++) {
+        x_threads[it].resize(ndim);
+      }
+      return;
+    }
+
+    /// Return the random number generator for thread \c it
+    rng_t &thread_rng(size_t it) {
+      if (n_threads>1) return rng_threads[it];
+      return rng;
+    }
+
+    /** \brief Evaluate the integrand at the \c npts points stored
+        in \c pts from thread \c it
+    */
+    int eval_block(size_t it, size_t ndim, size_t npts, const double *pts,
+                   double *vals) {
+      if (batch_ptr!=0) {
+        return (*batch_ptr)(npts,ndim,pts,vals);
+      }
+      vec_t &x=x_threads[it];
+      for(size_t i=0;i<npts;i++) {
+        for(size_t j=0;j<ndim;j++) {
+          x[j]=pts[i*ndim+j];
+        }
+        vals[i]=(*func_ptr)(ndim,x);
+      }
+      return 0;
+    }
+
+#endif
   
   };
 
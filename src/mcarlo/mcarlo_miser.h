@@ -86,6 +86,13 @@ namespace o2scl {
       boundaries of the current region are also output. Finally, if it
       is greater than 2, a keypress is required after each output.
 
+      If \ref mcarlo::n_threads is greater than one, the points used
+      to estimate the variance at each level of the recursion and the
+      points used for the plain Monte Carlo estimate in each final
+      subregion are divided among the threads. The function
+      minteg_err_batch() integrates a \ref mcarlo_batch_funct which
+      is given blocks of points at once.
+
       \verbatim embed:rst
       Based on [Press90]_.
       \endverbatim
@@ -248,76 +255,214 @@ namespace o2scl {
     ubvector_size_t hits_r;
     //@}
     
+    /** \brief Sample the points from \c n0 up to (but not including)
+	\c n1 in thread \c it
+
+	If \c lxmid is zero, the points are distributed uniformly in
+	the region. Otherwise, the points are distributed as in
+	estimate_corrmc() and the sums and the number of points on
+	each side of the midpoint are added to \c fs and \c hits,
+	which have size <tt>4*dim</tt> and <tt>2*dim</tt>. The mean
+	and the sum of the squared deviations of the function values
+	are stored in \c m and \c q.
+    */
+    int sample_points(size_t it, size_t n0, size_t n1, const vec_t &xl,
+		      const vec_t &xu, const ubvector *lxmid,
+		      double &m, double &q, double *fs, size_t *hits) {
+      
+      rng_t &r=this->thread_rng(it);
+      size_t nb=this->n_batch;
+      if (nb==0) nb=1;
+      if (nb>n1-n0) nb=n1-n0;
+      std::vector<double> pts(nb*dim), vals(nb);
+
+      m=0.0;
+      q=0.0;
+      
+      for (size_t n=n0;n<n1;n+=nb) {
+	
+	size_t ne=n+nb;
+	if (ne>n1) ne=n1;
+	
+	for (size_t ip=0;ip<ne-n;ip++) {
+	  
+	  unsigned int j=((n+ip)/2) % dim;
+	  unsigned int side=((n+ip) % 2);
+	  double *x=&(pts[ip*dim]);
+
+	  for (size_t i=0;i<dim;i++) {
+	    
+	    // The equivalent of gsl_rng_uniform_pos()
+	    double z;
+	    do { 
+	      z=this->rng_dist(r);
+	    } while (z==0);
+	    
+	    if (lxmid==0 || i != j) {
+	      x[i]=xl[i]+z*(xu[i]-xl[i]);
+	    } else if (side == 0) {
+	      x[i]=(*lxmid)[i]+z*(xu[i]-(*lxmid)[i]);
+	    } else {
+	      x[i]=xl[i]+z*((*lxmid)[i]-xl[i]);
+	    }
+	  }
+	}
+	
+	if (this->eval_block(it,dim,ne-n,&(pts[0]),&(vals[0]))!=0) {
+	  return exc_efailed;
+	}
+
+	for (size_t ip=0;ip<ne-n;ip++) {
+	  
+	  double fval=vals[ip];
+	  double k=(double)(n+ip-n0);
+	
+	  /* recurrence for mean and variance */
+	  {
+	    double d=fval-m;
+	    m+=d/(k+1.0);
+	    q+=d*d*(k/(k+1.0));
+	  }
+
+	  /* compute the variances on each side of the bisection */
+	  if (lxmid!=0) {
+	    for (size_t i=0;i<dim;i++) {
+	      if (pts[ip*dim+i] <= (*lxmid)[i]) {
+		fs[i]+=fval;
+		fs[i+2*dim]+=fval*fval;
+		hits[i]++;
+	      } else {
+		fs[i+dim]+=fval;
+		fs[i+3*dim]+=fval*fval;
+		hits[i+dim]++;
+	      }
+	    }
+	  }
+	}
+      }
+      
+      return success;
+    }
+
+    /** \brief Sample \c calls points in the region from \c xl to
+	\c xu, dividing them among the threads
+
+	The mean and the sum of squared deviations from each thread
+	are combined in order, so the result depends only on the
+	number of threads and not on their scheduling. If \c lxmid is
+	not zero, the sums on each side of the midpoint are stored in
+	\ref fsum_l, \ref fsum_r, \ref fsum2_l, \ref fsum2_r, \ref
+	hits_l and \ref hits_r.
+    */
+    int sample_region(size_t calls, const vec_t &xl, const vec_t &xu,
+		      const ubvector *lxmid, double &m, double &q) {
+
+      size_t nt=this->n_threads;
+      std::vector<double> m_t(nt), q_t(nt);
+      std::vector<double> fs_t(nt*4*dim,0.0);
+      std::vector<size_t> hits_t(nt*2*dim,0);
+      std::vector<int> ret_t(nt);
+
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+      for (size_t it=0;it<nt;it++) {
+	ret_t[it]=sample_points(it,it*calls/nt,(it+1)*calls/nt,xl,xu,
+				lxmid,m_t[it],q_t[it],&(fs_t[it*4*dim]),
+				&(hits_t[it*2*dim]));
+      }
+
+      for (size_t i=0;i<dim;i++) {
+	hits_l[i]=hits_r[i]=0;
+	fsum_l[i]=fsum_r[i]=0.0;
+	fsum2_l[i]=fsum2_r[i]=0.0;
+      }
+      
+      m=0.0;
+      q=0.0;
+      size_t n_tot=0;
+      for (size_t it=0;it<nt;it++) {
+	
+	if (ret_t[it]!=0) {
+	  O2SCL_ERR2("Integrand failed in ",
+		     "mcarlo_miser::miser_minteg_err().",exc_efailed);
+	}
+	
+	// Combine the mean and variance with those from
+	// the previous threads
+	size_t cnt=(it+1)*calls/nt-it*calls/nt;
+	if (cnt>0) {
+	  if (n_tot==0) {
+	    m=m_t[it];
+	    q=q_t[it];
+	  } else {
+	    double d=m_t[it]-m;
+	    double n_new=((double)(n_tot+cnt));
+	    m+=d*cnt/n_new;
+	    q+=q_t[it]+d*d*n_tot*cnt/n_new;
+	  }
+	  n_tot+=cnt;
+	}
+
+	if (lxmid!=0) {
+	  const double *fs=&(fs_t[it*4*dim]);
+	  const size_t *hits=&(hits_t[it*2*dim]);
+	  for (size_t i=0;i<dim;i++) {
+	    fsum_l[i]+=fs[i];
+	    fsum_r[i]+=fs[i+dim];
+	    fsum2_l[i]+=fs[i+2*dim];
+	    fsum2_r[i]+=fs[i+3*dim];
+	    hits_l[i]+=hits[i];
+	    hits_r[i]+=hits[i+dim];
+	  }
+	}
+      }
+
+      return success;
+    }
+    
     /** \brief Estimate the variance
 
-	\future Remove the reference to GSL_POSINF and replace with a
-	function parameter.
+	This is called by \ref miser_minteg_err() for the integrand
+	\c func, and the default version calls \ref
+	estimate_corrmc_base(). It is not used with a batch integrand.
     */
     virtual int estimate_corrmc(func_t &func, size_t ndim,
 				const vec_t &xl, const vec_t &xu,
 				size_t calls, double &res,
 				double &err, const ubvector &lxmid,
 				ubvector &lsigma_l, ubvector &lsigma_r) {
-      size_t i, n;
+      // Only initialize if this is called outside of
+      // miser_minteg_err(), since the initialization uses the
+      // random number generator
+      if (this->func_ptr!=&func || this->batch_ptr!=0) {
+	this->init_threads(&func,0,ndim);
+      }
+      return estimate_corrmc_base(ndim,xl,xu,calls,res,err,lxmid,
+				  lsigma_l,lsigma_r);
+    }
+    
+    /** \brief Estimate the variance using the integrand specified
+	in \ref init_threads()
+
+	\future Remove the reference to GSL_POSINF and replace with a
+	function parameter.
+    */
+    int estimate_corrmc_base(size_t ndim, const vec_t &xl,
+			     const vec_t &xu, size_t calls, double &res,
+			     double &err, const ubvector &lxmid,
+			     ubvector &lsigma_l, ubvector &lsigma_r) {
+      size_t i;
       
       double m=0.0, q=0.0;
       double vol=1.0;
 
       for (i=0;i<dim;i++) {
 	vol*=xu[i]-xl[i];
-	hits_l[i]=hits_r[i]=0;
-	fsum_l[i]=fsum_r[i]=0.0;
-	fsum2_l[i]=fsum2_r[i]=0.0;
 	lsigma_l[i]=lsigma_r[i]=-1;
       }
 
-      for (n=0;n<calls;n++) {
-	double fval;
-
-	unsigned int j=(n/2) % dim;
-	unsigned int side=(n % 2);
-
-	for (i=0;i<dim;i++) {
-
-	  // The equivalent of gsl_rng_uniform_pos()
-	  double z;
-	  do { 
-	    z=this->rng_dist(this->rng);
-	  } while (z==0);
-	  
-	  if (i != j) {
-	    x[i]=xl[i]+z*(xu[i]-xl[i]);
-	  } else {
-	    if (side == 0) {
-	      x[i]=lxmid[i]+z*(xu[i]-lxmid[i]);
-	    } else {
-	      x[i]=xl[i]+z*(lxmid[i]-xl[i]);
-	    }
-	  }
-	}
-	
-	fval=func(ndim,x);
-	
-	/* recurrence for mean and variance */
-	{
-	  double d=fval-m;
-	  m+=d/(n+1.0);
-	  q+=d*d*(n/(n+1.0));
-	}
-
-	/* compute the variances on each side of the bisection */
-	for (i=0;i<dim;i++) {
-	  if (x[i] <= lxmid[i]) {
-	    fsum_l[i]+=fval;
-	    fsum2_l[i]+=fval*fval;
-	    hits_l[i]++;
-	  } else {
-	    fsum_r[i]+=fval;
-	    fsum2_r[i]+=fval*fval;
-	    hits_r[i]++;
-	  }
-	}
-      }
+      sample_region(calls,xl,xu,&lxmid,m,q);
 
       for (i=0;i<dim;i++) {
 	double fraction_l=(lxmid[i]-xl[i])/(xu[i]-xl[i]);
@@ -346,7 +491,9 @@ namespace o2scl {
       return success;
     }
 
-    /// The most recent integration point
+    /** \brief The most recent integration point (unused, the
+	integration now uses a separate point for each thread)
+    */
     vec_t x;
 
 #endif
@@ -411,6 +558,37 @@ namespace o2scl {
     virtual int miser_minteg_err(func_t &func, size_t ndim, const vec_t &xl, 
 				 const vec_t &xu, size_t calls, size_t level,
 				 double &res, double &err) {
+      this->init_threads(&func,0,dim);
+      return miser_integ_base(ndim,xl,xu,calls,level,res,err);
+    }
+
+    /** \brief Integrate the batch function \c func over the
+	hypercube from \f$ x_i=\mathrm{xl}_i \f$ to \f$
+	x_i=\mathrm{xu}_i \f$ for \f$ 0<i< \f$ ndim-1
+
+	This is the same as miser_minteg_err(), except that the
+	integrand is called with blocks of up to \ref mcarlo::n_batch
+	points.
+    */
+    virtual int miser_minteg_err_batch(mcarlo_batch_funct &func,
+				       size_t ndim, const vec_t &xl, 
+				       const vec_t &xu, size_t calls,
+				       size_t level, double &res,
+				       double &err) {
+      this->init_threads(0,&func,dim);
+      return miser_integ_base(ndim,xl,xu,calls,level,res,err);
+    }
+
+#ifndef DOXYGEN_INTERNAL
+
+    protected:
+    
+    /** \brief The recursive integration algorithm used by 
+	miser_minteg_err() and miser_minteg_err_batch()
+    */
+    int miser_integ_base(size_t ndim, const vec_t &xl, const vec_t &xu,
+			 size_t calls, size_t level, double &res,
+			 double &err) {
 
       if (min_calls==0 || min_calls_per_bisection==0) {
 	O2SCL_ERR2("Variables min_calls or min_calls_per_bisection ",
@@ -418,7 +596,7 @@ namespace o2scl {
 		       exc_einval);
       }
       
-      size_t n, estimate_calls, calls_l, calls_r;
+      size_t estimate_calls, calls_l, calls_r;
       size_t i;
       size_t i_bisect;
       int found_best;
@@ -465,31 +643,8 @@ namespace o2scl {
 			 "in mcarlo_miser::miser_minteg_err().",exc_einval);
 	}
 
-	for (n=0;n<calls;n++) {
-	  /* Choose a random point in the integration region */
-
-	  for (i=0;i<dim;i++) {
-	    
-	    // The equivalent of gsl_rng_uniform_pos()
-	    double rdn;
-	    do { 
-	      rdn=this->rng_dist(this->rng);
-	    } while (rdn==0);
-	  
-	    x[i]=xl[i]+rdn*(xu[i]-xl[i]);
-	  }
-
-	  {
-	    double fval;
-	    fval=func(ndim,x);
-	    
-	    /* [GSL] recurrence for mean and variance */
-
-	    double d=fval-m;
-	    m+=d/(n+1.0);
-	    q+=d*d*(n/(n+1.0));
-	  }
-	}
+	/* Choose random points in the integration region */
+	sample_region(calls,xl,xu,0,m,q);
 
 	res=vol*m;
 
@@ -522,8 +677,13 @@ namespace o2scl {
 	 simply estimate the variances by finding the min and max
 	 function values for each half-region for each bisection.
       */
-      estimate_corrmc(func,dim,xl,xu,estimate_calls,
-		      res_est,err_est,xmid,sigma_l,sigma_r);
+      if (this->batch_ptr==0) {
+	estimate_corrmc(*(this->func_ptr),dim,xl,xu,estimate_calls,
+			res_est,err_est,xmid,sigma_l,sigma_r);
+      } else {
+	estimate_corrmc_base(dim,xl,xu,estimate_calls,
+			     res_est,err_est,xmid,sigma_l,sigma_r);
+      }
 
       // [GSL] We have now used up some calls for the estimation 
 
@@ -631,7 +791,7 @@ namespace o2scl {
 	
 	xu_tmp[i_bisect]=xbi_m;
 	
-	status=miser_minteg_err(func,dim,xl,xu_tmp,calls_l,level+1,
+	status=miser_integ_base(dim,xl,xu_tmp,calls_l,level+1,
 				res_l,err_l);
 
 	if (status != success) {
@@ -652,7 +812,7 @@ namespace o2scl {
 
 	xl_tmp[i_bisect]=xbi_m;
 
-	status=miser_minteg_err(func,dim,xl_tmp,xu,calls_r,level+1,
+	status=miser_integ_base(dim,xl_tmp,xu,calls_r,level+1,
 				res_r,err_r);
 	
 	if (status != success) {
@@ -665,6 +825,10 @@ namespace o2scl {
 
       return 0;
     }
+
+#endif
+
+    public:
     
     /** \brief Integrate function \c func from x=a to x=b.
 
@@ -687,6 +851,24 @@ namespace o2scl {
       return ret;
     }
     
+    /** \brief Integrate the batch function \c func from x=a to x=b.
+
+	This is the same as minteg_err(), except that the integrand
+	is called with blocks of up to \ref mcarlo::n_batch points.
+    */
+    virtual int minteg_err_batch(mcarlo_batch_funct &func, size_t ndim,
+				 const vec_t &a, const vec_t &b,
+				 double &res, double &err) {
+      if (ndim!=dim) allocate(ndim);
+      min_calls=calls_per_dim*ndim;
+      min_calls_per_bisection=bisection_ratio*min_calls;
+      int ret=miser_minteg_err_batch(func,ndim,a,b,this->n_points,0,
+				     res,err);
+      min_calls=0;
+      min_calls_per_bisection=0;
+      return ret;
+    }
+    
     /** \brief Integrate function \c func over the hypercube from
 	\f$ x_i=a_i \f$ to \f$ x_i=b_i \f$ for
 	\f$ 0<i< \f$ ndim-1
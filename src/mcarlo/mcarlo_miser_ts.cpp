@@ -39,6 +39,30 @@ double test_fun(size_t nv, const ubvector &x) {
   return y;
 }
 
+int test_fun_batch(size_t npts, size_t nv, const double *x, double *f) {
+  for(size_t i=0;i<npts;i++) {
+    const double *y=x+i*nv;
+    f[i]=1.0/(1.0-cos(y[0])*cos(y[1])*cos(y[2]))/M_PI/M_PI/M_PI;
+  }
+  return 0;
+}
+
+/// Count the calls to estimate_corrmc()
+class mcarlo_miser_count : public mcarlo_miser<> {
+public:
+  size_t count=0;
+protected:
+  virtual int estimate_corrmc(multi_funct &func, size_t ndim,
+			      const ubvector &xl, const ubvector &xu,
+			      size_t calls, double &res, double &err,
+			      const ubvector &lxmid, ubvector &lsigma_l,
+			      ubvector &lsigma_r) {
+    count++;
+    return mcarlo_miser<>::estimate_corrmc(func,ndim,xl,xu,calls,res,err,
+					   lxmid,lsigma_l,lsigma_r);
+  }
+};
+
 double g(double *k, size_t dim, void *params) {
   return 1.0/(1.0-cos(k[0])*cos(k[1])*cos(k[2]))/M_PI/M_PI/M_PI;
 }
@@ -109,6 +133,38 @@ int main(void) {
     t.test_rel(res1,res2,1.0e-9,"O2SCL vs. GSL");
   }
 
+  // The variance estimate and the leaf samples are divided among
+  // the threads. The batch integrand sees the same points.
+  {
+    ubvector a(3), b(3);
+    for(size_t i=0;i<3;i++) {
+      a[i]=0.0;
+      b[i]=M_PI;
+    }
+    
+    multi_funct tf=test_fun;
+    mcarlo_batch_funct tfb=test_fun_batch;
+    double err, res_b, err_b;
+
+    mcarlo_miser<> gm, gm_b;
+    gm.n_points=100000;
+    gm.n_threads=3;
+    gm.minteg_err(tf,3,a,b,res3,err);
+    t.test_rel(res3,exact,err*10.0,"threads");
+
+    gm_b.n_points=100000;
+    gm_b.n_threads=3;
+    gm_b.minteg_err_batch(tfb,3,a,b,res_b,err_b);
+    t.test_gen(res3==res_b && err==err_b,"threads batch");
+
+    // An override of estimate_corrmc() is still used
+    mcarlo_miser_count gm_c;
+    gm_c.n_points=100000;
+    gm_c.minteg_err(tf,3,a,b,res_b,err_b);
+    t.test_gen(gm_c.count>0,"estimate_corrmc() override");
+    t.test_rel(res_b,res2,1.0e-12,"estimate_corrmc() override result");
+  }
+
   t.report();
  
   return 0;
@@ -69,6 +69,14 @@ namespace o2scl {
       prints information from the rebinning procedure for each
       iteration.
 
+      If \ref mcarlo::n_threads is greater than one, the boxes in
+      each iteration are divided among the threads and the
+      contributions to the integral and to the grid refinement are
+      combined after each iteration. In importance-only mode there is
+      only one box, so only one thread is used. The function
+      minteg_err_batch() integrates a \ref mcarlo_batch_funct which
+      is given blocks of points at once.
+
       Some original documentation from GSL:
 
       \verbatim 
@@ -190,14 +198,21 @@ namespace o2scl {
     /// The volume of the current bin
     double vol;
 
-    /// The bins for each direction
+    /** \brief The bins for each direction (unused, the integration
+	now uses a separate copy for each thread)
+    */
     ubvector_int bin;
-    /// The boxes for each direction
+    /** \brief The boxes for each direction (unused, the integration
+	now uses a separate copy for each thread)
+    */
     ubvector_int box;
 
     /// Distribution 
     ubvector d;
 
+    /// The distribution accumulated by each thread
+    std::vector<ubvector> d_threads;
+
     /** \name Scratch variables preserved between calls to 
         vegas_minteg_err()
     */
@@ -283,17 +298,18 @@ namespace o2scl {
       return;
     }
 
-    /** \brief Add the most recently generated result to the distribution
+    /** \brief Add the value \c y in the bins \c lbin to the
+        distribution \c ld
 
         This is among the member functions that is not virtual
         because it is part of the innermost loop.
     */
-    void accumulate_distribution(ubvector_int &lbin, double y) {
+    void accumulate_distribution(ubvector &ld, const int *lbin, double y) {
       size_t j;
       
       for (j=0;j<dim;j++) {
         int i=lbin[j];
-        d[i*dim+j]+=y;
+        ld[i*dim+j]+=y;
       }
       return;
     }
@@ -307,7 +323,7 @@ namespace o2scl {
         This is among the member functions that is not virtual
         because it is part of the innermost loop.
     */
-    void random_point(vec_t &lx, ubvector_int &lbin, double &bin_vol,
+    void random_point(rng_t &r, double *lx, int *lbin, double &bin_vol,
                       const ubvector_int &lbox, const vec_t &xl, 
                       const vec_t &xu) {
 
@@ -320,7 +336,7 @@ namespace o2scl {
         // The equivalent of gsl_rng_uniform_pos()
         double rdn;
         do { 
-          rdn=this->rng_dist(this->rng);
+          rdn=this->rng_dist(r);
         } while (rdn==0);
         
         /* lbox[j] + ran gives the position in the box units, while z
@@ -458,6 +474,99 @@ namespace o2scl {
       return;
     }
 
+    /** \brief Sample the boxes from \c b0 up to (but not including)
+        \c b1 in thread \c it
+
+        The boxes are numbered in the order given by
+        change_box_coord(). The contributions to the integral and the
+        sum of squares are added to \c lint and \c ltss and the
+        distribution is added to \c ld.
+    */
+    int sample_boxes(size_t it, size_t b0, size_t b1, const vec_t &xl,
+                     const vec_t &xu, double &lint, double &ltss,
+                     ubvector &ld) {
+
+      size_t lcalls_per_box=calls_per_box;
+      double jacbin=jac;
+      rng_t &r=this->thread_rng(it);
+
+      // The number of boxes in each block of integrand evaluations
+      size_t nbb=this->n_batch/lcalls_per_box;
+      if (nbb==0) nbb=1;
+      if (nbb>b1-b0) nbb=b1-b0;
+
+      size_t npts_max=nbb*lcalls_per_box;
+      std::vector<double> pts(npts_max*dim), vals(npts_max);
+      std::vector<double> bin_vols(npts_max);
+      std::vector<int> lbins(npts_max*dim);
+
+      // Compute the coordinates of the first box
+      ubvector_int lbox(dim);
+      {
+        size_t bx=b0;
+        for (int j=dim-1;j>=0;j--) {
+          lbox[j]=bx % boxes;
+          bx/=boxes;
+        }
+      }
+
+      for (size_t b=b0;b<b1;b+=nbb) {
+
+        size_t be=b+nbb;
+        if (be>b1) be=b1;
+        size_t npts=(be-b)*lcalls_per_box;
+
+        for (size_t ip=0;ip<npts;ip++) {
+          random_point(r,&(pts[ip*dim]),&(lbins[ip*dim]),bin_vols[ip],
+                       lbox,xl,xu);
+          if ((ip+1)%lcalls_per_box==0) change_box_coord(lbox);
+        }
+
+        if (this->eval_block(it,dim,npts,&(pts[0]),&(vals[0]))!=0) {
+          return exc_efailed;
+        }
+
+        for (size_t ib=0;ib<be-b;ib++) {
+          
+          volatile double m=0, q=0;
+          double f_sq_sum=0.0;
+          size_t ip=ib*lcalls_per_box;
+          
+          for (size_t k=0;k<lcalls_per_box;k++,ip++) {
+            
+            double fval=vals[ip];
+            fval*=jacbin*bin_vols[ip];
+
+            /* recurrence for mean and variance (sum of squares) */
+
+            {
+              double dt=fval-m;
+              m+=dt/(k+1.0);
+              q+=dt*dt*(k/(k+1.0));
+            }
+
+            if (mode != mode_stratified) {
+              double f_sq=fval*fval;
+              accumulate_distribution(ld,&(lbins[ip*dim]),f_sq);
+            }
+          }
+
+          lint+=m*lcalls_per_box;
+
+          f_sq_sum=q*lcalls_per_box;
+
+          ltss+=f_sq_sum;
+
+          // As in GSL, use the bins of the last point in the box
+          if (mode == mode_stratified) {
+            accumulate_distribution(ld,&(lbins[(ip-1)*dim]),f_sq_sum);
+          }
+        }
+      }
+      
+      return success;
+    }
+
     /// Print limits of integration
     virtual void print_lim(const vec_t &xl, const vec_t &xu, 
                            unsigned long ldim) {
@@ -558,7 +667,9 @@ namespace o2scl {
       return;
     }
 
-    /// Point for function evaluation
+    /** \brief Point for function evaluation (unused, the integration
+	now uses a separate point for each thread)
+    */
     vec_t x;
 
 #endif
@@ -624,6 +735,74 @@ namespace o2scl {
     virtual int vegas_minteg_err(int stage, func_t &func, size_t ndim, 
                                  const vec_t &xl, const vec_t &xu, 
                                  double &res, double &err) {
+      this->init_threads(&func,0,dim);
+      return vegas_integ_base(stage,xl,xu,res,err);
+    }
+
+    /** \brief Integrate the batch function \c func using the grid
+        stage \c stage
+
+        This is the same as vegas_minteg_err(), except that the
+        integrand is called with blocks of up to \ref mcarlo::n_batch
+        points.
+    */
+    virtual int vegas_minteg_err_batch(int stage, mcarlo_batch_funct &func,
+                                       size_t ndim, const vec_t &xl,
+                                       const vec_t &xu, double &res,
+                                       double &err) {
+      this->init_threads(0,&func,dim);
+      return vegas_integ_base(stage,xl,xu,res,err);
+    }
+
+    virtual ~mcarlo_vegas() {}
+  
+    /// Integrate function \c func from x=a to x=b.
+    virtual int minteg_err(func_t &func, size_t ndim, const vec_t &a, 
+                           const vec_t &b, double &res, double &err) {
+      allocate(ndim);
+      chisq=0;
+      bins=bins_max;
+      int ret=vegas_minteg_err(0,func,ndim,a,b,res,err);
+      return ret;
+    }
+    
+    /** \brief Integrate the batch function \c func over the
+        hypercube from \f$ x_i=a_i \f$ to \f$ x_i=b_i \f$ for
+        \f$ 0<i< \f$ ndim-1
+    */
+    virtual int minteg_err_batch(mcarlo_batch_funct &func, size_t ndim,
+                                 const vec_t &a, const vec_t &b,
+                                 double &res, double &err) {
+      allocate(ndim);
+      chisq=0;
+      bins=bins_max;
+      int ret=vegas_minteg_err_batch(0,func,ndim,a,b,res,err);
+      return ret;
+    }
+    
+    /** \brief Integrate function \c func over the hypercube from
+        \f$ x_i=a_i \f$ to \f$ x_i=b_i \f$ for
+        \f$ 0<i< \f$ ndim-1
+    */
+    virtual double minteg(func_t &func, size_t ndim, const vec_t &a, 
+                          const vec_t &b) {
+      double res;
+      minteg_err(func,ndim,a,b,res,this->interror);
+      return res;
+    }
+    
+    /// Return string denoting type ("mcarlo_vegas")
+    virtual const char *type() { return "mcarlo_vegas"; }
+
+#ifndef DOXYGEN_INTERNAL
+
+    protected:
+    
+    /** \brief The integration algorithm used by vegas_minteg_err()
+        and vegas_minteg_err_batch()
+    */
+    int vegas_integ_base(int stage, const vec_t &xl, const vec_t &xu,
+                         double &res, double &err) {
 
       size_t calls=this->n_points;
 
@@ -718,60 +897,64 @@ namespace o2scl {
       cum_int=0.0;
       cum_sig=0.0;
 
+      // The total number of boxes
+      size_t n_boxes=1;
+      for (i=0;i<dim;i++) n_boxes*=boxes;
+
+      size_t nt=this->n_threads;
+      std::vector<double> intgrl_t(nt), tss_t(nt);
+      std::vector<int> ret_t(nt);
+      if (nt>1) {
+        d_threads.resize(nt);
+        for (k=0;k<nt;k++) d_threads[k].resize(d.size());
+      }
+      
       for (it=0;it<iterations;it++) {
 
         double intgrl=0.0, intgrl_sq=0.0;
         double tss=0.0;
         double wgt, var, sig;
-        size_t lcalls_per_box=calls_per_box;
-        double jacbin=jac;
 
         it_num=it_start+it;
 
         reset_grid_values();
-        init_box_coord(box);
-
-        do {
-          volatile double m=0, q=0;
-          double f_sq_sum=0.0;
-
-          for (k=0;k<lcalls_per_box;k++) {
-            double fval, bin_vol;
-            
-            random_point(x,bin,bin_vol,box,xl,xu);
-            
-            fval=func(dim,x);
-            fval*=jacbin*bin_vol;
 
-            /* recurrence for mean and variance (sum of squares) */
-
-            {
-              double dt=fval-m;
-              m+=dt/(k+1.0);
-              q+=dt*dt*(k/(k+1.0));
-            }
-
-            if (mode != mode_stratified) {
-              double f_sq=fval*fval;
-              accumulate_distribution(bin,f_sq);
+        // Divide the boxes among the threads. Each thread
+        // accumulates its own part of the integral and the
+        // distribution, and these are combined afterwards in order
+        // so the result does not depend on the thread scheduling.
+        
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+        for (size_t ith=0;ith<nt;ith++) {
+          intgrl_t[ith]=0.0;
+          tss_t[ith]=0.0;
+          if (nt>1) {
+            for (size_t j=0;j<d_threads[ith].size();j++) {
+              d_threads[ith][j]=0.0;
             }
           }
+          ubvector &ld=(nt>1 ? d_threads[ith] : d);
+          ret_t[ith]=sample_boxes(ith,ith*n_boxes/nt,(ith+1)*n_boxes/nt,
+                                  xl,xu,intgrl_t[ith],tss_t[ith],ld);
+        }
 
-          intgrl+=m*lcalls_per_box;
-
-          f_sq_sum=q*lcalls_per_box;
-
-          tss+=f_sq_sum;
-
-          if (mode == mode_stratified) {
-            accumulate_distribution (bin, f_sq_sum);
+        for (k=0;k<nt;k++) {
+          if (ret_t[k]!=0) {
+            O2SCL_ERR2("Integrand failed in ",
+                       "mcarlo_vegas::vegas_minteg_err().",exc_efailed);
           }
-
-        } while (change_box_coord(box));
-
+          intgrl+=intgrl_t[k];
+          tss+=tss_t[k];
+          if (nt>1) {
+            for (i=0;i<bins*dim;i++) d[i]+=d_threads[k][i];
+          }
+        }
+        
         /* Compute final results for this iteration   */
         
-        var=tss/(lcalls_per_box-1.0);
+        var=tss/(calls_per_box-1.0);
         
         if (var>0) {
           wgt=1.0/var;
@@ -855,31 +1038,7 @@ namespace o2scl {
       return GSL_SUCCESS;
     }
 
-    virtual ~mcarlo_vegas() {}
-  
-    /// Integrate function \c func from x=a to x=b.
-    virtual int minteg_err(func_t &func, size_t ndim, const vec_t &a, 
-                           const vec_t &b, double &res, double &err) {
-      allocate(ndim);
-      chisq=0;
-      bins=bins_max;
-      int ret=vegas_minteg_err(0,func,ndim,a,b,res,err);
-      return ret;
-    }
-    
-    /** \brief Integrate function \c func over the hypercube from
-        \f$ x_i=a_i \f$ to \f$ x_i=b_i \f$ for
-        \f$ 0<i< \f$ ndim-1
-    */
-    virtual double minteg(func_t &func, size_t ndim, const vec_t &a, 
-                          const vec_t &b) {
-      double res;
-      minteg_err(func,ndim,a,b,res,this->interror);
-      return res;
-    }
-    
-    /// Return string denoting type ("mcarlo_vegas")
-    virtual const char *type() { return "mcarlo_vegas"; }
+#endif
       
     };
 
@@ -40,6 +40,14 @@ double test_fun(size_t nv, const ubvector &x) {
   return y;
 }
 
+int test_fun_batch(size_t npts, size_t nv, const double *x, double *f) {
+  for(size_t i=0;i<npts;i++) {
+    const double *y=x+i*nv;
+    f[i]=1.0/(1.0-cos(y[0])*cos(y[1])*cos(y[2]))/M_PI/M_PI/M_PI+0.1;
+  }
+  return 0;
+}
+
 double test_fun_gsl(double *k, size_t dim, void *params) {
   // We make a small shift by 0.1 to avoid integrands which
   // are small everywhere
@@ -139,6 +147,34 @@ int main(void) {
     cout << endl;
   }
 
+  // The boxes are divided among the threads. The batch integrand
+  // sees the same points, so the results are identical.
+  {
+    ubvector a(3), b(3);
+    for(size_t i=0;i<3;i++) {
+      a[i]=0.0;
+      b[i]=M_PI;
+    }
+    
+    multi_funct tf=test_fun;
+    mcarlo_batch_funct tfb=test_fun_batch;
+    double res, err, res_b, err_b;
+
+    mcarlo_vegas<> gm, gm_b;
+    gm.n_points=100000;
+    gm.n_threads=3;
+    gm.minteg_err(tf,3,a,b,res,err);
+    res-=0.1*pow(M_PI,3.0);
+    t.test_rel(res,exact,err*10.0,"threads");
+
+    // The same seed and number of threads gives the same result
+    gm_b.n_points=100000;
+    gm_b.n_threads=3;
+    gm_b.minteg_err_batch(tfb,3,a,b,res_b,err_b);
+    res_b-=0.1*pow(M_PI,3.0);
+    t.test_gen(res==res_b && err==err_b,"threads batch");
+  }
+
   for(int v=1;v<=3;v++) {
 
     cout << "Testing verbose output: " << v << endl;
@@ -42,6 +42,7 @@
 #include <o2scl/uniform_grid.h>
 #include <o2scl/table3d.h>
 #include <o2scl/hdf_file.h>
+#include <o2scl/hdf_io.h>
 #include <o2scl/exception.h>
 #include <o2scl/prob_dens_func.h>
 #include <o2scl/vector.h>
@@ -1962,6 +1963,9 @@ namespace o2scl {
       
     }
     
+    // Ensure the first write in append mode outputs the full table
+    append_rows=0;
+    
     last_write_iters=0;
 #ifdef O2SCL_MPI
     last_write_time=MPI_Wtime();
@@ -2040,6 +2044,32 @@ namespace o2scl {
       and set back to <tt>false</tt> after mcmc_init() is called.
   */
   bool prev_read;
+
+  /** \brief The number of rows at the beginning of the table 
+      which have been written to the file in append mode and 
+      will not be modified
+  */
+  size_t append_rows;
+
+  /** \brief Return the number of rows at the beginning of the
+      table which will not be modified by later MCMC steps
+
+      New rows for each walker are always stored after its most
+      recent accepted or rejected row, and only the multiplier of the
+      most recent accepted row is modified, so all rows before the
+      smallest entry in \ref walker_accept_rows are final.
+  */
+  size_t final_rows() {
+    size_t nlines=table->get_nlines();
+    size_t ret=nlines;
+    for(size_t i=0;i<walker_accept_rows.size();i++) {
+      if (walker_accept_rows[i]<0) return 0;
+      if (((size_t)walker_accept_rows[i])<ret) {
+	ret=walker_accept_rows[i];
+      }
+    }
+    return ret;
+  }
   
   public:
 
@@ -2070,27 +2100,45 @@ namespace o2scl {
   /** \brief If true, store MCMC rejections in the table
    */
   bool store_rejects;
+
+  /** \brief If true, write only the new rows of the table to the
+      HDF5 file during file updates (default false)
+
+      In append mode, each call to \ref write_files() writes only
+      the table rows which were added or modified since the previous
+      call, extending the datasets in the file, so the cost of a file
+      update does not grow with the length of the chain. The file has
+      the same format as the one produced when this flag is false,
+      so it can be read by \ref read_prev_results(). In this mode,
+      \ref table_io_chunk is ignored and each MPI rank writes its
+      own table to its own file.
+  */
+  bool file_append;
   //@}
   
   /** \brief Write MCMC tables to files
    */
   virtual void write_files(bool sync_write=false) {
 
+    // In append mode, tables are not combined before output
+    int io_chunk=table_io_chunk;
+    if (file_append) io_chunk=1;
+    
     if (this->verbose>=2) {
       this->scr_out << "mcmc: Start write_files(). mpi_rank: "
 		    << this->mpi_rank << " mpi_size: "
 		    << this->mpi_size <<  " table_io_chunk: "
-		    << table_io_chunk << std::endl;
+		    << io_chunk << std::endl;
     }
     
     std::vector<o2scl::table_units<> > tab_arr;
     bool rank_sent=false;
     
 #ifdef O2SCL_MPI
-    if (table_io_chunk>1) {
-      if (this->mpi_rank%table_io_chunk==0) {
+    if (io_chunk>1) {
+      if (this->mpi_rank%io_chunk==0) {
 	// Parent ranks
-	for(int i=0;i<table_io_chunk-1;i++) {
+	for(int i=0;i<io_chunk-1;i++) {
 	  int child=this->mpi_rank+i+1;
 	  if (child<this->mpi_size) {
 	    table_units<> t;
@@ -2100,7 +2148,7 @@ namespace o2scl {
 	}
       } else {
 	// Child ranks
-	size_t parent=this->mpi_rank-(this->mpi_rank%table_io_chunk);
+	size_t parent=this->mpi_rank-(this->mpi_rank%io_chunk);
 	o2scl_table_mpi_send(*table,parent);
 	rank_sent=true;
       }
@@ -2112,8 +2160,8 @@ namespace o2scl {
     // filesystem at the same time
     int tag=0, buffer=0;
     if (sync_write && this->mpi_size>1 &&
-	this->mpi_rank>=table_io_chunk) {
-      MPI_Recv(&buffer,1,MPI_INT,this->mpi_rank-table_io_chunk,
+	this->mpi_rank>=io_chunk) {
+      MPI_Recv(&buffer,1,MPI_INT,this->mpi_rank-io_chunk,
 	       tag,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
     }
 #endif
@@ -2162,7 +2210,18 @@ namespace o2scl {
 		       this->initial_points);
 
     hf.seti("n_tables",tab_arr.size()+1);
-    if (rank_sent==false) {
+    if (file_append) {
+      // Write the rows which may have changed since the last write,
+      // using large chunks since the datasets will be extended
+      size_t nfinal=final_rows();
+      hdf_output_rows(hf,*table,"markov_chain_0",append_rows,10000);
+      append_rows=nfinal;
+      if (this->verbose>=2) {
+	this->scr_out << "mcmc: Appended rows up to "
+		      << table->get_nlines() << ", " << nfinal
+		      << " rows are final." << std::endl;
+      }
+    } else if (rank_sent==false) {
       hdf_output(hf,*table,"markov_chain_0");
     }
     for(size_t i=0;i<tab_arr.size();i++) {
@@ -2175,7 +2234,7 @@ namespace o2scl {
 #ifdef O2SCL_MPI
     if (sync_write && this->mpi_size>1 &&
 	this->mpi_rank<this->mpi_size-1) {
-      MPI_Send(&buffer,1,MPI_INT,this->mpi_rank+table_io_chunk,
+      MPI_Send(&buffer,1,MPI_INT,this->mpi_rank+io_chunk,
 	       tag,MPI_COMM_WORLD);
     }
 #endif
@@ -2196,6 +2255,8 @@ namespace o2scl {
     table_sequence=true;
     prev_read=false;
     table_prealloc=0;
+    file_append=false;
+    append_rows=0;
   }
   
   /// \name Basic usage
@@ -2792,8 +2853,8 @@ namespace o2scl {
       // we have a rejection and there isn't room to store it.
       if (next_row>=((int)table->get_nlines())) {
 	size_t istart=table->get_nlines();
-	// Create enough space
-	table->set_nlines(table->get_nlines()+ntot);
+	// Create enough space, growing the table geometrically
+	table->set_nlines_auto(table->get_nlines()+ntot);
 	// Now additionally initialize the first four colums
 	for(size_t j=0;j<this->n_threads;j++) {
 	  for(size_t i=0;i<this->n_walk;i++) {
@@ -3103,6 +3164,7 @@ namespace o2scl {
   //o2scl::cli::parameter_int p_max_chain_size;
   o2scl::cli::parameter_size_t p_file_update_iters;
   o2scl::cli::parameter_double p_file_update_time;
+  o2scl::cli::parameter_bool p_file_append;
   //o2scl::cli::parameter_bool p_output_meas;
   o2scl::cli::parameter_string p_prefix;
   o2scl::cli::parameter_int p_verbose;
@@ -3250,6 +3312,11 @@ namespace o2scl {
       "(default false).";
     cl.par_list.insert(std::make_pair("store_rejects",&p_store_rejects));
 
+    p_file_append.b=&this->file_append;
+    p_file_append.help=((std::string)"If true, file updates write only ")+
+      "the new rows of the table (default false).";
+    cl.par_list.insert(std::make_pair("file_append",&p_file_append));
+
     p_couple_threads.b=&this->couple_threads;
     p_couple_threads.help="help";
     cl.par_list.insert(std::make_pair("couple_threads",&p_couple_threads));
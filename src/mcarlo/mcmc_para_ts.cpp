@@ -408,6 +408,43 @@ int main(int argc, char *argv[]) {
   }
   cout << endl;
 
+  {
+    // ----------------------------------------------------------------
+    // Affine-invariant MCMC with a table and append-mode file output
+    
+    cout << "Affine-invariant MCMC with append-mode file output: " << endl;
+
+    mpc.mct.verbose=1;
+    mpc.mct.store_rejects=true;
+    mpc.mct.prefix="mcmct_append";
+    mpc.mct.file_append=true;
+    mpc.mct.file_update_iters=20;
+    
+    mpc.mct.mcmc_fill(1,low,high,gauss_vec,fill_vec);
+    table=mpc.mct.get_table();
+
+    // Compare the table in the file with the final table
+    table_units<> tab_file;
+    hdf_file hf;
+    hf.open("mcmct_append_0_out");
+    hdf_input(hf,tab_file,"markov_chain_0");
+    hf.close();
+
+    bool same=(tab_file.get_nlines()==table->get_nlines() &&
+	       tab_file.get_ncolumns()==table->get_ncolumns());
+    for(size_t i=0;same && i<table->get_ncolumns();i++) {
+      for(size_t j=0;j<table->get_nlines();j++) {
+	if (tab_file.get(i,j)!=table->get(i,j)) same=false;
+      }
+    }
+    tm.test_gen(same,"append mode table");
+    
+    mpc.mct.store_rejects=false;
+    mpc.mct.file_append=false;
+    mpc.mct.file_update_iters=0;
+    cout << endl;
+  }
+
   if (true) {
     
     // ----------------------------------------------------------------
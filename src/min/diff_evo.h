@@ -30,6 +30,10 @@
 #include <vector>
 #include <algorithm>
 
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
+
 #include <o2scl/rng_gsl.h>
 #include <o2scl/mmin.h>
 #include <o2scl/mm_funct.h>
@@ -67,13 +71,23 @@ namespace o2scl {
       If the population converges prematurely, then \ref diff_evo::f
       and \ref pop_size should be increased.
 
+      The version of mmin() which takes a vector of functions
+      evaluates the trial vectors using \ref n_threads OpenMP
+      threads, one function object for each thread. By default, all
+      of the trial vectors for a generation are created from the
+      population at the beginning of that generation, then evaluated
+      in parallel, and then compared with the population in order.
+      The result thus does not depend on the number of threads. If
+      \ref async is true, then each thread instead creates a new
+      trial vector from the current population as soon as it
+      finishes the previous evaluation, which keeps all of the
+      threads busy when the function evaluation times vary, at the
+      cost of results which depend on the thread timing.
+
       \future AWS, 7/25/19, The code stops early if \ref nconv
       generations go by without a better fit, but we could also
       consider some code which terminates early if the minimum is
       found to within a particular tolerance.
-
-      \future This class probably has a simple parallelization like 
-      \ref o2scl::anneal_para ?
   */
   template<class func_t=multi_funct, 
 	   class vec_t=boost::numeric::ublas::vector<double> , 
@@ -112,6 +126,20 @@ namespace o2scl {
     */
     double cr;
 
+    /** \brief The number of OpenMP threads used by the version of
+	mmin() which takes a vector of functions (default 1)
+    */
+    size_t n_threads;
+
+    /** \brief If true, evaluate the trial vectors asynchronously
+	in the version of mmin() which takes a vector of functions
+	(default false)
+
+	In this mode, a generation is counted each time \ref pop_size
+	trial vectors have been evaluated.
+    */
+    bool async;
+
     diff_evo() {
       this->ntrial=1000;
       f = 0.75;
@@ -119,6 +147,8 @@ namespace o2scl {
       rand_init_funct = 0;
       pop_size = 0;
       nconv = 25;
+      n_threads = 1;
+      async = false;
       step.resize(1);
       step[0]=1.0e-2;
     }
@@ -212,57 +242,19 @@ namespace o2scl {
 	// For each agent x in the population do: 
 	for (size_t x = 0; x < pop_size; ++x) {
 
-	  std::vector<int> others;
-
-	  // Create a copy agent_x and agent_y of the current agent
-	  // vector
-	  vec_t agent_x, agent_y;
-	  agent_x.resize(nvar);
-	  agent_y.resize(nvar);
-	  for (size_t i = 0; i < nvar; ++i) {
-	    agent_x[i] = population[x*nvar+i];
-	    agent_y[i] = population[x*nvar+i];
-	  }
-                            
-	  // Pick three agents a, b, and c from the population at 
-	  // random, they must be distinct from each other as well as
-	  // from agent x
-	  others = pick_unique_agents( 3, x );
-
-	  // Pick a random index R in {1, ..., n}, where the highest 
-	  // possible value n is the dimensionality of the problem 
-	  // to be optimized.
-	  size_t r = floor(gr.random()*nvar);
-
-	  for (size_t i = 0; i < nvar; ++i) {
-	    // Pick ri~U(0,1) uniformly from the open range (0,1)
-	    double ri = gr.random();
-	    // If (i=R) or (ri<CR) let yi = ai + F(bi - ci), otherwise 
-	    // let yi = xi
-	    if (i == r || ri < cr) {
-	      agent_y[i] = population[others[0]*nvar+i] + 
-		f*(population[others[1]*nvar+i]-
-		   population[others[2]*nvar+i]);
-	    }
-	  }
+	  // Create the trial vector
+	  vec_t agent_y(nvar);
+	  double f_x, cr_x;
+	  make_trial(nvar,x,agent_y,f_x,cr_x);
+	  
 	  // If (f(y) < f(x)) then replace the agent in the population 
 	  // with the improved candidate solution, that is, set x = y 
 	  // in the population
 	  double fmin_y;
                             
 	  fmin_y=func(nvar,agent_y);
-	  if (fmin_y<fmins[x]) {
-	    for (size_t i = 0; i < nvar; ++i) {
-	      population[x*nvar+i] = agent_y[i];
-	      fmins[x] = fmin_y;
-	    }
-	    if (fmin_y<fmin) {
-	      fmin = fmin_y;
-	      for (size_t i = 0; i<nvar; ++i) {  
-		x0[i] = agent_y[i];
-	      }
-	      nconverged = 0;
-	    }
+	  if (select_trial(nvar,x,agent_y,fmin_y,f_x,cr_x,x0,fmin)) {
+	    nconverged = 0;
 	  }
 
 	}
@@ -282,6 +274,118 @@ namespace o2scl {
       return 0;
     };
 
+    /** \brief Calculate the minimum \c fmin of \c func w.r.t the 
+	array \c x of size \c nvar using \ref n_threads OpenMP
+	threads
+
+	The function object <tt>func[i]</tt> is used in thread \c i.
+	If there are fewer function objects than threads, then only
+	one thread is used for each function object. The value of
+	\ref n_threads is not modified.
+    */
+    virtual int mmin(size_t nvar, vec_t &x0, double &fmin,
+		     std::vector<func_t> &func) {
+
+      if (func.size()==0) {
+	O2SCL_ERR2("No functions specified in ",
+		   "diff_evo::mmin().",exc_einval);
+      }
+      
+      // Check that enough function objects were passed
+      size_t nt=n_threads;
+      if (func.size()<nt) {
+	if (this->verbose>0) {
+	  std::cout << "diff_evo::mmin(): Not enough functions for "
+		    << nt << " threads. Using " << func.size()
+		    << " threads." << std::endl;
+	}
+	nt=func.size();
+      }
+      if (nt==0) nt=1;
+#ifndef O2SCL_OPENMP
+      nt=1;
+#endif
+      
+      // Keep track of number of generation without better solutions
+      size_t nconverged = 0;
+
+      if (pop_size==0) {
+	// Automatically select pop_size based on on dimensionality.
+	pop_size = 10*nvar;
+      }
+
+      initialize_population( nvar, x0 );
+      
+      fmins.resize(pop_size);
+
+      std::vector<vec_t> trials(pop_size);
+      std::vector<double> f_trials(pop_size), f_x(pop_size);
+      std::vector<double> cr_x(pop_size);
+      for (size_t x = 0; x < pop_size; ++x) {
+	trials[x].resize(nvar);
+	for (size_t i = 0; i < nvar; ++i) {
+	  trials[x][i] = population[x*nvar+i];
+	}
+      }
+
+      // Set initial fmin
+      eval_trials(nvar,trials,f_trials,func,nt);
+      for (size_t x = 0; x < pop_size; ++x) {
+	fmins[x]=f_trials[x];
+	if (x==0 || f_trials[x]<fmin) {
+	  fmin = f_trials[x];
+	  for (size_t i = 0; i<nvar; ++i) {
+	    x0[i] = trials[x][i];
+	  }
+	}
+      }
+
+      size_t gen = 0;
+
+      if (async) {
+	
+	mmin_async(nvar,x0,fmin,func,gen,nt);
+	
+      } else {
+	
+	while (gen < ((size_t)this->ntrial) && nconverged <= nconv) {
+	  
+	  ++nconverged;
+	  ++gen;
+
+	  // Create all of the trial vectors from the current
+	  // population
+	  for (size_t x = 0; x < pop_size; ++x) {
+	    make_trial(nvar,x,trials[x],f_x[x],cr_x[x]);
+	  }
+
+	  eval_trials(nvar,trials,f_trials,func,nt);
+
+	  // Compare with the population in order
+	  for (size_t x = 0; x < pop_size; ++x) {
+	    if (select_trial(nvar,x,trials[x],f_trials[x],f_x[x],cr_x[x],
+			     x0,fmin)) {
+	      nconverged = 0;
+	    }
+	  }
+	  
+	  if (this->verbose > 0) {
+	    this->print_iter( nvar, fmin, gen, x0 );
+	  }
+	}
+      }
+
+      this->last_ntrial=gen;
+      
+      if (gen>=((size_t)this->ntrial)) {
+	std::string str="Exceeded maximum number of iterations ("+
+	  itos(this->ntrial)+") in diff_evo::mmin().";
+	O2SCL_CONV_RET(str.c_str(),exc_emaxiter,this->err_nonconv);
+      }
+
+      return 0;
+    }
+
     /** \brief Print out iteration information.
 
 	\comment
@@ -407,6 +511,177 @@ namespace o2scl {
       return agents;
     }
 
+    /** \brief Create the trial vector \c agent_y for agent \c x
+	using the differential weight \c f_x and the crossover
+	probability \c cr_x
+    */
+    void crossover(size_t nvar, size_t x, vec_t &agent_y, double f_x,
+		   double cr_x) {
+      
+      for (size_t i = 0; i < nvar; ++i) {
+	agent_y[i] = population[x*nvar+i];
+      }
+      
+      // Pick three agents a, b, and c from the population at 
+      // random, they must be distinct from each other as well as
+      // from agent x
+      std::vector<int> others = pick_unique_agents( 3, x );
+
+      // Pick a random index R in {1, ..., n}, where the highest 
+      // possible value n is the dimensionality of the problem 
+      // to be optimized.
+      size_t r = floor(gr.random()*nvar);
+
+      for (size_t i = 0; i < nvar; ++i) {
+	// Pick ri~U(0,1) uniformly from the open range (0,1)
+	double ri = gr.random();
+	// If (i=R) or (ri<CR) let yi = ai + F(bi - ci), otherwise 
+	// let yi = xi
+	if (i == r || ri < cr_x) {
+	  agent_y[i] = population[others[0]*nvar+i] + 
+	    f_x*(population[others[1]*nvar+i]-
+		 population[others[2]*nvar+i]);
+	}
+      }
+      
+      return;
+    }
+    
+    /** \brief Create the trial vector \c agent_y for agent \c x,
+	and return the differential weight and crossover probability
+	which were used
+    */
+    virtual void make_trial(size_t nvar, size_t x, vec_t &agent_y,
+			    double &f_x, double &cr_x) {
+      f_x=f;
+      cr_x=cr;
+      crossover(nvar,x,agent_y,f_x,cr_x);
+      return;
+    }
+
+    /** \brief Function called when the trial vector created with
+	\c f_x and \c cr_x replaces agent \c x
+    */
+    virtual void accept_trial(size_t x, double f_x, double cr_x) {
+      return;
+    }
+
+    /** \brief Replace agent \c x with the trial vector \c agent_y
+	if it is better, and return true if it is better than \c fmin
+    */
+    bool select_trial(size_t nvar, size_t x, const vec_t &agent_y,
+		      double fmin_y, double f_x, double cr_x, vec_t &x0,
+		      double &fmin) {
+      if (fmin_y<fmins[x]) {
+	for (size_t i = 0; i < nvar; ++i) {
+	  population[x*nvar+i] = agent_y[i];
+	}
+	fmins[x] = fmin_y;
+	accept_trial(x,f_x,cr_x);
+	if (fmin_y<fmin) {
+	  fmin = fmin_y;
+	  for (size_t i = 0; i<nvar; ++i) {  
+	    x0[i] = agent_y[i];
+	  }
+	  return true;
+	}
+      }
+      return false;
+    }
+
+    /** \brief Evaluate the trial vectors in parallel using \c nt
+	threads
+     */
+    void eval_trials(size_t nvar, std::vector<vec_t> &trials,
+		     std::vector<double> &f_trials,
+		     std::vector<func_t> &func, size_t nt) {
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(nt) schedule(dynamic)
+#endif
+      for (size_t x = 0; x < trials.size(); ++x) {
+	size_t it=0;
+#ifdef O2SCL_OPENMP
+	it=omp_get_thread_num();
+#endif
+	f_trials[x]=func[it](nvar,trials[x]);
+      }
+      return;
+    }
+
+    /** \brief The asynchronous version of the main loop of
+	mmin() using \c nt threads
+
+	Each thread creates a trial vector for the next agent, in
+	order, from the current population, evaluates it, and then
+	compares it with the population. The creation of trial
+	vectors and the comparisons are performed one thread at a
+	time.
+    */
+    void mmin_async(size_t nvar, vec_t &x0, double &fmin,
+		    std::vector<func_t> &func, size_t &gen, size_t nt) {
+
+      size_t nconverged = 0;
+      size_t next_agent = 0;
+      size_t n_evals = 0;
+      bool done = (this->ntrial<=0);
+      
+#ifdef O2SCL_OPENMP
+#pragma omp parallel num_threads(nt)
+#endif
+      {
+	size_t it=0;
+#ifdef O2SCL_OPENMP
+	it=omp_get_thread_num();
+#endif
+	vec_t agent_y(nvar);
+	double f_x, cr_x;
+	size_t x=0;
+	bool stop=false;
+
+	while (true) {
+
+#ifdef O2SCL_OPENMP
+#pragma omp critical (diff_evo_async)
+#endif
+	  {
+	    if (done) {
+	      stop=true;
+	    } else {
+	      x=next_agent;
+	      next_agent=(next_agent+1)%pop_size;
+	      make_trial(nvar,x,agent_y,f_x,cr_x);
+	    }
+	  }
+	  if (stop) break;
+
+	  double fmin_y=func[it](nvar,agent_y);
+
+#ifdef O2SCL_OPENMP
+#pragma omp critical (diff_evo_async)
+#endif
+	  {
+	    if (select_trial(nvar,x,agent_y,fmin_y,f_x,cr_x,x0,fmin)) {
+	      nconverged = 0;
+	    }
+	    n_evals++;
+	    if (!done && n_evals%pop_size==0) {
+	      ++gen;
+	      ++nconverged;
+	      if (this->verbose > 0) {
+		this->print_iter( nvar, fmin, gen, x0 );
+	      }
+	      if (gen >= ((size_t)this->ntrial) || nconverged > nconv) {
+		done=true;
+	      }
+	    }
+	  }
+	}
+      }
+      // End of parallel region
+      
+      return;
+    }
+
 #endif
 
 #ifndef DOXYGEN_INTERNAL
@@ -51,6 +51,9 @@ namespace o2scl {
       \verbatim embed:rst
       [Brest06]_ .
       \endverbatim
+
+      The parallel version of \ref diff_evo::mmin() is also
+      available here.
   */
   template<class func_t=multi_funct, 
     class vec_t=boost::numeric::ublas::vector<double>, 
@@ -79,137 +82,6 @@ namespace o2scl {
       fr = 0.9;
     }
 
-    /** \brief Calculate the minimum \c fmin of \c func w.r.t the 
-	array \c x of size \c nvar.
-    */
-    virtual int mmin(size_t nvar, vec_t &x0, double &fmin,
-		     func_t &func) {
-
-      // Keep track of number of generation without better solutions
-      int nconverged = 0;
-      if (this->pop_size==0) {
-	// Automatically select pop_size dependent on dimensionality.
-	this->pop_size = 10*nvar;
-      }
-
-      initialize_population( nvar, x0 );
-      fmins.resize(this->pop_size);
-
-      // Set initial fmin
-      for (size_t x = 0; x < this->pop_size; ++x) {
-	vec_t agent_x;
-	agent_x.resize(nvar);
-	for (size_t i = 0; i < nvar; ++i) {
-	  agent_x[i] = this->population[x*nvar+i];
-	}
-	double fmin_x = 0;
-	fmin_x=func(nvar,agent_x);
-	fmins[x]=fmin_x;
-	if (x==0) {
-	  fmin = fmin_x;
-	  for (size_t i = 0; i<nvar; ++i) {
-	    x0[i] = agent_x[i];
-	  }
-	} else if (fmin_x<fmin) {
-	  fmin = fmin_x;
-	  for (size_t i = 0; i<nvar; ++i) {
-	    x0[i] = agent_x[i];
-	  }
-	}
-
-      }
-
-      int gen = 0;
-      while (gen < this->ntrial && nconverged <= ((int)this->nconv)) {
-	++nconverged;
-	++gen;
-
-	// For each agent x in the population do: 
-	for (size_t x = 0; x < this->pop_size; ++x) {
-
-	  std::vector<int> others;
-
-	  // Create a copy agent_x and agent_y of the current agent vector
-	  vec_t agent_x, agent_y;
-	  agent_x.resize(nvar);
-	  agent_y.resize(nvar);
-	  for (size_t i = 0; i < nvar; ++i) {
-	    agent_x[i] = this->population[x*nvar+i];
-	    agent_y[i] = this->population[x*nvar+i];
-	  }
-	  // Value of f and cr for this agent
-	  double f_x, cr_x;
-	  if (this->gr.random() >= tau_1) {
-	    f_x = variables[x*2];
-	  } else {
-	    f_x = fl+this->gr.random()*fr;
-	  } if (this->gr.random() >= tau_2) {
-	    cr_x = variables[x*2+1];
-	  } else {
-	    cr_x = this->gr.random();
-	  }
-                            
-	  // Pick three agents a, b, and c from the population at 
-	  // random, they must be distinct from each other as well 
-	  // as from agent x
-	  others = this->pick_unique_agents( 3, x );
-
-	  // Pick a random index R in {1, ..., n}, where the highest 
-	  // possible value n is the dimensionality of the problem 
-	  // to be optimized.
-	  size_t r = floor(this->gr.random()*nvar);
-
-	  for (size_t i = 0; i < nvar; ++i) {
-	    // Pick ri~U(0,1) uniformly from the open range (0,1)
-	    double ri = this->gr.random();
-	    // If (i=R) or (ri<CR) let yi = ai + F(bi - ci), 
-	    // otherwise let yi = xi
-	    if (i == r || ri < cr_x) {
-	      agent_y[i] = this->population[others[0]*nvar+i] + 
-		f_x*(this->population[others[1]*nvar+i]-
-		     this->population[others[2]*nvar+i]);
-	    }
-	  }
-	  // If (f(y) < f(x)) then replace the agent in the 
-	  // population with the improved candidate solution, that is, 
-	  // set x = y in the population
-	  double fmin_y;
-                            
-	  fmin_y=func(nvar,agent_y);
-	  if (fmin_y<fmins[x]) {
-	    for (size_t i = 0; i < nvar; ++i) {
-	      this->population[x*nvar+i] = agent_y[i];
-	      fmins[x] = fmin_y;
-	    }
-                                
-	    variables[x*2] = f_x;
-	    variables[x*2+1] = cr_x;
-
-	    if (fmin_y<fmin) {
-	      fmin = fmin_y;
-	      for (size_t i = 0; i<nvar; ++i) {  
-		x0[i] = agent_y[i];
-	      }
-	      nconverged = 0;
-	    }
-	  }
-
-	}
-	if (this->verbose > 0) {
-	  this->print_iter( nvar, fmin, gen, x0 );
-	}
-      }
-      
-      this->last_ntrial=gen;
-      
-      if (gen>=this->ntrial) {
-	std::string str="Exceeded maximum number of iterations ("+
-	itos(this->ntrial)+") in diff_evo_adapt::mmin().";
-	O2SCL_CONV_RET(str.c_str(),exc_emaxiter,this->err_nonconv);
-      }
-      return 0;
-    };
-
     /** \brief Print out iteration information
      */
     virtual void print_iter(size_t nvar, double fmin, 
@@ -228,7 +100,7 @@ namespace o2scl {
 	for (size_t j = 0; j<nvar; ++j ) {
 	  std::cout << this->population[i*nvar+j] << " ";
 	}
-	std::cout << "fmin: " << fmins[i] << 
+	std::cout << "fmin: " << this->fmins[i] << 
 	  " F: " << variables[i*2] <<
 	  " CR: " << variables[i*2+1] << std::endl;
       }
@@ -247,9 +119,35 @@ namespace o2scl {
     /** \brief Vector containing the tunable variable F and CR
      */
     vec_t variables;
+
+    /** \brief Create the trial vector \c agent_y for agent \c x,
+	adjusting F and CR with probabilities \ref tau_1 and \ref
+	tau_2
+    */
+    virtual void make_trial(size_t nvar, size_t x, vec_t &agent_y,
+			    double &f_x, double &cr_x) {
+      if (this->gr.random() >= tau_1) {
+	f_x = variables[x*2];
+      } else {
+	f_x = fl+this->gr.random()*fr;
+      }
+      if (this->gr.random() >= tau_2) {
+	cr_x = variables[x*2+1];
+      } else {
+	cr_x = this->gr.random();
+      }
+      this->crossover(nvar,x,agent_y,f_x,cr_x);
+      return;
+    }
     
-    /// Vector that keeps track of fmins values
-    ubvector fmins;
+    /** \brief Store the values of F and CR which produced
+	the new agent \c x
+    */
+    virtual void accept_trial(size_t x, double f_x, double cr_x) {
+      variables[x*2] = f_x;
+      variables[x*2+1] = cr_x;
+      return;
+    }
 
     /** \brief Initialize a population of random agents
      */
@@ -81,6 +81,50 @@ int main(int argc, char *argv[]) {
   t.test_rel(init[1],-3.0,1.0e-2,"another test - value 2");
   t.test_rel(result,-1.0,1.0e-2,"another test - min");
 
+  // Evaluate the population in parallel, first with the
+  // generation-synchronous and then with the asynchronous method
+  for(size_t k=0;k<2;k++) {
+    diff_evo<multi_funct> de2;
+    vector<multi_funct> vfx(2,fx);
+    de2.set_init_function(init_f);
+    de2.ntrial=1000;
+    de2.n_threads=2;
+    de2.async=(k==1);
+    de2.mmin(2,init,result,vfx);
+    t.test_rel(init[0],2.0,1.0e-2,"parallel - value");
+    t.test_rel(init[1],-3.0,1.0e-2,"parallel - value 2");
+    t.test_rel(result,-1.0,1.0e-2,"parallel - min");
+  }
+
+  // With the same seed, the synchronous method gives the same
+  // result for any number of threads
+  ubvector init_thr[2];
+  double result_thr[2];
+  for(size_t k=0;k<2;k++) {
+    gr.set_seed(10);
+    diff_evo<multi_funct> de3;
+    vector<multi_funct> vfx(3,fx);
+    de3.set_init_function(init_f);
+    de3.ntrial=1000;
+    de3.n_threads=(k==0 ? 1 : 3);
+    init_thr[k].resize(2);
+    de3.mmin(2,init_thr[k],result_thr[k],vfx);
+  }
+  t.test_gen(result_thr[0]==result_thr[1],"same seed - min");
+  t.test_gen(init_thr[0][0]==init_thr[1][0] &&
+	     init_thr[0][1]==init_thr[1][1],"same seed - value");
+  
+  // The value of n_threads is not modified if there are fewer
+  // functions than threads
+  diff_evo<multi_funct> de4;
+  vector<multi_funct> vfx1(1,fx);
+  de4.set_init_function(init_f);
+  de4.ntrial=1000;
+  de4.n_threads=4;
+  de4.mmin(2,init,result,vfx1);
+  t.test_gen(de4.n_threads==4,"n_threads unchanged");
+  t.test_rel(result,-1.0,1.0e-2,"one function - min");
+
   t.report();
   
   return 0;
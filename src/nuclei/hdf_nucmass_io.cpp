@@ -98,7 +98,6 @@ void o2scl_hdf::ame_load_ext(o2scl::nucmass_ame &ame, std::string file_name,
   ame.n=nrecords;
   ame.mass=m;
   ame.reference=reference;
-  ame.last=nrecords/2;
     
   if (exp_only) {
 
@@ -119,8 +118,9 @@ void o2scl_hdf::ame_load_ext(o2scl::nucmass_ame &ame, std::string file_name,
     ame.n=n_exp;
     ame.mass=m2;
     ame.reference=reference;
-    ame.last=n_exp/2;
   }
+
+  ame.build_index_entries(ame.n,ame.mass,true);
       
   hf.close();
 
@@ -343,6 +343,57 @@ int nucmass::get_nucleus(int Z, int N, nucleus &n) {
   return 0;
 }
 
+const size_t nucmass_table::no_entry;
+
+void nucmass_table::clear_index() {
+  zn_index.clear();
+  ix_Zmin=0;
+  ix_Nmin=0;
+  ix_nZ=0;
+  ix_nN=0;
+  return;
+}
+
+void nucmass_table::build_index(const std::vector<int> &Zv,
+				const std::vector<int> &Nv, bool keep_last) {
+
+  if (Zv.size()!=Nv.size()) {
+    O2SCL_ERR2("Vector sizes do not match in ",
+	       "nucmass_table::build_index().",exc_einval);
+  }
+  
+  clear_index();
+  if (Zv.size()==0) return;
+
+  int Zmax=Zv[0], Nmax=Nv[0];
+  ix_Zmin=Zv[0];
+  ix_Nmin=Nv[0];
+  for(size_t i=1;i<Zv.size();i++) {
+    if (Zv[i]<ix_Zmin) ix_Zmin=Zv[i];
+    if (Zv[i]>Zmax) Zmax=Zv[i];
+    if (Nv[i]<ix_Nmin) ix_Nmin=Nv[i];
+    if (Nv[i]>Nmax) Nmax=Nv[i];
+  }
+  ix_nZ=Zmax-ix_Zmin+1;
+  ix_nN=Nmax-ix_Nmin+1;
+  
+  zn_index.resize(ix_nZ*ix_nN,no_entry);
+  for(size_t i=0;i<Zv.size();i++) {
+    size_t &ix=zn_index[(Zv[i]-ix_Zmin)*ix_nN+(Nv[i]-ix_Nmin)];
+    if (keep_last || ix==no_entry) ix=i;
+  }
+  
+  return;
+}
+
+bool nucmass_table::is_included(int Z, int N) {
+  if (n==0) {
+    O2SCL_ERR("No masses loaded in nucmass_table::is_included().",
+	      exc_einval);
+  }
+  return find_ZN(Z,N)!=no_entry;
+}
+
 double nucmass_table::mass_excess_d(double Z, double N) {
   int Z1=(int)Z;
   int N1=(int)N;
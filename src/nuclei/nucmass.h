@@ -29,6 +29,7 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 #include <map>
 
 #include <boost/numeric/ublas/vector.hpp>
@@ -361,17 +362,90 @@ namespace o2scl {
       Generally, descendants of this class only need to provide an
       implementation of \ref mass_excess() and possibly a version
       of \ref nucmass::is_included()
-      
+
+      Descendants should call \ref build_index() after the table has
+      been loaded. This creates a dense array indexed by proton and
+      neutron number which gives the location of each nucleus in the
+      table, so that \ref find_ZN() and the default version of \ref
+      is_included() take a constant time independent of the size of
+      the table. Nuclei which are not present are marked with \ref
+      no_entry. For a typical table with \f$ Z \leq 120 \f$ and \f$
+      N \leq 300 \f$ the index requires about 300 kB.
   */
   class nucmass_table : public nucmass {
 
   protected:
+
+    /// \name Index of nuclei by proton and neutron number
+    //@{
+    /// The smallest proton number in the index
+    int ix_Zmin;
+    /// The smallest neutron number in the index
+    int ix_Nmin;
+    /// The number of proton numbers in the index
+    size_t ix_nZ;
+    /// The number of neutron numbers in the index
+    size_t ix_nN;
+    /// The table row for each \f$ (Z,N) \f$ pair
+    std::vector<size_t> zn_index;
+    //@}
+
+    /** \brief Create the index from the proton and neutron numbers
+	of each table row
+
+	If \c keep_last is true and a nucleus appears more than once,
+	then the index refers to the last row containing it, otherwise
+	it refers to the first.
+    */
+    void build_index(const std::vector<int> &Zv,
+		     const std::vector<int> &Nv, bool keep_last=false);
+    
+    /** \brief Create the index from an array of \c n_entries
+	table entries which have integer members \c Z and \c N
+    */
+    template<class entry_t>
+      void build_index_entries(size_t n_entries, const entry_t *m,
+			       bool keep_last=false) {
+      std::vector<int> Zv(n_entries), Nv(n_entries);
+      for(size_t i=0;i<n_entries;i++) {
+	Zv[i]=m[i].Z;
+	Nv[i]=m[i].N;
+      }
+      build_index(Zv,Nv,keep_last);
+      return;
+    }
+
+    /// Remove the index
+    void clear_index();
     
   public:
 
     nucmass_table() {
       n=0;
+      ix_Zmin=0;
+      ix_Nmin=0;
+      ix_nZ=0;
+      ix_nN=0;
     }
+
+    /// The value returned by \ref find_ZN() for missing nuclei
+    static const size_t no_entry=((size_t)-1);
+    
+    /** \brief Return the table row for the nucleus with \c Z 
+	protons and \c N neutrons, or \ref no_entry if it is not
+	present
+    */
+    size_t find_ZN(int Z, int N) const {
+      if (Z<ix_Zmin || N<ix_Nmin) return no_entry;
+      size_t iZ=Z-ix_Zmin, iN=N-ix_Nmin;
+      if (iZ>=ix_nZ || iN>=ix_nN) return no_entry;
+      return zn_index[iZ*ix_nN+iN];
+    }
+    
+    /** \brief Return false if the table does not contain the 
+	specified nucleus
+    */
+    virtual bool is_included(int Z, int N);
     
     /// The number of entries
     size_t n;
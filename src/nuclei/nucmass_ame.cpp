@@ -32,7 +32,6 @@ nucmass_ame::nucmass_ame() {
   n=0;
   reference="";
   mass=0;
-  last=0;
 }
 
 nucmass_ame::~nucmass_ame() {
@@ -55,73 +54,7 @@ bool nucmass_ame::is_included(int l_Z, int l_N) {
 		  exc_einval);
   }
 
-  if (false) {
-
-    int l_A=l_Z+l_N, mid=last, lo=0, hi=0;
-
-    // Binary search for the correct A first
-    if (mass[mid].Z+mass[mid].N!=l_A) {
-      if (mass[mid].Z+mass[mid].N>l_A) {
-	lo=0;
-	hi=mid;
-      } else {
-	lo=mid;
-	hi=n-1;
-      }
-      while (hi>lo+1) {
-	int mp=(lo+hi)/2;
-	if (mass[mid].Z+mass[mid].N<l_A) {
-	  lo=mp;
-	} else {
-	  hi=mp;
-	}
-      }
-      mid=lo;
-      if (mass[mid].Z+mass[mid].N!=l_A) {
-	mid=hi;
-      }
-      if (mass[mid].Z+mass[mid].N!=l_A) {
-	return false;
-      }
-    }
-
-    // The cached point was the right one, so we're done
-    if (mass[mid].N==l_N) {
-      if (fabs(mass[mid].mass)>1.0e-20 &&
-	  fabs(mass[mid].mass)<1.0e90) {
-	return true;
-      } else {
-	return false;
-      }
-    }
-
-    // Now look for the right N among all the A's
-    while (mass[mid].Z+mass[mid].N==l_A) {
-      if (mass[mid].N==l_N) {
-	if (fabs(mass[mid].mass)>1.0e-20 &&
-	    fabs(mass[mid].mass)<1.0e90) {
-	  return true;
-	} else {
-	  return false;
-	}
-      } else if (mass[mid].N>l_N) {
-	if (mid==0) return false;
-	mid--;
-      } else {
-	if (mid==((int)(n-1))) return false;
-	mid++;
-      }
-    }
-
-    return false;
-  }
-
-  for(size_t i=0;i<n;i++) {
-    if (mass[i].Z==l_Z && mass[i].N==l_N) {
-      return true;
-    }
-  }
-  return false;
+  return find_ZN(l_Z,l_N)!=no_entry;
 }
 
 /*
@@ -149,11 +82,8 @@ nucmass_ame::entry nucmass_ame::get_ZN(int l_Z, int l_N) {
 	      exc_einval);
     return ret;
   }
-  for(size_t i=0;i<n;i++) {
-    if (mass[i].Z==l_Z && mass[i].N==l_N) {
-      ret=mass[i];
-    }
-  }
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix!=no_entry) ret=mass[ix];
   return ret;
 }
 
@@ -167,11 +97,8 @@ nucmass_ame::entry nucmass_ame::get_ZA(int l_Z, int l_A) {
 	      exc_einval);
     return ret;
   }
-  for(size_t i=0;i<n;i++) {
-    if (mass[i].Z==l_Z && mass[i].A==l_A) {
-      ret=mass[i];
-    }
-  }
+  size_t ix=find_ZN(l_Z,l_A-l_Z);
+  if (ix!=no_entry) ret=mass[ix];
   return ret;
 }
 
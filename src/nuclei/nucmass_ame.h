@@ -116,11 +116,6 @@ namespace o2scl {
       also the documentation for the class structure for each table
       entry in \ref o2scl::nucmass_ame::entry.
       
-      \future Create a caching and more intelligent search system for
-      the table. The table is sorted by A and then N, so we could
-      probably just copy the search routine from mnmsk_mass, which is
-      sorted by Z and then N (some code written for this, but 
-      it doesn't work yet). 
       \future Should m_neut and m_prot be set to the neutron and
       proton masses from the table by default?
   */
@@ -280,10 +275,7 @@ namespace o2scl {
 	\endcomment
      */
     entry *mass;
-    
-    /// The last table index for caching
-    int last;
-    
+
 #endif
 
   };
@@ -29,118 +29,17 @@ using namespace std;
 using namespace o2scl;
 using namespace o2scl_const;
 
-bool nucmass_dz_table::is_included(int l_Z, int l_N) {
-  int lo=0, hi=0, mid=last;
-  int l_A=l_Z+l_N;
-
-  // binary search for the correct A first
-  if (data.get("A",mid)!=l_A) {
-    if (data.get("A",mid)>l_A) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (data.get("A",mp)<l_A) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (data.get("A",mid)!=l_A) mid=hi;
-    if (data.get("A",mid)!=l_A) {
-      return false;
-    }
-  }
-
-  // The cached point was the right one, so we're done
-  if (data.get("Z",mid)==l_Z) {
-    return true;
-  }
-
-  // Now look for the right N among all the Z's
-  while (data.get("A",mid)==l_A) {
-
-    if (data.get("Z",mid)==l_Z) {
-      return true;
-    } else if (data.get("Z",mid)>l_Z) {
-      if (mid==0) return false;
-      mid--;
-    } else {
-      if (mid==((int)(n-1))) return false;
-      mid++;
-    }
-  }
-  
-  return false;
-}
-
 double nucmass_dz_table::mass_excess(int l_Z, int l_N) {
-  int lo=0, hi=0, mid=last;
-  int l_A=l_Z+l_N;
-  
-  // binary search for the correct A first
-  if (data.get("A",mid)!=l_A) {
-    if (data.get("A",mid)>l_A) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (data.get("A",mp)<l_A) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (data.get("A",mid)!=l_A) mid=hi;
-    if (data.get("A",mid)!=l_A) {
-      O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-		 " not found in nucmass_dz_table::mass_excess().").c_str(),
-		exc_enotfound);
-    }
-  }
-  
-  // The cached point was the right one, so we're done
-  if (data.get("Z",mid)==l_Z) {
-    return data.get("ME",mid);
-  }
-  
-  // Now look for the right N among all the Z's
-  while (data.get("A",mid)==l_A) {
-    
-    if (data.get("Z",mid)==l_Z) {
-      return data.get("ME",mid);
-    } else if (data.get("Z",mid)>l_Z) {
-      if (mid==0) {
-	O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-		   " not found in nucmass_dz_table::mass_excess().").c_str(),
-		  exc_enotfound);
-      }
-      mid--;
-    } else {
-      if (mid==((int)(n-1))) {
-	O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-		   " not found in nucmass_dz_table::mass_excess().").c_str(),
-		  exc_enotfound);
-      }
-      mid++;
-    }
+
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix==no_entry) {
+    O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
+	       " not found in nucmass_dz_table::mass_excess().").c_str(),
+	      exc_enotfound);
+    return 0.0;
   }
   
-  O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-	     " not found in nucmass_dz_table::mass_excess().").c_str(),
-	    exc_enotfound);
-  
-  return 0.0;
+  return data.get(me_col_ix,ix);
 }
 
 nucmass_dz_table::nucmass_dz_table(std::string model, bool external) {
@@ -167,7 +66,14 @@ nucmass_dz_table::nucmass_dz_table(std::string model, bool external) {
   hf.close();
   
   n=data.get_nlines();
-  last=n/2;
+  me_col_ix=data.lookup_column("ME");
+
+  std::vector<int> Zv(n), Nv(n);
+  for(size_t i=0;i<n;i++) {
+    Zv[i]=((int)(data.get("Z",i)+1.0e-6));
+    Nv[i]=((int)(data.get("A",i)+1.0e-6))-Zv[i];
+  }
+  build_index(Zv,Nv);
 }
 
 nucmass_dz_table::~nucmass_dz_table() {
@@ -62,11 +62,6 @@ namespace o2scl {
 
     virtual ~nucmass_dz_table();
 
-    /** \brief Return false if the mass formula does not include 
-        specified nucleus
-    */
-    virtual bool is_included(int Z, int N);
-    
     /// Given \c Z and \c N, return the mass excess in MeV
     virtual double mass_excess(int Z, int N);
     
@@ -80,8 +75,8 @@ namespace o2scl {
     /// Table containing the data
     table<> data;
 
-    /// The last table index for caching
-    int last;
+    /// Column which refers to the mass excess
+    size_t me_col_ix;
 
 #endif
     
@@ -313,7 +313,7 @@ int nucmass_mnmsk::set_data(int n_mass, nucmass_mnmsk::entry *m,
   n=n_mass;
   mass=m;
   reference=ref;
-  last=n/2;
+  build_index_entries(n,mass);
   return 0;
 }
 
@@ -324,110 +324,12 @@ double nucmass_mnmsk::mass_excess(int Z, int N) {
   return ret.Mth;
 }
 
-bool nucmass_mnmsk::is_included(int l_Z, int l_N) {
-  int lo=0, hi=0, mid=last;
-
-  // binary search for the correct Z first
-  if (mass[mid].Z!=l_Z) {
-    if (mass[mid].Z>l_Z) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (mass[mp].Z<l_Z) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (mass[mid].Z!=l_Z) mid=hi;
-    if (mass[mid].Z!=l_Z) {
-      return false;
-    }
-  }
-
-  // The cached point was the right one, so we're done
-  if (mass[mid].N==l_N) {
-    return true;
-  }
-
-
-  // Now look for the right N among all the Z's
-  while (mass[mid].Z==l_Z) {
-    if (mass[mid].N==l_N) {
-      return true;
-    } else if (mass[mid].N>l_N) {
-      if (mid==0) return false;
-      mid--;
-    } else {
-      if (mid==((int)n-1)) return false;
-      mid++;
-    }
-  }
-  
-  return false;
-}
-
 bool nucmass_mnmsk_exp::is_included(int l_Z, int l_N) {
-  int lo=0, hi=0, mid=last;
-
-  // binary search for the correct Z first
-  if (mass[mid].Z!=l_Z) {
-    if (mass[mid].Z>l_Z) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (mass[mp].Z<l_Z) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (mass[mid].Z!=l_Z) mid=hi;
-    if (mass[mid].Z!=l_Z) {
-      return false;
-    }
-  }
-
-  // The cached point was the right one, so we're done
-  if (mass[mid].N==l_N) {
-    if (fabs(mass[mid].Mexp)>1.0e-20 &&
-	fabs(mass[mid].Mexp)<1.0e90) {
-      return true;
-    } else {
-      return false;
-    }
-  }
-
-  // Now look for the right N among all the Z's
-  while (mass[mid].Z==l_Z) {
-    if (mass[mid].N==l_N) {
-      if (fabs(mass[mid].Mexp)>1.0e-20 &&
-	  fabs(mass[mid].Mexp)<1.0e90) {
-	return true;
-      } else {
-	return false;
-      }
-    } else if (mass[mid].N>l_N) {
-      if (mid==0) return false;
-      mid--;
-    } else {
-      if (mid==((int)n-1)) return false;
-      mid++;
-    }
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix==no_entry) return false;
+  if (fabs(mass[ix].Mexp)>1.0e-20 && fabs(mass[ix].Mexp)<1.0e90) {
+    return true;
   }
-  
   return false;
 }
 
@@ -440,78 +342,18 @@ double nucmass_mnmsk_exp::mass_excess(int Z, int N) {
 
 nucmass_mnmsk::entry nucmass_mnmsk::get_ZN(int l_Z, int l_N) {
 
-  int lo=0, hi=0, mid=last;
-  
   nucmass_mnmsk::entry ret;
   ret.Z=0;
   ret.A=0;
   ret.N=0;
 
-  if (mid>((int)n)-1) {
-    O2SCL_ERR("Indexing problem in nucmass_mnmsk::get_ZN().",
-	      o2scl::exc_esanity);
-  }
-  
-  // binary search for the correct Z first
-  if (mass[mid].Z!=l_Z) {
-    if (mass[mid].Z>l_Z) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (mass[mp].Z<l_Z) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (mass[mid].Z!=l_Z) mid=hi;
-    if (mass[mid].Z!=l_Z) {
-      O2SCL_ERR((((string)"Nuclei with Z=")+itos(l_Z) 
-		 +" not found in nucmass_mnmsk::get_ZN().").c_str(),
-		exc_enotfound);
-    }
-  }
-
-  // The cached point was the right one, so we're done
-  if (mass[mid].N==l_N) {
-    ret=mass[mid];
-    last=mid;
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix==no_entry) {
+    O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)
+	       +" not found in nucmass_mnmsk::get_ZN().").c_str(),exc_enotfound);
     return ret;
   }
-
-  // Now look for the right N among all the Z's
-  while (mass[mid].Z==l_Z) {
-    if (mass[mid].N==l_N) {
-      ret=mass[mid];
-      last=mid;
-      return ret;
-    } else if (mass[mid].N>l_N) {
-      if (mid==0) {
-	O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)
-		   +" not found in nucmass_mnmsk::get_ZN().").c_str(),
-		  exc_enotfound);
-	return ret;
-      }
-      mid--;
-    } else {
-      if (mid==((int)n)-1) {
-	O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)
-		   +" not found in nucmass_mnmsk::get_ZN().").c_str(),
-		  exc_enotfound);
-	return ret;
-      }
-      mid++;
-    }
-  }
   
-  O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)
-	     +" not found in nucmass_mnmsk::get_ZN().").c_str(),exc_enotfound);
-  return ret;
+  return mass[ix];
 }
 
@@ -70,30 +70,21 @@ int nucmass_gen::load_be(std::string fname, std::string be_col,
     data.set("mex",i,mex);
   }
   mex_col_ix=data.lookup_column("mex");
-  
-  last=n/2;
-
-  return 0;
-}
-
-bool nucmass_gen::is_included(int l_Z, int l_N) {
 
+  std::vector<int> Zv(n), Nv(n);
   for(size_t i=0;i<n;i++) {
-    if (fabs(data.get("Z",i)-l_Z)<1.0e-12 &&
-	fabs(data.get("N",i)-l_N)<1.0e-12) {
-      return true;
-    }
+    Zv[i]=((int)(data.get("Z",i)+1.0e-6));
+    Nv[i]=((int)(data.get("N",i)+1.0e-6));
   }
+  build_index(Zv,Nv);
 
-  return false;
+  return 0;
 }
 
 double nucmass_gen::mass_excess(int l_Z, int l_N) {
-  for(size_t i=0;i<n;i++) {
-    if (fabs(data.get("Z",i)-l_Z)<1.0e-12 &&
-	fabs(data.get("N",i)-l_N)<1.0e-12) {
-      return data.get(mex_col_ix,i);
-    }
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix!=no_entry) {
+    return data.get(mex_col_ix,ix);
   }
   
   O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
@@ -104,11 +95,9 @@ double nucmass_gen::mass_excess(int l_Z, int l_N) {
 }
 
 double nucmass_gen::get_string(int l_Z, int l_N, std::string column) {
-  for(size_t i=0;i<n;i++) {
-    if (fabs(data.get("Z",i)-l_Z)<1.0e-12 &&
-	fabs(data.get("N",i)-l_N)<1.0e-12) {
-      return data.get(column,i);
-    }
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix!=no_entry) {
+    return data.get(column,ix);
   }
   
   O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
@@ -57,11 +57,6 @@ namespace o2scl {
     /// Returns true if data has been loaded
     bool is_loaded() { return (n>0); }
 
-    /** \brief Return false if the mass formula does not include 
-	specified nucleus
-    */
-    virtual bool is_included(int Z, int N);
-
     /// Return number of entries
     virtual size_t get_nentries() { return n; }
     
@@ -81,9 +76,6 @@ namespace o2scl {
     /// Column which refers to the mass excess
     size_t mex_col_ix;
     
-    /// The last table index for caching
-    int last;
-    
 #endif
 
   };
@@ -104,19 +104,14 @@ namespace o2scl {
 
     virtual ~nucmass_hfb();
 
-    /** \brief Return false if the mass formula does not include 
-        specified nucleus
-    */
-    virtual bool is_included(int Z, int N);
-    
     /// Given \c Z and \c N, return the mass excess in MeV
     virtual double mass_excess(int Z, int N);
     
     /** \brief Get the entry for the specified proton and neutron number
         
-        This method searches the table using a cached binary search
-        algorithm. It is assumed that the table is sorted first by
-        proton number and then by neutron number.
+        This method uses the index constructed when the table
+        is loaded, so the table need not be sorted. The error
+        handler is called if the nucleus is not present.
     */
     nucmass_hfb::entry get_ZN(int l_Z, int l_N);
     
@@ -139,8 +134,6 @@ namespace o2scl {
     /// The array containing the mass data of length ame::n
     nucmass_hfb::entry *mass;
     
-    /// The last table index for caching
-    int last;
     
 #endif
     
@@ -215,19 +208,14 @@ namespace o2scl {
 
     };
 
-    /** \brief Return false if the mass formula does not include 
-        specified nucleus
-    */
-    virtual bool is_included(int Z, int N);
-
     /// Given \c Z and \c N, return the mass excess in MeV
     virtual double mass_excess(int Z, int N);
 
     /** \brief Get the entry for the specified proton and neutron number
         
-        This method searches the table using a cached binary search
-        algorithm. It is assumed that the table is sorted first by
-        proton number and then by neutron number.
+        This method uses the index constructed when the table
+        is loaded, so the table need not be sorted. The error
+        handler is called if the nucleus is not present.
     */
     nucmass_hfb_sp::entry get_ZN(int l_Z, int l_N);
     
@@ -247,8 +235,6 @@ namespace o2scl {
     /// The array containing the mass data of length ame::n
     nucmass_hfb_sp::entry *mass;
 
-    /// The last table index for caching
-    int last;
     
 #endif
     
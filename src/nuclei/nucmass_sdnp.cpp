@@ -70,134 +70,22 @@ int nucmass_sdnp::load(std::string model, bool external) {
     mass[i]=nde;
   }
 
-  last=n/2;
+  build_index_entries(n,mass);
   return 0;
 }
 
 nucmass_sdnp::~nucmass_sdnp() {
 }
 
-bool nucmass_sdnp::is_included(int l_Z, int l_N) {
-  int lo=0, hi=0, mid=last;
-
-  // binary search for the correct Z first
-  if (mass[mid].Z!=l_Z) {
-    if (mass[mid].Z>l_Z) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (mass[mp].Z<l_Z) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (mass[mid].Z!=l_Z) mid=hi;
-    if (mass[mid].Z!=l_Z) {
-      return false;
-    }
-  }
-
-  // The cached point was the right one, so we're done
-  if (mass[mid].N==l_N) {
-    return true;
-  }
-
-  // Now look for the right N among all the N's. The flags "increased"
-  // and "decreased" are necessary when there is a gap in the isotopes
-  // for a particular element, to prevent infinite loops in that case.
-  bool increased=false;
-  bool decreased=false;
-  while (mass[mid].Z==l_Z) {
-    if (mass[mid].N==l_N) {
-      return true;
-    } else if (mass[mid].N>l_N) {
-      if (increased || mid==0) return false;
-      mid--;
-      decreased=true;
-    } else {
-      if (decreased || mid==((int)n-1)) return false;
-      mid++;
-      increased=true;
-    }
-  }
-  
-  return false;
-}
-
 double nucmass_sdnp::mass_excess(int l_Z, int l_N) {
-  int lo=0, hi=0, mid=last;
-  
-  // binary search for the correct Z first
-  if (mass[mid].Z!=l_Z) {
-    if (mass[mid].Z>l_Z) {
-      lo=0;
-      hi=mid;
-    } else {
-      lo=mid;
-      hi=n-1;
-    }
-    while (hi>lo+1) {
-      int mp=(lo+hi)/2;
-      if (mass[mp].Z<l_Z) {
-	lo=mp;
-      } else {
-	hi=mp;
-      }
-    }
-    mid=lo;
-    if (mass[mid].Z!=l_Z) mid=hi;
-    if (mass[mid].Z!=l_Z) {
-      O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-		 " not found in nucmass_sdnp::mass_excess().").c_str(),
-		exc_enotfound);
-    }
-  }
-  
-  // The cached point was the right one, so we're done
-  if (mass[mid].N==l_N) {
-    int A=l_Z+l_N;
-    return mass[mid].ENERGY-A*m_amu+l_Z*(m_prot+m_elec)+l_N*m_neut;
-  }
-  
-  // Now look for the right N among all the N's. The flags "increased"
-  // and "decreased" are necessary when there is a gap in the isotopes
-  // for a particular element, to prevent infinite loops in that case.
-  bool increased=false;
-  bool decreased=false;
-  while (mass[mid].Z==l_Z) {
-    
-    if (mass[mid].N==l_N) {
-      int A=l_Z+l_N;
-      return mass[mid].ENERGY-A*m_amu+l_Z*(m_prot+m_elec)+l_N*m_neut;
-    } else if (mass[mid].N>l_N) {
-      if (increased || mid==0) {
-	O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-		   " not found in nucmass_sdnp::mass_excess().").c_str(),
-		  exc_enotfound);
-      }
-      mid--;
-      decreased=true;
-    } else {
-      if (decreased || mid==((int)n-1)) {
-	O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-		   " not found in nucmass_sdnp::mass_excess().").c_str(),
-		  exc_enotfound);
-      }
-      mid++;
-      increased=true;
-    }
+
+  size_t ix=find_ZN(l_Z,l_N);
+  if (ix==no_entry) {
+    O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
+	       " not found in nucmass_sdnp::mass_excess().").c_str(),
+	      exc_enotfound);
+    return 0.0;
   }
-  
-  O2SCL_ERR((((string)"Nucleus with Z=")+itos(l_Z)+" and N="+itos(l_N)+
-	     " not found in nucmass_sdnp::mass_excess().").c_str(),
-	    exc_enotfound);
-  
-  return 0.0;
+  int A=l_Z+l_N;
+  return mass[ix].ENERGY-A*m_amu+l_Z*(m_prot+m_elec)+l_N*m_neut;
 }
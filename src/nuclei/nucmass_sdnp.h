@@ -117,11 +117,6 @@ namespace o2scl {
     /// Returns true if data has been loaded
     bool is_loaded() { return (n>0); }
 
-    /** \brief Return false if the mass formula does not include 
-	specified nucleus
-    */
-    virtual bool is_included(int Z, int N);
-
     /// Return number of entries
     virtual size_t get_nentries() { return n; }
     
@@ -132,17 +127,12 @@ namespace o2scl {
 
   protected:
 
-    /// The number of entries (about 3000).
-    size_t n;
-    
     /// The reference for the original data
     std::string reference;
     
     /// The array containing the mass data of length n
     entry *mass;
 
-    /// The last table index for caching
-    int last;
     
 #endif
 
@@ -249,6 +249,28 @@ int main(void) {
   
   t.test_gen(ame95rmd.get_nentries()==2931,"ame.n");
 
+  // Test the (Z,N) index by counting the included nuclei and
+  // checking some points outside the tables
+  {
+    nucmass_table *nmi[6]={&ame,&ame95rmd,&m95,&kt2,&hfb14,&sdnp1};
+    for(size_t i=0;i<6;i++) {
+      size_t cnt=0;
+      for(int Z=-2;Z<=140;Z++) {
+	for(int N=-2;N<=280;N++) {
+	  if (nmi[i]->is_included(Z,N)) cnt++;
+	}
+      }
+      t.test_gen(cnt==nmi[i]->get_nentries(),"index count");
+      t.test_gen(nmi[i]->is_included(82,126),"index Pb208");
+      t.test_gen(!nmi[i]->is_included(82,-126),"index outside 1");
+      t.test_gen(!nmi[i]->is_included(400,126),"index outside 2");
+    }
+    t.test_rel(ame.mass_excess(82,126),ame.get_ZN(82,126).mass/1.0e3,
+	       1.0e-12,"index ame get_ZN");
+    t.test_rel(m95.mass_excess(82,126),m95.get_ZN(82,126).Mth,
+	       1.0e-12,"index m95 get_ZN");
+  }
+
   // Test nucmass_radius
   nucmass_radius nr;
   double rho0, N, N_err;
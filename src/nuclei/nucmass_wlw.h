@@ -96,11 +96,6 @@ namespace o2scl {
     /// Return the type, \c "nucmass_wlw".
     virtual const char *type() { return "nucmass_wlw"; }
 
-    /** \brief Return false if the mass formula does not include 
-	specified nucleus
-    */
-    virtual bool is_included(int Z, int N);
-
     /// Given \c Z and \c N, return the mass excess in MeV
     virtual double mass_excess(int Z, int N);
     
@@ -111,8 +106,6 @@ namespace o2scl {
     /// The array containing the mass data of length n
     entry *mass;
 
-    /// The last table index for caching
-    int last;
     
 #endif
 
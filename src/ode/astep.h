@@ -122,6 +122,11 @@ namespace o2scl {
   
   /// The default stepper
   ode_rkck_gsl<vec_y_t,vec_dydx_t,vec_yerr_t,func_t> def_step;
+
+  /// Return true if the default stepper \ref def_step is being used
+  bool using_def_step() const {
+    return stepp==&def_step;
+  }
   
 #ifndef DOXYGEN_INTERNAL
 
@@ -28,6 +28,7 @@
 */
 
 #include <iostream>
+#include <vector>
 
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
@@ -48,6 +49,180 @@ namespace o2scl {
     (size_t,double,boost::numeric::ublas::matrix_row
      <boost::numeric::ublas::matrix<double> > &)> ode_it_funct;
   
+  /** \brief Banded matrix for \ref ode_it_solve
+
+      This class stores a square matrix of size \c n with \c kl
+      subdiagonals and \c ku superdiagonals in the LAPACK banded
+      format, with \c kl additional rows to hold the fill-in from the
+      row interchanges. The function factor() performs an LU
+      decomposition with partial pivoting in place and solve() then
+      solves the linear system for a given right-hand side. Both the
+      memory and the time are linear in \c n for fixed bandwidths.
+      
+      The element access operator does not check that the element is
+      inside the band.
+  */
+  class ode_it_band {
+
+  public:
+
+    ode_it_band() {
+      n=0;
+      kl=0;
+      ku=0;
+      ldab=1;
+    }
+
+    /** \brief Set the size and bandwidths and zero the matrix
+     */
+    void resize(size_t n_new, size_t kl_new, size_t ku_new) {
+      n=n_new;
+      kl=kl_new;
+      ku=ku_new;
+      ldab=2*kl+ku+1;
+      ab.resize(ldab*n);
+      piv.resize(n);
+      set_zero();
+      return;
+    }
+
+    /// Set all elements to zero
+    void set_zero() {
+      for(size_t i=0;i<ab.size();i++) ab[i]=0.0;
+      return;
+    }
+
+    /// Return the size of the matrix
+    size_t size() const {
+      return n;
+    }
+    
+    /// Element in row \c i and column \c j
+    double &operator()(size_t i, size_t j) {
+      return ab[kl+ku+i-j+j*ldab];
+    }
+
+    /// Element in row \c i and column \c j (zero outside the band)
+    double get(size_t i, size_t j) const {
+      if (i>j+kl || j>i+ku) return 0.0;
+      return ab[kl+ku+i-j+j*ldab];
+    }
+
+    /** \brief Compute the LU decomposition in place
+
+	Returns 0 for success and \ref o2scl::exc_esing if the
+	matrix is singular.
+    */
+    int factor() {
+
+      size_t kv=kl+ku;
+      
+      // The last column which has been modified so far
+      size_t ju=0;
+      
+      for(size_t j=0;j<n;j++) {
+	
+	size_t km=kl;
+	if (j+km>n-1) km=n-1-j;
+	
+	// Find the pivot
+	size_t jp=0;
+	double amax=fabs(ab[kv+j*ldab]);
+	for(size_t r=1;r<=km;r++) {
+	  if (fabs(ab[kv+r+j*ldab])>amax) {
+	    amax=fabs(ab[kv+r+j*ldab]);
+	    jp=r;
+	  }
+	}
+	piv[j]=j+jp;
+	if (amax==0.0) return o2scl::exc_esing;
+
+	size_t jmax=j+ku+jp;
+	if (jmax>n-1) jmax=n-1;
+	if (jmax>ju) ju=jmax;
+
+	// Swap rows j and j+jp in columns j through ju
+	if (jp!=0) {
+	  for(size_t c=j;c<=ju;c++) {
+	    std::swap(ab[kv+j-c+c*ldab],ab[kv+j+jp-c+c*ldab]);
+	  }
+	}
+
+	// Compute the multipliers and update the trailing submatrix
+	if (km>0) {
+	  double piv_inv=1.0/ab[kv+j*ldab];
+	  for(size_t r=1;r<=km;r++) {
+	    ab[kv+r+j*ldab]*=piv_inv;
+	  }
+	  for(size_t c=j+1;c<=ju;c++) {
+	    double ajc=ab[kv+j-c+c*ldab];
+	    if (ajc!=0.0) {
+	      for(size_t r=1;r<=km;r++) {
+		ab[kv+j+r-c+c*ldab]-=ab[kv+r+j*ldab]*ajc;
+	      }
+	    }
+	  }
+	}
+      }
+
+      return 0;
+    }
+
+    /** \brief Solve the linear system using the LU decomposition
+	from factor(), overwriting the right-hand side \c b with
+	the solution
+    */
+    template<class vec_t> void solve(vec_t &b) const {
+
+      size_t kv=kl+ku;
+
+      // Apply the row interchanges and the unit lower triangular
+      // factor
+      for(size_t j=0;j<n;j++) {
+	if (piv[j]!=j) std::swap(b[j],b[piv[j]]);
+	size_t km=kl;
+	if (j+km>n-1) km=n-1-j;
+	for(size_t r=1;r<=km;r++) {
+	  b[j+r]-=ab[kv+r+j*ldab]*b[j];
+	}
+      }
+
+      // Back substitution with the upper triangular factor
+      for(size_t jj=n;jj>0;jj--) {
+	size_t j=jj-1;
+	size_t cmax=j+kv;
+	if (cmax>n-1) cmax=n-1;
+	for(size_t c=j+1;c<=cmax;c++) {
+	  b[j]-=ab[kv+j-c+c*ldab]*b[c];
+	}
+	b[j]/=ab[kv+j*ldab];
+      }
+
+      return;
+    }
+
+  protected:
+
+    /// Size
+    size_t n;
+
+    /// Number of subdiagonals
+    size_t kl;
+
+    /// Number of superdiagonals
+    size_t ku;
+
+    /// Leading dimension, <tt>2*kl+ku+1</tt>
+    size_t ldab;
+
+    /// The matrix elements in banded format
+    std::vector<double> ab;
+
+    /// Pivot rows
+    std::vector<size_t> piv;
+
+  };
+  
   /** \brief ODE solver using a generic linear solver to solve 
       finite-difference equations
 
@@ -185,6 +360,86 @@ namespace o2scl {
 		   mat_t &y, func_t &derivs, func_t &left, func_t &right,
 		   dfunc_t &d_derivs, dfunc_t &d_left, dfunc_t &d_right,
 		   solver_mat_t &mat, solver_vec_t &rhs, solver_vec_t &dy) {
+    return solve_int(n_grid,n_eq,nb_left,x,y,derivs,left,right,
+		     d_derivs,d_left,d_right,mat,rhs,dy);
+  }
+
+  /** \brief Solve \c derivs with boundary conditions \c left and 
+      \c right using a banded linear solver
+
+      This function is the same as the version of solve() above,
+      except that the finite-difference equations are solved with
+      \ref ode_it_band instead of the dense linear solver specified
+      in set_solver(). With the boundary conditions on the left hand
+      side first, the Jacobian has <tt>nb_left+n_eq-1</tt>
+      subdiagonals and <tt>2*n_eq-nb_left-1</tt> superdiagonals, so
+      only those elements are stored and the memory and time
+      required are linear in \c n_grid rather than cubic. The
+      vectors \c rhs and \c dy are workspace of size
+      <tt>[n_grid*n_eq]</tt>.
+  */
+  int solve(size_t n_grid, size_t n_eq, size_t nb_left, vec_t &x, 
+	    mat_t &y, func_t &derivs, func_t &left, func_t &right,
+	    solver_vec_t &rhs, solver_vec_t &dy) {
+
+    // Store the functions for simple derivatives
+    fd=&derivs;
+    fl=&left;
+    fr=&right;
+    
+    /// Function derivatives for iterative solving of ODEs
+    typedef std::function<double
+      (size_t,size_t,double,matrix_row_t &)> ode_it_dfunct;
+    
+    ode_it_dfunct d2_derivs=std::bind
+      (std::mem_fn<double(size_t,size_t,double,matrix_row_t &)>
+       (&ode_it_solve::fd_derivs),this,std::placeholders::_1,
+       std::placeholders::_2,std::placeholders::_3,std::placeholders::_4);
+    ode_it_dfunct d2_left=std::bind
+      (std::mem_fn<double(size_t,size_t,double,matrix_row_t &)>
+       (&ode_it_solve::fd_left),this,std::placeholders::_1,
+       std::placeholders::_2,std::placeholders::_3,std::placeholders::_4);
+    ode_it_dfunct d2_right=std::bind
+      (std::mem_fn<double(size_t,size_t,double,matrix_row_t &)>
+       (&ode_it_solve::fd_right),this,std::placeholders::_1,
+       std::placeholders::_2,std::placeholders::_3,std::placeholders::_4);
+
+    return solve_derivs(n_grid,n_eq,nb_left,x,y,derivs,left,right,
+			d2_derivs,d2_left,d2_right,rhs,dy);
+  }
+
+  /** \brief Solve \c derivs with boundary conditions \c left and 
+      \c right with user-specified derivatives using a banded
+      linear solver
+
+      See the banded version of solve() for details.
+  */
+  template<class dfunc_t>
+  int solve_derivs(size_t n_grid, size_t n_eq, size_t nb_left, vec_t &x, 
+		   mat_t &y, func_t &derivs, func_t &left, func_t &right,
+		   dfunc_t &d_derivs, dfunc_t &d_left, dfunc_t &d_right,
+		   solver_vec_t &rhs, solver_vec_t &dy) {
+    band.resize(n_grid*n_eq,nb_left+n_eq-1,2*n_eq-nb_left-1);
+    return solve_int(n_grid,n_eq,nb_left,x,y,derivs,left,right,
+		     d_derivs,d_left,d_right,band,rhs,dy);
+  }
+  
+  /// Default linear solver
+  o2scl_linalg::linear_solver_HH<solver_vec_t,solver_mat_t> def_solver;
+  
+  protected:
+
+  /// Storage for the banded Jacobian
+  ode_it_band band;
+
+  /** \brief Solve the finite-difference equations using the
+      matrix \c mat, either a dense matrix or \ref ode_it_band
+  */
+  template<class dfunc_t, class jac_mat_t>
+  int solve_int(size_t n_grid, size_t n_eq, size_t nb_left, vec_t &x, 
+		mat_t &y, func_t &derivs, func_t &left, func_t &right,
+		dfunc_t &d_derivs, dfunc_t &d_left, dfunc_t &d_right,
+		jac_mat_t &mat, solver_vec_t &rhs, solver_vec_t &dy) {
 
     // Variable index
     size_t ix;
@@ -199,12 +454,8 @@ namespace o2scl {
     for(size_t it=0;done==false && it<niter;it++) {
       
       ix=0;
-      
-      for(size_t i=0;i<nvars;i++) {
-	for(size_t j=0;j<nvars;j++) {
-	  mat(i,j)=0.0;
-	}
-      }
+
+      zero_mat(nvars,mat);
 
       // Construct the entries corresponding to the LHS boundary. 
       // This makes the first nb_left rows of the matrix.
@@ -269,7 +520,7 @@ namespace o2scl {
 	std::cout << "Matrix: " << std::endl;
 	for(size_t i=0;i<nvars;i++) {
 	  for(size_t j=0;j<nvars;j++) {
-	    std::cout << mat(i,j) << " ";
+	    std::cout << mat_elem(mat,i,j) << " ";
 	  }
 	  std::cout << std::endl;
 	}
@@ -281,7 +532,11 @@ namespace o2scl {
 
       if (make_mats) return 0;
 
-      solver->solve(ix,mat,rhs,dy);
+      int ret=lin_solve(ix,mat,rhs,dy);
+      if (ret!=0) {
+	O2SCL_ERR2("Linear solver failed in ",
+		   "ode_it_solve::solve_int().",ret);
+      }
 
       if (verbose>3) {
 	std::cout << "Corrections:" << std::endl;
@@ -331,11 +586,52 @@ namespace o2scl {
     return 0;
   }
   
-  /// Default linear solver
-  o2scl_linalg::linear_solver_HH<solver_vec_t,solver_mat_t> def_solver;
+  /// \name Functions for the dense and banded linear systems
+  //@{
+  /// Zero the dense matrix \c mat
+  void zero_mat(size_t nvars, solver_mat_t &mat) {
+    for(size_t i=0;i<nvars;i++) {
+      for(size_t j=0;j<nvars;j++) {
+	mat(i,j)=0.0;
+      }
+    }
+    return;
+  }
+
+  /// Zero the banded matrix \c mat
+  void zero_mat(size_t nvars, ode_it_band &mat) {
+    mat.set_zero();
+    return;
+  }
+
+  /// Return the element of the dense matrix \c mat
+  double mat_elem(solver_mat_t &mat, size_t i, size_t j) {
+    return mat(i,j);
+  }
   
-  protected:
+  /// Return the element of the banded matrix \c mat
+  double mat_elem(ode_it_band &mat, size_t i, size_t j) {
+    return mat.get(i,j);
+  }
+  
+  /// Solve the dense linear system with the user-specified solver
+  int lin_solve(size_t n, solver_mat_t &mat, solver_vec_t &rhs,
+		solver_vec_t &dy) {
+    solver->solve(n,mat,rhs,dy);
+    return 0;
+  }
   
+  /// Solve the banded linear system 
+  int lin_solve(size_t n, ode_it_band &mat, solver_vec_t &rhs,
+		solver_vec_t &dy) {
+    int ret=mat.factor();
+    if (ret!=0) return ret;
+    for(size_t i=0;i<n;i++) dy[i]=rhs[i];
+    mat.solve(dy);
+    return 0;
+  }
+  //@}
+
   /// \name Storage for functions
   //@{
   func_t *fl, *fr, *fd;
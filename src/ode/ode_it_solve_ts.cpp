@@ -406,6 +406,74 @@ int main(void) {
     t.test_rel(y(4,2),-1.24722,1.0e-2,"sys4 o2scl 6");
   }
 
+  // Solve systems 3 and 4 with the banded solver and compare
+  // with the dense solver
+
+  {
+    size_t ng=41;
+    ubvector x(ng);
+    ubmatrix y(ng,3), y2(ng,3), y3(ng,3), y4(ng,3);
+    for(size_t i=0;i<ng;i++) {
+      x[i]=((double)i)/((double)(ng-1));
+      y(i,0)=1.0+x[i]+1.0;
+      y(i,1)=3.0*x[i];
+      y(i,2)=-0.1*x[i]-1.4;
+      y3(i,0)=x[i];
+      y3(i,1)=1.5*x[i]+0.5;
+      y3(i,2)=-x[i]-0.6;
+    }
+    y2=y;
+    y4=y3;
+  
+    ubmatrix A(3*ng,3*ng);
+    ubvector rhs(3*ng), dy(3*ng);
+    fc3 f3;
+    fc4 f4;
+
+    ode_it_funct ofm3d=std::bind
+      (std::mem_fn<double(size_t,double,ubmatrix_row &)>
+       (&fc3::derivs),&f3,std::placeholders::_1,std::placeholders::_2,
+       std::placeholders::_3);       
+    ode_it_funct ofm3l=std::bind
+      (std::mem_fn<double(size_t,double,ubmatrix_row &)>
+       (&fc3::left),&f3,std::placeholders::_1,std::placeholders::_2,
+       std::placeholders::_3);       
+    ode_it_funct ofm3r=std::bind
+      (std::mem_fn<double(size_t,double,ubmatrix_row &)>
+       (&fc3::right),&f3,std::placeholders::_1,std::placeholders::_2,
+       std::placeholders::_3);       
+    ode_it_funct ofm4d=std::bind
+      (std::mem_fn<double(size_t,double,ubmatrix_row &)>
+       (&fc4::derivs),&f4,std::placeholders::_1,std::placeholders::_2,
+       std::placeholders::_3);       
+    ode_it_funct ofm4l=std::bind
+      (std::mem_fn<double(size_t,double,ubmatrix_row &)>
+       (&fc4::left),&f4,std::placeholders::_1,std::placeholders::_2,
+       std::placeholders::_3);       
+    ode_it_funct ofm4r=std::bind
+      (std::mem_fn<double(size_t,double,ubmatrix_row &)>
+       (&fc4::right),&f4,std::placeholders::_1,std::placeholders::_2,
+       std::placeholders::_3);       
+
+    ode_it_solve<> oit;
+    oit.solve(ng,3,2,x,y,ofm3d,ofm3l,ofm3r,A,rhs,dy);
+    oit.solve(ng,3,2,x,y2,ofm3d,ofm3l,ofm3r,rhs,dy);
+    oit.solve(ng,3,1,x,y3,ofm4d,ofm4l,ofm4r,A,rhs,dy);
+    oit.solve(ng,3,1,x,y4,ofm4d,ofm4l,ofm4r,rhs,dy);
+
+    double dmax=0.0, dmax2=0.0;
+    for(size_t i=0;i<ng;i++) {
+      for(size_t j=0;j<3;j++) {
+	if (fabs(y(i,j)-y2(i,j))>dmax) dmax=fabs(y(i,j)-y2(i,j));
+	if (fabs(y3(i,j)-y4(i,j))>dmax2) dmax2=fabs(y3(i,j)-y4(i,j));
+      }
+    }
+    t.test_abs(dmax,0.0,1.0e-10,"sys3 banded");
+    t.test_abs(dmax2,0.0,1.0e-10,"sys4 banded");
+    t.test_rel(y2(ng-1,1),3.0,1.0e-8,"sys3 banded bc");
+    t.test_rel(y4(ng-1,0),1.0,1.0e-8,"sys4 banded bc");
+  }
+
   // System 1 with sparse matrix format
   {
     ubvector x(11);
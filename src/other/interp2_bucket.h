@@ -0,0 +1,380 @@
+/*
+  -------------------------------------------------------------------
+
+  Copyright (C) 2006-2021, Andrew W. Steiner
+
+  This file is part of O2scl.
+
+  O2scl is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3 of the License, or
+  (at your option) any later version.
+
+  O2scl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with O2scl. If not, see <http://www.gnu.org/licenses/>.
+
+  -------------------------------------------------------------------
+*/
+#ifndef O2SCL_INTERP2_BUCKET_H
+#define O2SCL_INTERP2_BUCKET_H
+
+/** \file interp2_bucket.h
+    \brief File defining \ref o2scl::interp2_bucket
+*/
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include <o2scl/err_hnd.h>
+
+#ifndef DOXYGEN_NO_O2NS
+namespace o2scl {
+#endif
+
+  /** \brief A grid of buckets for nearest-neighbor searches among
+      scattered data in two dimensions
+
+      This class sorts a set of points \f$ (x_i,y_i) \f$ into a
+      uniform rectangular grid of cells which covers the data, so
+      that the \f$ k \f$ nearest points to an arbitrary location can
+      be found by examining only the cells near that location. This
+      is used by \ref o2scl::interp2_neigh and \ref
+      o2scl::interp2_planar to avoid a \f$ {\cal O}(N) \f$ search for
+      every interpolation.
+
+      The distance to the point with index \f$ i \f$ is
+      \f[
+      d_i^2 = \left(\frac{x-x_i}{\Delta x}\right)^2 +
+      \left(\frac{y-y_i}{\Delta y}\right)^2
+      \f]
+      computed in exactly the same way as the brute-force searches
+      in the interpolation classes, and ties are broken in favor of
+      the point with the smaller index. Thus \ref nearest() returns
+      the same points as an exhaustive search. The number of cells is
+      chosen so that there are on average \ref pts_per_cell points in
+      each cell, and the aspect ratio of the cells follows that of
+      the data, so for data which are distributed reasonably
+      uniformly a search requires \f$ {\cal O}(1) \f$ distance
+      evaluations. The search remains correct (but slower) for
+      strongly clustered data or for points far outside the data.
+
+      This class stores pointers to the data, not a copy, and
+      \ref build() must be called again if the x- or y-values change.
+  */
+  template<class vec_t> class interp2_bucket {
+
+  public:
+
+    interp2_bucket() {
+      pts_per_cell=2.0;
+      np=0;
+      nbx=0;
+      nby=0;
+      ux=0;
+      uy=0;
+      dx=1.0;
+      dy=1.0;
+    }
+
+    /// The average number of points per cell (default 2)
+    double pts_per_cell;
+
+    /// Return true if the grid has been constructed
+    bool is_built() const {
+      return np>0;
+    }
+
+    /// Remove the grid
+    void clear() {
+      np=0;
+      nbx=0;
+      nby=0;
+      ux=0;
+      uy=0;
+      cell_start.clear();
+      cell_index.clear();
+      return;
+    }
+
+    /** \brief Sort the \c n_points points in \c x and \c y into
+	a grid, using distance scales \c x_scale and \c y_scale
+    */
+    void build(size_t n_points, const vec_t &x, const vec_t &y,
+	       double x_scale, double y_scale) {
+
+      if (n_points<1) {
+	O2SCL_ERR2("Must provide at least one point in ",
+		   "interp2_bucket::build().",exc_einval);
+      }
+      if (x_scale<=0.0 || y_scale<=0.0 || pts_per_cell<=0.0) {
+	O2SCL_ERR2("Scales and points per cell must be positive in ",
+		   "interp2_bucket::build().",exc_einval);
+      }
+
+      np=n_points;
+      ux=&x;
+      uy=&y;
+      dx=x_scale;
+      dy=y_scale;
+
+      // Determine the extent of the data
+      xlo=x[0];
+      ylo=y[0];
+      double xhi=x[0], yhi=y[0];
+      for(size_t i=1;i<np;i++) {
+	if (x[i]<xlo) xlo=x[i];
+	if (x[i]>xhi) xhi=x[i];
+	if (y[i]<ylo) ylo=y[i];
+	if (y[i]>yhi) yhi=y[i];
+      }
+
+      // Choose the number of cells in each direction so that the
+      // cells are roughly square in the scaled coordinates
+      double ncells=np/pts_per_cell;
+      if (ncells<1.0) ncells=1.0;
+      double ex=(xhi-xlo)/dx, ey=(yhi-ylo)/dy;
+      if (ex>0.0 && ey>0.0) {
+	nbx=(size_t)(sqrt(ncells*ex/ey)+0.5);
+	if (nbx<1) nbx=1;
+	if (nbx>np) nbx=np;
+	nby=(size_t)(ncells/nbx+0.5);
+	if (nby<1) nby=1;
+	if (nby>np) nby=np;
+      } else if (ex>0.0) {
+	nbx=(size_t)(ncells+0.5);
+	nby=1;
+      } else if (ey>0.0) {
+	nbx=1;
+	nby=(size_t)(ncells+0.5);
+      } else {
+	nbx=1;
+	nby=1;
+      }
+
+      cwx=(xhi-xlo)/nbx;
+      cwy=(yhi-ylo)/nby;
+      if (cwx<=0.0) cwx=1.0;
+      if (cwy<=0.0) cwy=1.0;
+
+      // Sort the points into the cells with a counting sort
+      std::vector<size_t> cell(np);
+      cell_start.assign(nbx*nby+1,0);
+      for(size_t i=0;i<np;i++) {
+	cell[i]=cell_x(x[i])*nby+cell_y(y[i]);
+	cell_start[cell[i]+1]++;
+      }
+      for(size_t j=0;j<nbx*nby;j++) {
+	cell_start[j+1]+=cell_start[j];
+      }
+      cell_index.resize(np);
+      std::vector<size_t> next(cell_start.begin(),cell_start.end()-1);
+      for(size_t i=0;i<np;i++) {
+	cell_index[next[cell[i]]++]=i;
+      }
+
+      return;
+    }
+
+    /** \brief Find the \c k points closest to \c (x,y)
+
+	The indices of the closest points are stored in the first
+	\c k entries of \c index and the associated distances in
+	\c dist, sorted by increasing distance. If \c take_sqrt is
+	false, then the squared distance is used instead (this can
+	matter for the ordering of points whose distances are equal
+	to within the machine precision). The value of \c k must not
+	be larger than the number of points.
+    */
+    void nearest(double x, double y, size_t k, size_t *index,
+		 double *dist, bool take_sqrt) const {
+
+      if (np==0) {
+	O2SCL_ERR("Grid not built in interp2_bucket::nearest().",
+		  exc_einval);
+      }
+      if (k<1 || k>np) {
+	O2SCL_ERR2("Invalid number of points in ",
+		   "interp2_bucket::nearest().",exc_einval);
+      }
+
+      size_t cx=cell_x(x), cy=cell_y(y), nfound=0;
+
+      // Examine successively larger square rings of cells
+      // centered on the cell containing the point
+      for(size_t r=0;true;r++) {
+
+	bool lo_x=(cx>=r), hi_x=(cx+r<nbx);
+	bool lo_y=(cy>=r), hi_y=(cy+r<nby);
+	size_t ix0=lo_x ? cx-r : 0, ix1=hi_x ? cx+r : nbx-1;
+	size_t iy0=lo_y ? cy-r : 0, iy1=hi_y ? cy+r : nby-1;
+
+	if (r==0) {
+	  search_cell(cx,cy,x,y,k,index,dist,nfound,take_sqrt);
+	} else {
+	  // The bottom and top rows of the ring
+	  for(size_t ix=ix0;ix<=ix1;ix++) {
+	    if (lo_y) search_cell(ix,iy0,x,y,k,index,dist,nfound,take_sqrt);
+	    if (hi_y) search_cell(ix,iy1,x,y,k,index,dist,nfound,take_sqrt);
+	  }
+	  // The left and right columns, excluding the corners
+	  size_t jy0=lo_y ? iy0+1 : iy0;
+	  size_t jy1=hi_y ? iy1 : iy1+1;
+	  for(size_t iy=jy0;iy<jy1;iy++) {
+	    if (lo_x) search_cell(ix0,iy,x,y,k,index,dist,nfound,take_sqrt);
+	    if (hi_x) search_cell(ix1,iy,x,y,k,index,dist,nfound,take_sqrt);
+	  }
+	}
+
+	// If the entire grid has been searched, we're done
+	bool more_x_lo=(cx>r), more_x_hi=(cx+r+1<nbx);
+	bool more_y_lo=(cy>r), more_y_hi=(cy+r+1<nby);
+	if (!more_x_lo && !more_x_hi && !more_y_lo && !more_y_hi) {
+	  return;
+	}
+
+	if (nfound==k) {
+
+	  // Compute a lower bound for the distance to any point in a
+	  // cell which has not yet been searched. The bound is
+	  // reduced slightly to account for the finite precision in
+	  // the cell assignments, and then converted to a distance
+	  // in the same way as for the data so that the comparison
+	  // below is exact.
+	  double lbm=std::numeric_limits<double>::infinity();
+	  if (more_x_lo) {
+	    double edge=xlo+(cx-r)*cwx;
+	    lbm=std::min(lbm,bound(x-edge,x,edge,cwx,dx,take_sqrt));
+	  }
+	  if (more_x_hi) {
+	    double edge=xlo+(cx+r+1)*cwx;
+	    lbm=std::min(lbm,bound(edge-x,x,edge,cwx,dx,take_sqrt));
+	  }
+	  if (more_y_lo) {
+	    double edge=ylo+(cy-r)*cwy;
+	    lbm=std::min(lbm,bound(y-edge,y,edge,cwy,dy,take_sqrt));
+	  }
+	  if (more_y_hi) {
+	    double edge=ylo+(cy+r+1)*cwy;
+	    lbm=std::min(lbm,bound(edge-y,y,edge,cwy,dy,take_sqrt));
+	  }
+
+	  if (dist[k-1]<lbm) return;
+	}
+
+      }
+
+      return;
+    }
+
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
+
+    /// The number of points
+    size_t np;
+    /// The number of cells in the x direction
+    size_t nbx;
+    /// The number of cells in the y direction
+    size_t nby;
+    /// The x-values
+    const vec_t *ux;
+    /// The y-values
+    const vec_t *uy;
+    /// The scale in the x direction
+    double dx;
+    /// The scale in the y direction
+    double dy;
+    /// The lower x edge of the grid
+    double xlo;
+    /// The lower y edge of the grid
+    double ylo;
+    /// The cell width in the x direction
+    double cwx;
+    /// The cell width in the y direction
+    double cwy;
+    /// The first entry in \ref cell_index for each cell
+    std::vector<size_t> cell_start;
+    /// The point indices, sorted by cell
+    std::vector<size_t> cell_index;
+
+    /// The x index of the cell containing \c x
+    size_t cell_x(double x) const {
+      double t=(x-xlo)/cwx;
+      if (!(t>0.0)) return 0;
+      if (t>=((double)nbx)) return nbx-1;
+      return (size_t)t;
+    }
+
+    /// The y index of the cell containing \c y
+    size_t cell_y(double y) const {
+      double t=(y-ylo)/cwy;
+      if (!(t>0.0)) return 0;
+      if (t>=((double)nby)) return nby-1;
+      return (size_t)t;
+    }
+
+    /** \brief Convert the coordinate difference \c delta between
+	\c x and the cell edge \c edge to a lower bound on the
+	distance
+    */
+    double bound(double delta, double x, double edge, double cw,
+		 double scale, bool take_sqrt) const {
+      delta-=1.0e-10*(fabs(x)+fabs(edge)+cw);
+      if (delta<=0.0) return 0.0;
+      double d=pow(delta/scale,2.0);
+      if (take_sqrt) return sqrt(d);
+      return d;
+    }
+
+    /** \brief Compare the points in cell <tt>(ix,iy)</tt> with
+	the \c nfound closest points found so far
+    */
+    void search_cell(size_t ix, size_t iy, double x, double y,
+		     size_t k, size_t *index, double *dist,
+		     size_t &nfound, bool take_sqrt) const {
+
+      size_t ic=ix*nby+iy;
+      for(size_t j=cell_start[ic];j<cell_start[ic+1];j++) {
+	size_t i=cell_index[j];
+	double d=pow((x-(*ux)[i])/dx,2.0)+pow((y-(*uy)[i])/dy,2.0);
+	if (take_sqrt) d=sqrt(d);
+
+	// Insert the new point, keeping the list sorted by
+	// distance and then by index
+	size_t m;
+	if (nfound<k) {
+	  m=nfound;
+	  nfound++;
+	} else if (d<dist[k-1] || (d==dist[k-1] && i<index[k-1])) {
+	  m=k-1;
+	} else {
+	  continue;
+	}
+	while (m>0 && (d<dist[m-1] || (d==dist[m-1] && i<index[m-1]))) {
+	  dist[m]=dist[m-1];
+	  index[m]=index[m-1];
+	  m--;
+	}
+	dist[m]=d;
+	index[m]=i;
+      }
+
+      return;
+    }
+
+#endif
+
+  };
+
+#ifndef DOXYGEN_NO_O2NS
+}
+#endif
+
+#endif
@@ -32,6 +32,12 @@
 #include <cmath>
 
 #include <o2scl/err_hnd.h>
+#include <o2scl/interp2_bucket.h>
+#include <o2scl/table3d.h>
+
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
 
 #ifndef DOXYGEN_NO_O2NS
 namespace o2scl {
@@ -54,16 +60,25 @@ namespace o2scl {
       \Delta x = x_{\mathrm{max}}-x_{\mathrm{min}} \f$ and \f$ \Delta
       y = y_{\mathrm{max}}-y_{\mathrm{min}} \f$ .
 
-      This class stores pointers to the data, not a copy. The data can
-      be changed between interpolations without an additional call to
-      \ref set_data(), but the scales may need to be recomputed with
-      \ref compute_scale().
+      This class stores pointers to the data, not a copy. The
+      function values can be changed between interpolations without
+      an additional call to \ref set_data(). If the x- or y-values
+      are changed, then \ref compute_scale() must be called to
+      recompute the scales and the search grid.
 
       The vector type can be any type with a suitably defined \c
       operator[].
       
-      \note This class operates by performing a \f$ {\cal O}(N) \f$
-      brute-force search to find the closest points. 
+      The data points are sorted into a grid of cells (see \ref
+      o2scl::interp2_bucket) when the data are set, so that the
+      closest point can usually be found by computing only a few
+      distances. The result is identical to that of a \f$ {\cal
+      O}(N) \f$ brute-force search over all the points, which is
+      used instead if \ref use_index is false.
+
+      The function \ref eval_table3d() interpolates the data onto
+      all of the grid points of a \ref o2scl::table3d object,
+      optionally using several OpenMP threads.
 
       \future Make a parent class for this and \ref o2scl::interp2_planar.
 
@@ -85,6 +100,7 @@ namespace o2scl {
 
     typedef boost::numeric::ublas::vector<double> ubvector;
     typedef boost::numeric::ublas::vector<size_t> ubvector_size_t;
+    typedef boost::numeric::ublas::matrix<double> ubmatrix;
     
     interp2_neigh() {
       data_set=false;
@@ -92,8 +108,20 @@ namespace o2scl {
       y_scale=-1.0;
       dx=0.0;
       dy=0.0;
+      use_index=true;
+      n_threads=1;
     }
 
+    /** \brief If true, use the grid of cells to find the closest
+	point (default true)
+    */
+    bool use_index;
+
+    /** \brief The number of OpenMP threads used in 
+	\ref eval_table3d() (default 1)
+    */
+    size_t n_threads;
+
     /// The user-specified x scale (default -1)
     double x_scale;
 
@@ -127,6 +155,8 @@ namespace o2scl {
 	O2SCL_ERR("No scale in interp2_planar::set_data().",exc_einval);
       }
 
+      bi.build(np,*ux,*uy,dx,dy);
+
       return;
     }
 
@@ -187,6 +217,15 @@ namespace o2scl {
 		  exc_einval);
       }
 
+      if (use_index) {
+	double dist_min;
+	bi.nearest(x,y,1,&i1,&dist_min,false);
+	f=(*uf)[i1];
+	x1=(*ux)[i1];
+	y1=(*uy)[i1];
+	return;
+      }
+
       // Exhaustively search the data
       i1=0;
       double dist_min=pow((x-(*ux)[i1])/dx,2.0)+pow((y-(*uy)[i1])/dy,2.0);
@@ -201,7 +240,48 @@ namespace o2scl {
       // Return the function value
 
       f=(*uf)[i1];
+      x1=(*ux)[i1];
+      y1=(*uy)[i1];
+
+      return;
+    }
+
+    /** \brief Interpolate the data at every grid point in 
+	\c t3d and store the result in slice \c slice
 
+	The grid in \c t3d must already be set. If the slice
+	does not exist, it is created. The rows of the slice are
+	divided among \ref n_threads OpenMP threads.
+    */
+    void eval_table3d(table3d &t3d, std::string slice) const {
+      
+      if (data_set==false) {
+	O2SCL_ERR("Data not set in interp2_neigh::eval_table3d().",
+		  exc_einval);
+      }
+      if (t3d.is_xy_set()==false) {
+	O2SCL_ERR("Grid not set in interp2_neigh::eval_table3d().",
+		  exc_einval);
+      }
+      
+      size_t iz;
+      if (t3d.is_slice(slice,iz)==false) {
+	t3d.new_slice(slice);
+	iz=t3d.lookup_slice(slice);
+      }
+      ubmatrix &sl=t3d.get_slice(iz);
+      size_t nx=t3d.get_nx(), ny=t3d.get_ny();
+      
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(n_threads) schedule(dynamic)
+#endif
+      for(size_t i=0;i<nx;i++) {
+	double x=t3d.get_grid_x(i);
+	for(size_t j=0;j<ny;j++) {
+	  sl(i,j)=eval(x,t3d.get_grid_y(j));
+	}
+      }
+      
       return;
     }
     
@@ -219,6 +299,8 @@ namespace o2scl {
     vec_t *uf;
     /// True if the data has been specified
     bool data_set;
+    /// The grid of cells used to find the closest point
+    interp2_bucket<vec_t> bi;
     
 #endif
 
@@ -35,6 +35,12 @@
 
 #include <o2scl/err_hnd.h>
 #include <o2scl/vector.h>
+#include <o2scl/interp2_bucket.h>
+#include <o2scl/table3d.h>
+
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
 
 #ifndef DOXYGEN_NO_O2NS
 namespace o2scl {
@@ -73,9 +79,10 @@ namespace o2scl {
       to the default value for the next interpolation.
 
       This class stores pointers to the data, not a copy. The
-      data can be changed between interpolations without an
-      additional call to \ref set_data(), but the scales may
-      need to be recomputed with \ref compute_scale().
+      function values can be changed between interpolations without
+      an additional call to \ref set_data(). If the x- or y-values
+      are changed, then \ref compute_scale() must be called to
+      recompute the scales and the search grid.
 
       The vector type can be any type with a suitably defined \c
       operator[].
@@ -84,12 +91,20 @@ namespace o2scl {
       \ref set_data() will call the error handler if the
       first argument is less than three.
       
-      \note This class operates by performing a \f$ {\cal O}(N) \f$
-      brute-force search to find the three closest points. If the
-      three closest points are colinear, then the data are sorted
-      by distance [ \f$ {\cal O}(N \log N) \f$ ], and the closest
+      \note The data points are sorted into a grid of cells (see
+      \ref o2scl::interp2_bucket) when the data are set, so that the
+      three closest points can usually be found by computing only a
+      few distances. The result is identical to that of the \f$
+      {\cal O}(N) \f$ brute-force search over all the points, which
+      is used instead if \ref use_index is false. If the three
+      closest points are colinear, then the data are sorted by
+      distance [ \f$ {\cal O}(N \log N) \f$ ], and the closest
       triplets are enumerated until a non-colinear triplet is found.
 
+      The function \ref eval_table3d() interpolates the data onto
+      all of the grid points of a \ref o2scl::table3d object,
+      optionally using several OpenMP threads.
+
       \note I believe this interpolation is a bit unstable because it
       doesn't ensure that the user-specified objective point is inside
       the region determined by the three closest data points, and this
@@ -111,6 +126,7 @@ namespace o2scl {
 
     typedef boost::numeric::ublas::vector<double> ubvector;
     typedef boost::numeric::ublas::vector<size_t> ubvector_size_t;
+    typedef boost::numeric::ublas::matrix<double> ubmatrix;
     
     interp2_planar() {
       data_set=false;
@@ -119,8 +135,20 @@ namespace o2scl {
       y_scale=-1.0;
       dx=0.0;
       dy=0.0;
+      use_index=true;
+      n_threads=1;
     }
 
+    /** \brief If true, use the grid of cells to find the closest
+	points (default true)
+    */
+    bool use_index;
+
+    /** \brief The number of OpenMP threads used in 
+	\ref eval_table3d() (default 1)
+    */
+    size_t n_threads;
+
     /// Threshold for colinearity (default \f$ 10^{-12} \f$)
     double thresh;
 
@@ -176,6 +204,8 @@ namespace o2scl {
 	O2SCL_ERR("No scale in interp2_planar::set_data().",exc_einval);
       }
 
+      bi.build(np,*ux,*uy,dx,dy);
+
       return;
     }
     
@@ -217,54 +247,20 @@ namespace o2scl {
 		  exc_einval);
       }
 
-      // First, we just find the three closest points by
-      // exhaustively searching the data
-      
-      // Put in initial points
-      i1=0; i2=1; i3=2;
-      double c1=sqrt(pow((x-(*ux)[0])/dx,2.0)+pow((y-(*uy)[0])/dy,2.0));
-      double c2=sqrt(pow((x-(*ux)[1])/dx,2.0)+pow((y-(*uy)[1])/dy,2.0));
-      double c3=sqrt(pow((x-(*ux)[2])/dx,2.0)+pow((y-(*uy)[2])/dy,2.0));
+      if (use_index) {
 
-      // Sort initial points
-      if (c2<c1) {
-	if (c3<c2) {
-	  // 321
-	  swap(i1,c1,i3,c3);
-	} else if (c3<c1) {
-	  // 231
-	  swap(i1,c1,i2,c2);
-	  swap(i2,c2,i3,c3);
-	} else {
-	  // 213
-	  swap(i1,c1,i2,c2);
-	}
+	// Find the three closest points using the grid
+	size_t ix[3];
+	double dist[3];
+	bi.nearest(x,y,3,ix,dist,true);
+	i1=ix[0];
+	i2=ix[1];
+	i3=ix[2];
+	
       } else {
-	if (c3<c1) {
-	  // 312
-	  swap(i1,c1,i3,c3);
-	  swap(i2,c2,i3,c3);
-	} else if (c3<c2) {
-	  // 132
-	  swap(i3,c3,i2,c2);
-	}
-	// 123
-      }
-
-      // Go through remaining points and sort accordingly
-      for(size_t j=3;j<np;j++) {
-	size_t i4=j;
-	double c4=sqrt(pow((x-(*ux)[i4])/dx,2.0)+pow((y-(*uy)[i4])/dy,2.0));
-	if (c4<c1) {
-	  swap(i4,c4,i3,c3);
-	  swap(i3,c3,i2,c2);
-	  swap(i2,c2,i1,c1);
-	} else if (c4<c2) {
-	  swap(i4,c4,i3,c3);
-	  swap(i3,c3,i2,c2);
-	} else if (c4<c3) {
-	  swap(i4,c4,i3,c3);
-	}
+	
+	brute_force(x,y,i1,i2,i3);
+	
       }
 
       // Solve for denominator:
@@ -346,6 +342,45 @@ namespace o2scl {
 
       return;
     }
+
+    /** \brief Interpolate the data at every grid point in 
+	\c t3d and store the result in slice \c slice
+
+	The grid in \c t3d must already be set. If the slice
+	does not exist, it is created. The rows of the slice are
+	divided among \ref n_threads OpenMP threads.
+    */
+    void eval_table3d(table3d &t3d, std::string slice) const {
+      
+      if (data_set==false) {
+	O2SCL_ERR("Data not set in interp2_planar::eval_table3d().",
+		  exc_einval);
+      }
+      if (t3d.is_xy_set()==false) {
+	O2SCL_ERR("Grid not set in interp2_planar::eval_table3d().",
+		  exc_einval);
+      }
+      
+      size_t iz;
+      if (t3d.is_slice(slice,iz)==false) {
+	t3d.new_slice(slice);
+	iz=t3d.lookup_slice(slice);
+      }
+      ubmatrix &sl=t3d.get_slice(iz);
+      size_t nx=t3d.get_nx(), ny=t3d.get_ny();
+      
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(n_threads) schedule(dynamic)
+#endif
+      for(size_t i=0;i<nx;i++) {
+	double x=t3d.get_grid_x(i);
+	for(size_t j=0;j<ny;j++) {
+	  sl(i,j)=eval(x,t3d.get_grid_y(j));
+	}
+      }
+      
+      return;
+    }
     
 #ifndef DOXYGEN_INTERNAL
 
@@ -361,6 +396,64 @@ namespace o2scl {
     vec_t *uf;
     /// True if the data has been specified
     bool data_set;
+    /// The grid of cells used to find the closest points
+    interp2_bucket<vec_t> bi;
+    
+    /** \brief Find the three closest points by exhaustively 
+	searching the data
+    */
+    void brute_force(double x, double y, size_t &i1, size_t &i2,
+		     size_t &i3) const {
+
+      // Put in initial points
+      i1=0; i2=1; i3=2;
+      double c1=sqrt(pow((x-(*ux)[0])/dx,2.0)+pow((y-(*uy)[0])/dy,2.0));
+      double c2=sqrt(pow((x-(*ux)[1])/dx,2.0)+pow((y-(*uy)[1])/dy,2.0));
+      double c3=sqrt(pow((x-(*ux)[2])/dx,2.0)+pow((y-(*uy)[2])/dy,2.0));
+
+      // Sort initial points
+      if (c2<c1) {
+	if (c3<c2) {
+	  // 321
+	  swap(i1,c1,i3,c3);
+	} else if (c3<c1) {
+	  // 231
+	  swap(i1,c1,i2,c2);
+	  swap(i2,c2,i3,c3);
+	} else {
+	  // 213
+	  swap(i1,c1,i2,c2);
+	}
+      } else {
+	if (c3<c1) {
+	  // 312
+	  swap(i1,c1,i3,c3);
+	  swap(i2,c2,i3,c3);
+	} else if (c3<c2) {
+	  // 132
+	  swap(i3,c3,i2,c2);
+	}
+	// 123
+      }
+
+      // Go through remaining points and sort accordingly
+      for(size_t j=3;j<np;j++) {
+	size_t i4=j;
+	double c4=sqrt(pow((x-(*ux)[i4])/dx,2.0)+pow((y-(*uy)[i4])/dy,2.0));
+	if (c4<c1) {
+	  swap(i4,c4,i3,c3);
+	  swap(i3,c3,i2,c2);
+	  swap(i2,c2,i1,c1);
+	} else if (c4<c2) {
+	  swap(i4,c4,i3,c3);
+	  swap(i3,c3,i2,c2);
+	} else if (c4<c3) {
+	  swap(i4,c4,i3,c3);
+	}
+      }
+
+      return;
+    }
     
     /// Swap points 1 and 2.
     int swap(size_t &index_1, double &dist_1, size_t &index_2, 
@@ -58,6 +58,67 @@ int main(void) {
   cout << ip.eval(0.4,0.5) << endl;
   cout << ip.eval(0.03,1.0) << endl;
 
+  // Compare the grid search with the brute-force search for a
+  // larger data set which has some repeated and clustered points
+  {
+    size_t N=2000;
+    ubvector x2(N), y2(N), f2(N);
+    for(size_t i=0;i<N;i++) {
+      if (i%10==9) {
+	// Repeat a previous point
+	x2[i]=x2[i/2];
+	y2[i]=y2[i/2];
+      } else if (i%4==0) {
+	// A cluster near (0.9,0.1)
+	x2[i]=0.9+0.01*sin(i*1.3);
+	y2[i]=0.1+0.01*cos(i*2.7);
+      } else {
+	x2[i]=fmod(i*0.6180339887,1.0);
+	y2[i]=fmod(i*0.7548776662,1.0)*2.0;
+      }
+      f2[i]=sin(3.0*x2[i])*cos(2.0*y2[i]);
+    }
+    
+    interp2_planar<ubvector> in1, in2;
+    in1.set_data(N,x2,y2,f2);
+    in2.use_index=false;
+    in2.set_data(N,x2,y2,f2);
+
+    bool match=true;
+    for(size_t i=0;i<5000;i++) {
+      double xq=fmod(i*0.5698402910,1.0)*1.6-0.3;
+      double yq=fmod(i*0.8191725134,1.0)*2.6-0.3;
+      if (i%7==0) {
+	// Query exactly at a data point
+	xq=x2[i%N];
+	yq=y2[i%N];
+      }
+      double fa, fb, xa, ya, xb, yb, xc, yc;
+      size_t ja, jb, ka, kb, la, lb;
+      in1.eval_points(xq,yq,fa,ja,xa,ya,ka,xb,yb,la,xc,yc);
+      in2.eval_points(xq,yq,fb,jb,xa,ya,kb,xb,yb,lb,xc,yc);
+      if (fa!=fb || ja!=jb || ka!=kb || la!=lb) match=false;
+    }
+    t.test_gen(match,"grid and brute-force search");
+
+    // Fill a table3d object using two threads and compare
+    table3d t3d;
+    uniform_grid_end<double> gx(-0.2,1.2,70), gy(-0.2,2.2,90);
+    t3d.set_xy("x",gx,"y",gy);
+    in1.n_threads=2;
+    in1.eval_table3d(t3d,"f");
+    bool match2=true;
+    for(size_t i=0;i<t3d.get_nx();i++) {
+      for(size_t j=0;j<t3d.get_ny();j++) {
+	if (t3d.get(i,j,"f")!=in2.eval(t3d.get_grid_x(i),
+					 t3d.get_grid_y(j))) {
+	  match2=false;
+	}
+      }
+    }
+    t.test_gen(match2,"eval_table3d");
+  }
+
   t.report();
   return 0;
 }
@@ -30,6 +30,11 @@
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <algorithm>
+
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
 
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -104,6 +109,18 @@ namespace o2scl {
       time required to compute the nearest points which are
       nondegenerate.
 
+      By default, the nearest points are found using a k-d tree
+      which is constructed in \ref set_data(), so that each
+      evaluation requires on average only \f$ {\cal O}(\log N) \f$
+      distance computations rather than \f$ N \f$ . The tree
+      divides the coordinates without regard to the scales, so it
+      remains valid if the scales are changed, but if the data is
+      modified after \ref set_data() then \ref build_tree() must
+      be called again. The tree is only used when \ref use_tree is
+      true and \ref dist_expo is equal to 2, and it gives exactly
+      the same set of nearest points (in the same order, even in
+      the case of ties) as the brute-force search.
+
       \todo Make verbose output consistent between the various
       eval() functions.
 
@@ -129,8 +146,14 @@ namespace o2scl {
     n_extra=0;
     min_dist=1.0e-6;
     dist_expo=2.0;
+    use_tree=true;
   }
 
+  /** \brief If true, use a k-d tree to find the nearest 
+      points (default true)
+  */
+  bool use_tree;
+
   /** \brief Exponent in computing distance (default 2.0)
    */
   double dist_expo;
@@ -217,6 +240,22 @@ namespace o2scl {
       auto_scale();
     }
 
+    build_tree();
+
+    return;
+  }
+
+  /** \brief Construct the k-d tree used to find the nearest
+      points
+
+      This function is called automatically by \ref set_data(),
+      but must be called again if the data is modified.
+  */
+  void build_tree() {
+    tree.clear();
+    tree_index.resize(np);
+    for(size_t i=0;i<np;i++) tree_index[i]=i;
+    if (np>0) build_node(0,np);
     return;
   }
 
@@ -229,6 +268,8 @@ namespace o2scl {
     n_out=nd_out;
     std::swap(data,dat);
     data_set=false;
+    tree.clear();
+    tree_index.clear();
     n_points=0;
     n_in=0;
     n_out=0;
@@ -284,16 +325,10 @@ namespace o2scl {
 		exc_einval);
     }
     
-    // Compute distances
-    std::vector<double> dists(np);
-    for(size_t i=0;i<np;i++) {
-      dists[i]=dist(i,x);
-    }
-
-    // Find closest points
+    // Find closest points and their distances
     std::vector<size_t> index;
-    o2scl::vector_smallest_index<std::vector<double>,double,
-    std::vector<size_t> >(dists,points+n_extra,index);
+    std::vector<double> dists;
+    nearest(x,points+n_extra,index,dists);
 
     if (n_extra>0) {
       // Remove degenerate points to ensure accurate interpolation
@@ -307,6 +342,7 @@ namespace o2scl {
 	    if (index.size()>points && dist_jk<min_dist) {
 	      found=true;
 	      index.erase(index.begin()+j);
+	      dists.erase(dists.begin()+j);
 	    }
 	  }
 	}
@@ -314,20 +350,20 @@ namespace o2scl {
     }
       
     // Check if the closest distance is zero
-    if (dists[index[0]]<=0.0) {
+    if (dists[0]<=0.0) {
       return data(nd_in,index[0]);
     }
 
     // Compute normalization
     double norm=0.0;
     for(size_t i=0;i<points;i++) {
-      norm+=1.0/dists[index[i]];
+      norm+=1.0/dists[i];
     }
 
     // Compute the inverse-distance weighted average
     double ret=0.0;
     for(size_t i=0;i<points;i++) {
-      ret+=data(nd_in,index[i])/dists[index[i]];
+      ret+=data(nd_in,index[i])/dists[i];
     }
     ret/=norm;
 
@@ -346,16 +382,10 @@ namespace o2scl {
 		exc_einval);
     }
       
-    // Compute distances
-    std::vector<double> dists(np);
-    for(size_t i=0;i<np;i++) {
-      dists[i]=dist(i,x);
-    }
-
-    // Find closest points
+    // Find closest points and their distances
     std::vector<size_t> index;
-    o2scl::vector_smallest_index<std::vector<double>,double,
-    std::vector<size_t> >(dists,points+1+n_extra,index);
+    std::vector<double> dists;
+    nearest(x,points+1+n_extra,index,dists);
 
     if (n_extra>0) {
       // Remove degenerate points to ensure accurate interpolation
@@ -369,13 +399,14 @@ namespace o2scl {
 	    if (index.size()>points+1 && dist_jk<min_dist) {
 	      found=true;
 	      index.erase(index.begin()+j);
+	      dists.erase(dists.begin()+j);
 	    }
 	  }
 	}
       }
     }
       
-    if (dists[index[0]]<=0.0) {
+    if (dists[0]<=0.0) {
 
       // If the closest distance is zero, just set the value
       val=data(nd_in,index[0]);
@@ -391,14 +422,14 @@ namespace o2scl {
 	// Compute normalization
 	double norm=0.0;
 	for(size_t i=0;i<points+1;i++) {
-	  if (i!=j) norm+=1.0/dists[index[i]];
+	  if (i!=j) norm+=1.0/dists[i];
 	}
 	  
 	// Compute the inverse-distance weighted average
 	vals[j]=0.0;
 	for(size_t i=0;i<points+1;i++) {
 	  if (i!=j) {
-	    vals[j]+=data(nd_in,index[i])/dists[index[i]];
+	    vals[j]+=data(nd_in,index[i])/dists[i];
 	  }
 	}
 	vals[j]/=norm;
@@ -432,16 +463,10 @@ namespace o2scl {
       std::cout << std::endl;
     }
       
-    // Compute distances
-    std::vector<double> dists(np);
-    for(size_t i=0;i<np;i++) {
-      dists[i]=dist(i,x);
-    }
-
-    // Find closest points
+    // Find closest points and their distances
     std::vector<size_t> index;
-    o2scl::vector_smallest_index<std::vector<double>,double,
-    std::vector<size_t> >(dists,points,index);
+    std::vector<double> dists;
+    nearest(x,points,index,dists);
     if (verbose>0) {
       for(size_t i=0;i<points;i++) {
 	std::cout << "interpm_idw: closest point: ";
@@ -464,6 +489,7 @@ namespace o2scl {
 	    if (index.size()>points && dist_jk<min_dist) {
 	      found=true;
 	      index.erase(index.begin()+j);
+	      dists.erase(dists.begin()+j);
 	    }
 	  }
 	}
@@ -472,7 +498,7 @@ namespace o2scl {
       
     // Check if the closest distance is zero, if so, just
     // return the value
-    if (dists[index[0]]<=0.0) {
+    if (dists[0]<=0.0) {
       for(size_t i=0;i<nd_out;i++) {
 	y[i]=data(nd_in+i,index[0]);
       }
@@ -488,7 +514,7 @@ namespace o2scl {
     // Compute normalization
     double norm=0.0;
     for(size_t i=0;i<points;i++) {
-      norm+=1.0/dists[index[i]];
+      norm+=1.0/dists[i];
     }
     if (verbose>0) {
       std::cout << "interpm_idw: norm is " << norm << std::endl;
@@ -505,12 +531,12 @@ namespace o2scl {
 	  }
 	  std::cout << std::endl;
 	}
-	y[j]+=data(nd_in+j,index[i])/dists[index[i]];
+	y[j]+=data(nd_in+j,index[i])/dists[i];
 	if (verbose>0) {
 	  std::cout << "interpm_idw: j,points,value,1/dist: "
 		    << j << " " << i << " "
 		    << data(nd_in+j,index[i]) << " "
-		    << 1.0/dists[index[i]] << std::endl;
+		    << 1.0/dists[i] << std::endl;
 	}
       }
       y[j]/=norm;
@@ -539,16 +565,10 @@ namespace o2scl {
 		exc_einval);
     }
       
-    // Compute distances
-    std::vector<double> dists(np);
-    for(size_t i=0;i<np;i++) {
-      dists[i]=dist(i,x);
-    }
-
-    // Find closest points, note that index is automatically resized
-    // by the vector_smallest_index function
-    o2scl::vector_smallest_index<std::vector<double>,double,
-    std::vector<size_t> >(dists,points+1+n_extra,index);
+    // Find closest points and their distances, note that index is
+    // automatically resized by the nearest() function
+    std::vector<double> dists;
+    nearest(x,points+1+n_extra,index,dists);
 
     if (n_extra>0) {
       // Remove degenerate points to ensure accurate interpolation
@@ -562,13 +582,14 @@ namespace o2scl {
 	    if (index.size()>points+1 && dist_jk<min_dist) {
 	      found=true;
 	      index.erase(index.begin()+j);
+	      dists.erase(dists.begin()+j);
 	    }
 	  }
 	}
       }
     }
 
-    if (dists[index[0]]<=0.0) {
+    if (dists[0]<=0.0) {
 
       // If the closest distance is zero, just set the values and
       // errors
@@ -589,14 +610,14 @@ namespace o2scl {
 	  // Compute normalization
 	  double norm=0.0;
 	  for(size_t i=0;i<points+1;i++) {
-	    if (i!=j) norm+=1.0/dists[index[i]];
+	    if (i!=j) norm+=1.0/dists[i];
 	  }
 	    
 	  // Compute the inverse-distance weighted average
 	  vals[j]=0.0;
 	  for(size_t i=0;i<points+1;i++) {
 	    if (i!=j) {
-	      vals[j]+=data(nd_in+k,index[i])/dists[index[i]];
+	      vals[j]+=data(nd_in+k,index[i])/dists[i];
 	    }
 	  }
 	  vals[j]/=norm;
@@ -625,6 +646,87 @@ namespace o2scl {
     std::vector<size_t> index;
     return eval_err_index(x,val,err,index);
   }
+
+  /** \brief Perform the interpolation over all the functions
+      for \c n points
+
+      The coordinates of point \c i are given in
+      <tt>x(i,0)</tt> through <tt>x(i,n_in-1)</tt> and the
+      results are stored in <tt>y(i,0)</tt> through 
+      <tt>y(i,n_out-1)</tt>. The points are divided among
+      the OpenMP threads.
+  */
+  template<class mat2_t, class mat3_t>
+  void eval_many(size_t n, const mat2_t &x, mat3_t &y) const {
+    
+    if (data_set==false) {
+      O2SCL_ERR("Data not set in interpm_idw::eval_many().",
+		exc_einval);
+    }
+
+#ifdef O2SCL_OPENMP
+#pragma omp parallel
+#endif
+    {
+      // Separate storage for each thread
+      ubvector xi(nd_in), yi(nd_out);
+      
+#ifdef O2SCL_OPENMP
+#pragma omp for schedule(dynamic,64)
+#endif
+      for(size_t i=0;i<n;i++) {
+	for(size_t k=0;k<nd_in;k++) xi[k]=x(i,k);
+	eval(xi,yi);
+	for(size_t k=0;k<nd_out;k++) y(i,k)=yi[k];
+      }
+      
+      // End of parallel region
+    }
+    
+    return;
+  }
+
+  /** \brief Perform the interpolation over all the functions
+      with uncertainties for \c n points
+
+      The points and the results are specified as in \ref
+      eval_many(), and the uncertainties are stored in \c err
+      in the same format as \c y .
+  */
+  template<class mat2_t, class mat3_t, class mat4_t>
+  void eval_err_many(size_t n, const mat2_t &x, mat3_t &y,
+		     mat4_t &err) const {
+    
+    if (data_set==false) {
+      O2SCL_ERR("Data not set in interpm_idw::eval_err_many().",
+		exc_einval);
+    }
+
+#ifdef O2SCL_OPENMP
+#pragma omp parallel
+#endif
+    {
+      // Separate storage for each thread
+      ubvector xi(nd_in), yi(nd_out), ei(nd_out);
+      std::vector<size_t> index;
+      
+#ifdef O2SCL_OPENMP
+#pragma omp for schedule(dynamic,64)
+#endif
+      for(size_t i=0;i<n;i++) {
+	for(size_t k=0;k<nd_in;k++) xi[k]=x(i,k);
+	eval_err_index(xi,yi,ei,index);
+	for(size_t k=0;k<nd_out;k++) {
+	  y(i,k)=yi[k];
+	  err(i,k)=ei[k];
+	}
+      }
+      
+      // End of parallel region
+    }
+    
+    return;
+  }
   //@}
 
   /// \name Evaluate derivatives
@@ -664,15 +766,10 @@ namespace o2scl {
     // The linear solver
     o2scl_linalg::linear_solver_HH<> lshh;
     
-    // Compute distances
-    std::vector<double> dists(np);
-    for(size_t i=0;i<np;i++) {
-      dists[i]=dist(i,x);
-    }
-  
     // Find closest (but not identical) points
 
     std::vector<size_t> index;
+    std::vector<double> dists;
     size_t max_smallest=(nd_in+2)*2;
     if (max_smallest>np) max_smallest=np;
     if (max_smallest<nd_in+1) {
@@ -683,20 +780,21 @@ namespace o2scl {
       std::cout << "max_smallest: " << max_smallest << std::endl;
     }
       
-    o2scl::vector_smallest_index<std::vector<double>,double,
-    std::vector<size_t> >(dists,max_smallest,index);
+    nearest(x,max_smallest,index,dists);
 
     if (verbose>0) {
       for(size_t i=0;i<index.size();i++) {
 	std::cout << "index[" << i << "] = " << index[i] << " "
-		  << dists[index[i]] << std::endl;
+		  << dists[i] << std::endl;
       }
     }
       
     std::vector<size_t> index2;
+    std::vector<double> dists2;
     for(size_t i=0;i<max_smallest;i++) {
-      if (dists[index[i]]>0.0) {
+      if (dists[i]>0.0) {
 	index2.push_back(index[i]);
+	dists2.push_back(dists[i]);
 	if (index2.size()==nd_in+1) i=max_smallest;
       }
     }
@@ -708,7 +806,7 @@ namespace o2scl {
     if (verbose>0) {
       for(size_t i=0;i<index2.size();i++) {
 	std::cout << "index2[" << i << "] = " << index2[i] << " "
-	<< dists[index2[i]] << std::endl;
+	<< dists2[i] << std::endl;
       }
     }
       
@@ -865,6 +963,207 @@ namespace o2scl {
     return sqrt(ret);
   }
   //@}
+
+  /// \name Nearest point search [protected]
+  //@{
+  /** \brief A node in the k-d tree
+
+      Leaves have \c left equal to zero, since the root node
+      (with index 0) is never a child. 
+  */
+  typedef struct kd_node_s {
+    /// The first index in \ref tree_index for this node
+    size_t lo;
+    /// One past the last index in \ref tree_index for this node
+    size_t hi;
+    /// The coordinate used to divide this node
+    size_t dim;
+    /// The value of the coordinate which divides this node
+    double split;
+    /// The child with coordinates less than or equal to \c split
+    size_t left;
+    /// The child with coordinates greater than or equal to \c split
+    size_t right;
+  } kd_node;
+
+  /// The nodes of the k-d tree
+  std::vector<kd_node> tree;
+
+  /// The point indices, ordered so that each node is contiguous
+  std::vector<size_t> tree_index;
+
+  /// The maximum number of points in a leaf of the k-d tree
+  static const size_t tree_leaf_size=16;
+
+  /** \brief Recursively construct the node containing
+      <tt>tree_index[lo]</tt> through <tt>tree_index[hi-1]</tt> and
+      return its index
+  */
+  size_t build_node(size_t lo, size_t hi) {
+    
+    size_t inode=tree.size();
+    kd_node nd;
+    nd.lo=lo;
+    nd.hi=hi;
+    nd.dim=0;
+    nd.split=0.0;
+    nd.left=0;
+    nd.right=0;
+    tree.push_back(nd);
+    
+    if (hi-lo<=tree_leaf_size) return inode;
+
+    // Divide along the coordinate with the largest extent
+    size_t nscales=scales.size();
+    size_t dim=0;
+    double best=0.0;
+    for(size_t i=0;i<nd_in;i++) {
+      double min=data(i,tree_index[lo]), max=min;
+      for(size_t j=lo+1;j<hi;j++) {
+	double val=data(i,tree_index[j]);
+	if (val<min) min=val;
+	if (val>max) max=val;
+      }
+      double ext=(max-min)/scales[i%nscales];
+      if (ext>best) {
+	best=ext;
+	dim=i;
+      }
+    }
+    
+    // If all the points are identical, leave this node as a leaf
+    if (best<=0.0) return inode;
+
+    size_t mid=(lo+hi)/2;
+    const mat_t &d=data;
+    std::nth_element(tree_index.begin()+lo,tree_index.begin()+mid,
+		     tree_index.begin()+hi,
+		     [&d,dim](size_t a, size_t b) {
+		       return d(dim,a)<d(dim,b);
+		     });
+    double split=data(dim,tree_index[mid]);
+    
+    size_t left=build_node(lo,mid);
+    size_t right=build_node(mid,hi);
+    tree[inode].dim=dim;
+    tree[inode].split=split;
+    tree[inode].left=left;
+    tree[inode].right=right;
+    
+    return inode;
+  }
+
+  /** \brief Add the \c k closest points in node \c inode to the
+      max-heap \c heap
+  */
+  template<class vec2_t>
+  void tree_knn(size_t inode, const vec2_t &x, size_t k,
+		std::vector<std::pair<double,size_t> > &heap) const {
+    const kd_node &nd=tree[inode];
+    if (nd.left==0) {
+      for(size_t j=nd.lo;j<nd.hi;j++) {
+	double d=dist(tree_index[j],x);
+	if (heap.size()<k) {
+	  heap.push_back(std::make_pair(d,tree_index[j]));
+	  std::push_heap(heap.begin(),heap.end());
+	} else if (d<heap.front().first) {
+	  std::pop_heap(heap.begin(),heap.end());
+	  heap.back()=std::make_pair(d,tree_index[j]);
+	  std::push_heap(heap.begin(),heap.end());
+	}
+      }
+      return;
+    }
+    double diff=(x[nd.dim]-nd.split)/scales[nd.dim%scales.size()];
+    size_t near=nd.right, far=nd.left;
+    if (diff<=0.0) {
+      near=nd.left;
+      far=nd.right;
+    }
+    tree_knn(near,x,k,heap);
+    // The small tolerance ensures that roundoff in the distance 
+    // computation never causes a point to be skipped
+    if (heap.size()<k || fabs(diff)<=heap.front().first*(1.0+1.0e-12)) {
+      tree_knn(far,x,k,heap);
+    }
+    return;
+  }
+
+  /** \brief Add all points in node \c inode with a distance less
+      than or equal to \c dmax to \c found
+  */
+  template<class vec2_t>
+  void tree_range(size_t inode, const vec2_t &x, double dmax,
+		  std::vector<std::pair<size_t,double> > &found) const {
+    const kd_node &nd=tree[inode];
+    if (nd.left==0) {
+      for(size_t j=nd.lo;j<nd.hi;j++) {
+	double d=dist(tree_index[j],x);
+	if (d<=dmax) found.push_back(std::make_pair(tree_index[j],d));
+      }
+      return;
+    }
+    double diff=(x[nd.dim]-nd.split)/scales[nd.dim%scales.size()];
+    double dtol=dmax*(1.0+1.0e-12);
+    if (diff<=0.0 || diff<=dtol) tree_range(nd.left,x,dmax,found);
+    if (diff>=0.0 || -diff<=dtol) tree_range(nd.right,x,dmax,found);
+    return;
+  }
+  
+  /** \brief Find the \c k points closest to \c x, storing their
+      indices in \c index and their distances in \c dists
+
+      The points are sorted by distance, and the result
+      is identical to that from \ref vector_smallest_index()
+      applied to the vector of distances to all points.
+  */
+  template<class vec2_t>
+  void nearest(const vec2_t &x, size_t k, std::vector<size_t> &index,
+	       std::vector<double> &dists) const {
+
+    if (!use_tree || dist_expo!=2.0 || tree.size()==0 || k>np) {
+      
+      // Brute force search
+      std::vector<double> all(np);
+      for(size_t i=0;i<np;i++) {
+	all[i]=dist(i,x);
+      }
+      o2scl::vector_smallest_index<std::vector<double>,double,
+	std::vector<size_t> >(all,k,index);
+      dists.resize(index.size());
+      for(size_t i=0;i<index.size();i++) dists[i]=all[index[i]];
+      return;
+    }
+
+    // Find the k-th smallest distance
+    std::vector<std::pair<double,size_t> > heap;
+    heap.reserve(k);
+    tree_knn(0,x,k,heap);
+    double dk=heap.front().first;
+
+    // Find all points within that distance, including any ties,
+    // and order them by index
+    std::vector<std::pair<size_t,double> > found;
+    tree_range(0,x,dk,found);
+    std::sort(found.begin(),found.end());
+
+    // Select the k smallest in the same way as the brute force
+    // search, so that ties are handled identically
+    std::vector<double> sub(found.size());
+    for(size_t i=0;i<found.size();i++) sub[i]=found[i].second;
+    std::vector<size_t> subix;
+    o2scl::vector_smallest_index<std::vector<double>,double,
+      std::vector<size_t> >(sub,k,subix);
+    index.resize(k);
+    dists.resize(k);
+    for(size_t i=0;i<k;i++) {
+      index[i]=found[subix[i]].first;
+      dists[i]=sub[subix[i]];
+    }
+    
+    return;
+  }
+  //@}
     
 #endif
     
@@ -21,6 +21,7 @@
   -------------------------------------------------------------------
 */
 #include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
 
 #include <o2scl/test_mgr.h>
 #include <o2scl/interpm_idw.h>
@@ -33,6 +34,7 @@ using namespace std;
 using namespace o2scl;
 
 typedef boost::numeric::ublas::vector<double> ubvector;
+typedef boost::numeric::ublas::matrix<double> ubmatrix;
 
 double ft(double x, double y, double z) {
   return 3.0-2.0*x*x+7.0*y*z-5.0*z*x;
@@ -176,6 +178,64 @@ int main(void) {
   }
   cout << endl;
 
+  cout << "Compare the k-d tree with the brute-force search." << endl;
+  {
+    // Random points and points on a grid, so that there are
+    // many ties in the distances
+    size_t N=2000;
+    std::vector<std::vector<double> > dat4(4);
+    for(size_t i=0;i<N;i++) {
+      double x4, y4, z4;
+      if (i%2==0) {
+	x4=rg.random();
+	y4=rg.random();
+	z4=rg.random();
+      } else {
+	x4=((double)((i/2)%10))/9.0;
+	y4=((double)((i/20)%10))/9.0;
+	z4=((double)((i/200)%10))/9.0;
+      }
+      dat4[0].push_back(x4);
+      dat4[1].push_back(y4);
+      dat4[2].push_back(z4);
+      dat4[3].push_back(ft(x4,y4,z4));
+    }
+    matrix_view_vec_vec<vector<double> > mv4(dat4);
+    interpm_idw<matrix_view_vec_vec<vector<double> > > imi4;
+    imi4.set_data(3,1,N,mv4);
+
+    size_t n_pts=100;
+    ubmatrix pts(n_pts,3), res(n_pts,1);
+    bool same=true;
+    for(size_t j=0;j<n_pts;j++) {
+      std::vector<double> p4(3);
+      for(size_t k=0;k<3;k++) {
+	// Include some points exactly on the grid
+	if (j%4==0) p4[k]=((double)((j+k)%10))/9.0;
+	else p4[k]=rg.random();
+	pts(j,k)=p4[k];
+      }
+      std::vector<double> v1(1), e1(1), v2(1), e2(1);
+      std::vector<size_t> ix1, ix2;
+      imi4.use_tree=true;
+      imi4.eval_err_index(p4,v1,e1,ix1);
+      imi4.use_tree=false;
+      imi4.eval_err_index(p4,v2,e2,ix2);
+      if (v1[0]!=v2[0] || e1[0]!=e2[0] || ix1!=ix2) same=false;
+    }
+    t.test_gen(same,"tree vs. brute force");
+
+    imi4.use_tree=true;
+    imi4.eval_many(n_pts,pts,res);
+    same=true;
+    for(size_t j=0;j<n_pts;j++) {
+      std::vector<double> p4={pts(j,0),pts(j,1),pts(j,2)};
+      if (res(j,0)!=imi4.eval(p4)) same=false;
+    }
+    t.test_gen(same,"eval_many");
+  }
+  cout << endl;
+
   cout << "Show that partial derivatives get better with more points."
        << endl;
   for(size_t N=10;N<1000000;N*=10) {
@@ -440,11 +440,25 @@ namespace o2scl {
   /// Pointer to the user-specified minimizer
   min_base<> *mp;
   
-  /** \brief Function to optimize the covariance parameters
-   */
+  /** \brief Compute the quality function for length scale \c xlen
+      and store the inverse covariance matrix times \c y in \c kinvf
+
+      The leave-one-out residuals are computed from the inverse of
+      the full covariance matrix \f$ K \f$ using the identity
+      \f[
+      y_i - \mu_{-i} = \frac{\left[K^{-1} y\right]_i}
+      {\left[K^{-1}\right]_{ii}}
+      \f]
+      where \f$ \mu_{-i} \f$ is the prediction at point \f$ i \f$
+      from the data with point \f$ i \f$ removed. Thus all of
+      the residuals require only one matrix factorization.
+
+      This function does not modify the class data and may be
+      called simultaneously from several threads.
+  */
   template<class vec3_t> 
-  double qual_fun(double xlen, double noise_var, size_t iout,
-		  vec3_t &y, int &success) {
+  double qual_fun_kinvf(double xlen, double noise_var, vec3_t &y,
+			int &success, ubvector &kinvf) {
 
     double ret=0.0;
     
@@ -452,214 +466,131 @@ namespace o2scl {
 
     size_t size=this->x.size1();
 
-    if (mode==mode_loo_cv) {
-
-      for(size_t ell=0;ell<loo_npts;ell++) {
-
-	// Create the new data objects, x_jk and y_jk
-	size_t row=ell*size/loo_npts;
-	matrix_view_omit_row<mat_t> x_jk(this->x,row);
-	ubvector y_jk(size-1);
-	vector_copy_jackknife(size,y,row,y_jk);
-
-	// Now perform the matrix analysis with those objects
-
-	// Construct the KXX matrix
-	ubmatrix KXX(size-1,size-1);
-	for(size_t irow=0;irow<size-1;irow++) {
-	  matrix_row_gen<matrix_view_omit_row<mat_t> > xrow(x_jk,irow);
-	  for(size_t icol=0;icol<size-1;icol++) {
-	    matrix_row_gen<matrix_view_omit_row<mat_t> > xcol(x_jk,icol);
-	    if (irow>icol) {
-	      KXX(irow,icol)=KXX(icol,irow);
-	    } else {
-	      KXX(irow,icol)=covar<
-		matrix_row_gen<matrix_view_omit_row<mat_t> >,
-		matrix_row_gen<matrix_view_omit_row<mat_t> > >
-		(xrow,xcol,this->nd_in,xlen);
-	      if (irow==icol) KXX(irow,icol)+=noise_var;
-	    }
-	  }
-	}
-	
-	if (this->matrix_mode==this->matrix_cholesky) {
-	  
-	  // Construct the inverse of KXX
-	  if (verbose>2) {
-	    std::cout << "Performing Cholesky decomposition with size "
-		      << size-1 << std::endl;
-	  }
-	  int cret=o2scl_linalg::cholesky_decomp(size-1,KXX,false);
-	  if (cret!=0) {
-	    success=1;
-	    return 1.0e99;
-	  }
-	  if (verbose>2) {
-	    std::cout << "Performing matrix inversion with size "
-		      << size-1 << std::endl;
-	  }
-
-	  o2scl_linalg::cholesky_invert<ubmatrix>(size-1,KXX);
-	  
-	  // Inverse covariance matrix times function vector
-	  this->Kinvf[iout].resize(size-1);
-	  o2scl_cblas::dgemv(o2scl_cblas::o2cblas_RowMajor,
-			     o2scl_cblas::o2cblas_NoTrans,
-			     size-1,size-1,1.0,KXX,
-			     y,0.0,this->Kinvf[iout]);
+    if (verbose>2) {
+      std::cout << "Creating covariance matrix with size "
+		<< size << std::endl;
+    }
 
+    // Construct the KXX matrix
+    ubmatrix KXX(size,size);
+    for(size_t irow=0;irow<size;irow++) {
+      mat_row_t xrow(this->x,irow);
+      for(size_t icol=0;icol<size;icol++) {
+	mat_row_t xcol(this->x,icol);
+	if (irow>icol) {
+	  KXX(irow,icol)=KXX(icol,irow);
 	} else {
-	  
-	  // Construct the inverse of KXX
-	  ubmatrix inv_KXX(size-1,size-1);
-	  o2scl::permutation p(size-1);
-	  int signum;
-	  if (verbose>2) {
-	    std::cout << "Performing LU decomposition with size "
-		      << size-1 << std::endl;
-	  }
-	  o2scl_linalg::LU_decomp(size-1,KXX,p,signum);
-	  if (o2scl_linalg::diagonal_has_zero(size-1,KXX)) {
-	    success=1;
-	    return 1.0e99;
-	  }
-	  if (verbose>2) {
-	    std::cout << "Performing matrix inversion with size "
-		      << size-1 << std::endl;
-	  }
-	  o2scl_linalg::LU_invert<ubmatrix,ubmatrix,ubmatrix_column>
-	    (size-1,KXX,p,inv_KXX);
-	  
-	  // Inverse covariance matrix times function vector
-	  this->Kinvf[iout].resize(size-1);
-	  o2scl_cblas::dgemv(o2scl_cblas::o2cblas_RowMajor,
-			     o2scl_cblas::o2cblas_NoTrans,
-			     size-1,size-1,1.0,inv_KXX,
-			     y,0.0,this->Kinvf[iout]);
-	  
+	  KXX(irow,icol)=covar<mat_row_t,mat_row_t>(xrow,xcol,
+						    this->nd_in,xlen);
+	  if (irow==icol) KXX(irow,icol)+=noise_var;
 	}
-
-	double ypred=0.0;
-        double yact=y[row];
-        for(size_t i=0;i<size-1;i++) {
-	  matrix_row_gen<matrix_view_omit_row<mat_t> > xrow(x_jk,i);
-	  mat_row_t xcol(this->x,row);
-          ypred+=covar<matrix_row_gen<matrix_view_omit_row<mat_t> >,
-	    mat_row_t>(xrow,xcol,this->nd_in,xlen)*
-	    this->Kinvf[iout][i];
-        }
-
-	std::cout << "act,pred: " << yact << " " << ypred << std::endl;
-        
-        // Measure the quality with a chi-squared like function
-        ret+=pow(yact-ypred,2.0);
-
-	
-	// Proceed to next point to omit
       }
-      std::cout << "ret: " << ret << std::endl;
+    }
       
-    } else if (mode==mode_max_lml || mode==mode_final) {
-
+    double lndet;
+    ubmatrix inv_KXX;
+    
+    if (this->matrix_mode==this->matrix_cholesky) {
+	
+      // Construct the inverse of KXX
       if (verbose>2) {
-	std::cout << "Creating covariance matrix with size "
+	std::cout << "Performing Cholesky decomposition with size "
 		  << size << std::endl;
       }
-
-      // Construct the KXX matrix
-      ubmatrix KXX(size,size);
-      for(size_t irow=0;irow<size;irow++) {
-	mat_row_t xrow(this->x,irow);
-	for(size_t icol=0;icol<size;icol++) {
-	  mat_row_t xcol(this->x,icol);
-	  if (irow>icol) {
-	    KXX(irow,icol)=KXX(icol,irow);
-	  } else {
-	    KXX(irow,icol)=covar<mat_row_t,mat_row_t>(xrow,xcol,
-						      this->nd_in,xlen);
-	    if (irow==icol) KXX(irow,icol)+=noise_var;
-	  }
-	}
+      int cret=o2scl_linalg::cholesky_decomp(size,KXX,false);
+      if (cret!=0) {
+	success=1;
+	return 1.0e99;
       }
-      
-      // Note: We have to use LU here because O2scl doesn't yet
-      // have a lndet() function for Cholesky decomp
 
-      double lndet;
-      if (this->matrix_mode==this->matrix_cholesky) {
-	
-	// Construct the inverse of KXX
-	if (verbose>2) {
-	  std::cout << "Performing Cholesky decomposition with size "
-		    << size << std::endl;
-	}
-	int cret=o2scl_linalg::cholesky_decomp(size,KXX,false);
-	if (cret!=0) {
-	  success=1;
-	  return 1.0e99;
-	}
-	if (verbose>2) {
-	  std::cout << "Performing matrix inversion with size "
-		    << size << std::endl;
-	}
-	o2scl_linalg::cholesky_invert<ubmatrix>(size,KXX);
+      // The log of the determinant is twice the sum of the logs
+      // of the diagonal elements of the Cholesky factor, and must
+      // be computed before the inversion
+      lndet=2.0*o2scl_linalg::cholesky_lndet<ubmatrix>(size,KXX);
 	
-	lndet=o2scl_linalg::cholesky_lndet<ubmatrix>(size,KXX);
+      if (verbose>2) {
+	std::cout << "Performing matrix inversion with size "
+		  << size << std::endl;
+      }
+      o2scl_linalg::cholesky_invert<ubmatrix>(size,KXX);
+      std::swap(inv_KXX,KXX);
 	
-	// Inverse covariance matrix times function vector
-	this->Kinvf[iout].resize(size);
-	o2scl_cblas::dgemv(o2scl_cblas::o2cblas_RowMajor,
-			   o2scl_cblas::o2cblas_NoTrans,
-			   size,size,1.0,KXX,
-			   y,0.0,this->Kinvf[iout]);
+    } else {
 	
-      } else {
+      // Construct the inverse of KXX
+      inv_KXX.resize(size,size);
+      o2scl::permutation p(size);
+      int signum;
+      if (verbose>2) {
+	std::cout << "Performing LU decomposition with size "
+		  << size << std::endl;
+      }
+      o2scl_linalg::LU_decomp(size,KXX,p,signum);
+      if (o2scl_linalg::diagonal_has_zero(size,KXX)) {
+	success=1;
+	return 1.0e99;
+      }
+      if (verbose>2) {
+	std::cout << "Performing matrix inversion with size "
+		  << size << std::endl;
+      }
+      o2scl_linalg::LU_invert<ubmatrix,ubmatrix,ubmatrix_column>
+	(size,KXX,p,inv_KXX);
+
+      lndet=o2scl_linalg::LU_lndet<ubmatrix>(size,KXX);
 	
-	// Construct the inverse of KXX
-	ubmatrix inv_KXX(size,size);
-	o2scl::permutation p(size);
-	int signum;
-	if (verbose>2) {
-	  std::cout << "Performing LU decomposition with size "
-		    << size << std::endl;
-	}
-	o2scl_linalg::LU_decomp(size,KXX,p,signum);
-	if (o2scl_linalg::diagonal_has_zero(size,KXX)) {
-	  success=1;
-	  return 1.0e99;
-	}
-	if (verbose>2) {
-	  std::cout << "Performing matrix inversion with size "
-		    << size << std::endl;
-	}
-	o2scl_linalg::LU_invert<ubmatrix,ubmatrix,ubmatrix_column>
-	  (size,KXX,p,inv_KXX);
+    }
+
+    // Inverse covariance matrix times function vector
+    kinvf.resize(size);
+    o2scl_cblas::dgemv(o2scl_cblas::o2cblas_RowMajor,
+		       o2scl_cblas::o2cblas_NoTrans,
+		       size,size,1.0,inv_KXX,y,0.0,kinvf);
+
+    if (mode==mode_loo_cv) {
 
-	lndet=o2scl_linalg::LU_lndet<ubmatrix>(size,KXX);
+      size_t n_loo=loo_npts;
+      if (n_loo>size) n_loo=size;
+      
+      for(size_t ell=0;ell<n_loo;ell++) {
 	
-	// Inverse covariance matrix times function vector
-	this->Kinvf[iout].resize(size);
-	o2scl_cblas::dgemv(o2scl_cblas::o2cblas_RowMajor,
-			   o2scl_cblas::o2cblas_NoTrans,
-			   size,size,1.0,inv_KXX,
-			   y,0.0,this->Kinvf[iout]);
+	size_t row=ell*size/n_loo;
 	
-      }
+	// The difference between the actual value and the
+	// prediction without the point at index 'row'
+	double resid=kinvf[row]/inv_KXX(row,row);
 
-      if (mode==mode_max_lml) {
-	// Compute the log of the marginal likelihood, without
-	// the constant term
-	for(size_t i=0;i<size;i++) {
-	  ret+=0.5*y[i]*this->Kinvf[iout][i];
+	if (verbose>2) {
+	  std::cout << "row,act,pred: " << row << " " << y[row] << " "
+		    << y[row]-resid << std::endl;
 	}
-	ret+=0.5*lndet;
+	
+	// Measure the quality with a chi-squared like function
+	ret+=resid*resid;
       }
-
+      
+    } else if (mode==mode_max_lml) {
+      
+      // Compute the log of the marginal likelihood, without
+      // the constant term
+      for(size_t i=0;i<size;i++) {
+	ret+=0.5*y[i]*kinvf[i];
+      }
+      ret+=0.5*lndet;
+      
     }
 
     return ret;
   }
-
+  
+  /** \brief Function to optimize the covariance parameters
+   */
+  template<class vec3_t> 
+  double qual_fun(double xlen, double noise_var, size_t iout,
+		  vec3_t &y, int &success) {
+    return qual_fun_kinvf(xlen,noise_var,y,success,this->Kinvf[iout]);
+  }
+  
   public:
 
   interpm_krige_optim() {
@@ -869,25 +800,37 @@ namespace o2scl {
 	  std::cout << "ilen len qual fail min_qual len_opt" << std::endl;
 	}
 	
+	// Compute the quality for each length scale. These are
+	// independent, so they are distributed among threads
+	std::vector<double> qual_j(nlen), len_j(nlen);
+	std::vector<int> success_j(nlen);
+	
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(size_t j=0;j<nlen;j++) {
+	  len_j[j]=len_min*pow(len_ratio,((double)j)/((double)nlen-1));
+	  ubvector kinvf_j;
+	  success_j[j]=0;
+	  qual_j[j]=qual_fun_kinvf(len_j[j],noise_var[iout],yiout,
+				   success_j[j],kinvf_j);
+	}
+	
 	// Loop over the full range, finding the optimum
 	bool min_set=false;
 	for(size_t j=0;j<nlen;j++) {
-	  double xlen=len_min*pow(len_ratio,((double)j)/((double)nlen-1));
 
-	  success=0;
-	  qual[iout]=qual_fun(xlen,noise_var[iout],iout,yiout,success);
-	
-	  if (success==0 && (min_set==false || qual[iout]<min_qual)) {
-	    len_opt=xlen;
-	    min_qual=qual[iout];
+	  if (success_j[j]==0 && (min_set==false || qual_j[j]<min_qual)) {
+	    len_opt=len_j[j];
+	    min_qual=qual_j[j];
 	    min_set=true;
 	  }
 	
 	  if (verbose>1) {
 	    std::cout << "interp_krige_optim: ";
 	    std::cout.width(2);
-	    std::cout << j << " " << xlen << " " << qual[iout] << " "
-		      << success << " " << min_qual << " "
+	    std::cout << j << " " << len_j[j] << " " << qual_j[j] << " "
+		      << success_j[j] << " " << min_qual << " "
 		      << len_opt << std::endl;
 	  }
 	  
@@ -54,6 +54,56 @@ double ft(double x, double y) {
   return 3.0-2.0*x*x+7.0*y;
 }
 
+/** \brief Expose the quality function for testing
+ */
+class interpm_krige_optim_qual :
+  public interpm_krige_optim<ubvector,mat_t,matrix_row_gen<mat_t> > {
+
+public:
+  
+  double qual(double xlen, double noise_var, ubvector &y,
+	      ubvector &kinvf) {
+    int success;
+    double ret=qual_fun_kinvf(xlen,noise_var,y,success,kinvf);
+    if (success!=0) return -1.0;
+    return ret;
+  }
+
+  /** \brief Compute the sum of the squared leave-one-out
+      residuals by refactoring the reduced covariance matrix for
+      each point
+  */
+  double qual_brute(double xlen, double noise_var, ubvector &y) {
+    size_t n=x.size1();
+    double ret=0.0;
+    for(size_t iout=0;iout<n;iout++) {
+      ubmatrix KXX(n-1,n-1);
+      ubvector y_jk(n-1), kstar(n-1), kinvf(n-1);
+      for(size_t i=0;i<n-1;i++) {
+	size_t ii=(i<iout ? i : i+1);
+	y_jk[i]=y[ii];
+	matrix_row_gen<mat_t> xi(x,ii), xo(x,iout);
+	kstar[i]=covar(xi,xo,nd_in,xlen);
+	for(size_t j=0;j<n-1;j++) {
+	  size_t jj=(j<iout ? j : j+1);
+	  matrix_row_gen<mat_t> xj(x,jj);
+	  KXX(i,j)=covar(xi,xj,nd_in,xlen);
+	  if (i==j) KXX(i,j)+=noise_var;
+	}
+      }
+      o2scl::permutation p(n-1);
+      int signum;
+      o2scl_linalg::LU_decomp(n-1,KXX,p,signum);
+      o2scl_linalg::LU_solve(n-1,KXX,p,y_jk,kinvf);
+      double ypred=0.0;
+      for(size_t i=0;i<n-1;i++) ypred+=kstar[i]*kinvf[i];
+      ret+=pow(y[iout]-ypred,2.0);
+    }
+    return ret;
+  }
+  
+};
+
 int main(void) {
   test_mgr t;
   t.set_output_level(1);
@@ -240,8 +290,8 @@ int main(void) {
 			matrix_row_gen<mat_t> > iko;
     iko.verbose=2;
 
-    /*
-    iko.set_data<matrix_row_gen<mat_t> >(2,1,8,x2,y2,true);
+    ubvector len_precompute;
+    iko.set_data<matrix_row_gen<mat_t> >(2,1,8,x2,y2,len_precompute);
     
     ubvector point(2);
     ubvector out(1);
@@ -254,7 +304,67 @@ int main(void) {
     iko.eval(point,out,iko.ff2);
     cout << out[0] << " " << ft(point[0],point[1]) << endl;
     cout << endl;
-    */
+
+    // Without noise, the interpolation should reproduce the data
+    point[0]=0.81;
+    point[1]=0.23;
+    iko.eval(point,out,iko.ff2);
+    t.test_rel(out[0],ft(point[0],point[1]),1.0e-4,"optim data point");
+  }
+
+  {
+    cout << "interpm_krige_optim, quality functions" << endl;
+    vector<ubvector> x;
+    ubvector tmp(2);
+    double xv[8][2]={{1.04,0.02},{0.03,1.01},{0.81,0.23},{0.03,0.83},
+		     {0.33,0.59},{0.82,0.84},{0.03,0.24},{0.55,1.02}};
+    for(size_t i=0;i<8;i++) {
+      tmp[0]=xv[i][0];
+      tmp[1]=xv[i][1];
+      x.push_back(tmp);
+    }
+    mat_t x2(x);
+
+    vector<ubvector> y;
+    ubvector yv(8);
+    for(size_t i=0;i<8;i++) {
+      yv[i]=ft(x[i][0],x[i][1]);
+    }
+    y.push_back(yv);
+    mat_t y2(y);
+
+    interpm_krige_optim_qual iko;
+    ubvector len_precompute;
+    iko.set_data<matrix_row_gen<mat_t> >(2,1,8,x2,y2,len_precompute);
+
+    // The leave-one-out residuals from the full inverse agree with
+    // those from refactoring the reduced matrix for each point
+    ubvector kinvf, kinvf2;
+    iko.mode=iko.mode_loo_cv;
+    iko.loo_npts=8;
+    for(size_t k=0;k<3;k++) {
+      double xlen=0.3+0.4*k;
+      double nv=(k==1 ? 1.0e-3 : 0.0);
+      iko.matrix_mode=iko.matrix_cholesky;
+      double q1=iko.qual(xlen,nv,yv,kinvf);
+      double q2=iko.qual_brute(xlen,nv,yv);
+      t.test_rel(q1,q2,1.0e-10,"LOO vs. brute force");
+      iko.matrix_mode=iko.matrix_LU;
+      q1=iko.qual(xlen,nv,yv,kinvf);
+      t.test_rel(q1,q2,1.0e-10,"LOO vs. brute force (LU)");
+    }
+
+    // The Cholesky and LU branches give the same marginal likelihood
+    iko.mode=iko.mode_max_lml;
+    for(size_t k=0;k<3;k++) {
+      double xlen=0.3+0.4*k;
+      iko.matrix_mode=iko.matrix_cholesky;
+      double q1=iko.qual(xlen,1.0e-4,yv,kinvf);
+      iko.matrix_mode=iko.matrix_LU;
+      double q2=iko.qual(xlen,1.0e-4,yv,kinvf2);
+      t.test_rel(q1,q2,1.0e-10,"LML Cholesky vs. LU");
+      t.test_rel_vec(8,kinvf,kinvf2,1.0e-10,"Kinvf Cholesky vs. LU");
+    }
   }
 
   {
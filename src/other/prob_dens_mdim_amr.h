@@ -26,6 +26,8 @@
 #ifndef O2SCL_PROB_DENS_MDIM_AMR_H
 #define O2SCL_PROB_DENS_MDIM_AMR_H
 
+#include <algorithm>
+
 #include <o2scl/table.h>
 #include <o2scl/err_hnd.h>
 #include <o2scl/prob_dens_func.h>
@@ -41,6 +43,17 @@ namespace o2scl {
 
       \note This class is experimental.
 
+      The hypercube containing a point is found using a binary tree
+      which records the sequence of splits performed by \ref
+      insert(), so that \ref pdf() and \ref insert() require a
+      number of comparisons proportional to the depth of the mesh
+      rather than the number of hypercubes. The weighted volumes are
+      stored in a Fenwick tree so that sampling a point with
+      <tt>operator()</tt> is also logarithmic in the number of
+      hypercubes. Both structures are updated incrementally by \ref
+      insert(). If \ref mesh is modified directly, then \ref
+      update_index() should be called afterwards.
+
       \future The storage required by the mesh is larger
       than necessary, and could be replaced by a tree-like
       structure which uses less storage, but that might 
@@ -56,6 +69,7 @@ namespace o2scl {
    */
   prob_dens_mdim_amr() {
     n_dim=0;
+    verbose=1;
     dim_choice=max_variance;
     allow_resampling=true;
   }
@@ -248,6 +262,7 @@ namespace o2scl {
    */
   void clear() {
     mesh.clear();
+    update_index();
     low.clear();
     high.clear();
     scale.clear();
@@ -260,6 +275,7 @@ namespace o2scl {
   */
   void clear_mesh() {
     mesh.clear();
+    update_index();
     return;
   }
 
@@ -357,6 +373,7 @@ namespace o2scl {
 	ix++;
       }
     }
+    update_index();
     return;
   }
   
@@ -421,6 +438,7 @@ namespace o2scl {
       } else {
 	mesh[0].set(low,high,ir,1.0,m(ir,n_dim));
       }
+      update_index();
       if (verbose>1) {
 	std::cout << "First hypercube from index "
 	<< ir << "." << std::endl;
@@ -462,15 +480,8 @@ namespace o2scl {
     }
    
     // Find the right hypercube
-    bool found=false;
-    size_t jm=0;
-    for(size_t j=0;j<mesh.size() && found==false;j++) {
-      if (mesh[j].is_inside(v)) {
-	found=true;
-	jm=j;
-      }
-    }
-    if (found==false) {
+    size_t jm=find_index(v);
+    if (jm==mesh.size()) {
       if (false) {
 	std::cout.setf(std::ios::showpos);
 	for(size_t k=0;k<n_dim;k++) {
@@ -632,7 +643,10 @@ namespace o2scl {
 		  << m(h.inside[0],max_ip) << " "
 		  << h.low[max_ip] << " " << h.high[max_ip] << std::endl;
       }
-      //exit(-1);
+      // Restore the original hypercube so that the mesh still
+      // covers the full region
+      h.low[max_ip]=old_low;
+      h.frac_vol=old_vol;
       return;
     }
     if (!std::isfinite(h.frac_vol)) {
@@ -663,7 +677,10 @@ namespace o2scl {
 		  << m(h.inside[0],max_ip) << " "
 		  << h.low[max_ip] << " " << h.high[max_ip] << std::endl;
       }
-      //exit(-1);
+      // Restore the original hypercube so that the mesh still
+      // covers the full region
+      h.low[max_ip]=old_low;
+      h.frac_vol=old_vol;
       return;
     }
     if (log_mode) {
@@ -758,8 +775,37 @@ namespace o2scl {
       }
     }
 
-    // Add new hypercube to mesh
+    // Add new hypercube to mesh, after which the reference 'h' is
+    // no longer valid
+    double dwgt=h.frac_vol*h.weight-old_vol*old_weight;
     mesh.push_back(h_new);
+
+    // Update the spatial index and the sampling weights
+    if (leaf.size()+1==mesh.size() && fenwick.size()==mesh.size()) {
+      
+      // The points below the split are in the new hypercube and
+      // the points above are in the modified one
+      size_t node=leaf[jm];
+      size_t n_nodes=tree.size();
+      tree.resize(n_nodes+2);
+      tree[node].is_leaf=false;
+      tree[node].dim=max_ip;
+      tree[node].loc=loc;
+      tree[node].left=n_nodes;
+      tree[node].right=n_nodes+1;
+      tree[n_nodes].is_leaf=true;
+      tree[n_nodes].cell=mesh.size()-1;
+      tree[n_nodes+1].is_leaf=true;
+      tree[n_nodes+1].cell=jm;
+      leaf[jm]=n_nodes+1;
+      leaf.push_back(n_nodes);
+
+      fenwick_add(jm,dwgt);
+      fenwick_push(h_new.frac_vol*h_new.weight);
+      
+    } else {
+      update_index();
+    }
    
     return;
   }
@@ -881,6 +927,7 @@ namespace o2scl {
     for(size_t i=0;i<mesh.size();i++) {
       mesh[i].weight=1.0/mesh[i].frac_vol;
     }
+    update_index();
     return;
   }
   
@@ -933,15 +980,82 @@ namespace o2scl {
 		   "prob_dens_mdim_amr::find_hc().",o2scl::exc_einval);
       }
     }
-    for(size_t j=0;j<mesh.size();j++) {
-      if (mesh[j].is_inside(x)) {
-	return mesh[j];
-      }
-    }
+    size_t j=find_index(x);
+    if (j<mesh.size()) return mesh[j];
     O2SCL_ERR2("Could not find hypercube in ",
 	       "prob_dens_mdim_amr::find_hc().",o2scl::exc_efailed);
     return mesh[0];
   }
+
+  /** \brief Return the index of the hypercube containing the
+      point \c x, or the size of the mesh if no hypercube
+      contains it
+  */
+  template<class vec2_t> size_t find_index(const vec2_t &x) const {
+
+    // Descend the tree, and then check the result, since the tree
+    // is out of date if the mesh was modified directly
+    if (tree.size()>0 && leaf.size()==mesh.size()) {
+      size_t node=0;
+      while (tree[node].is_leaf==false) {
+	if (x[tree[node].dim]<tree[node].loc) {
+	  node=tree[node].left;
+	} else {
+	  node=tree[node].right;
+	}
+      }
+      size_t j=tree[node].cell;
+      if (j<mesh.size() && mesh[j].is_inside(x)) return j;
+    }
+
+    // Otherwise, fall back to a linear search
+    for(size_t j=0;j<mesh.size();j++) {
+      if (mesh[j].is_inside(x)) return j;
+    }
+    return mesh.size();
+  }
+
+  /** \brief Rebuild the spatial index and the sampling weights
+      from \ref mesh
+
+      This function is called automatically by the member functions
+      which modify the mesh, but must be called by the user after
+      the hypercubes in \ref mesh are modified directly.
+  */
+  void update_index() {
+
+    size_t n=mesh.size();
+    
+    // Create the Fenwick tree of weighted volumes in O(n) time
+    fenwick.resize(n+1);
+    fenwick[0]=0.0;
+    for(size_t i=0;i<n;i++) {
+      fenwick[i+1]=mesh[i].frac_vol*mesh[i].weight;
+    }
+    for(size_t i=1;i<=n;i++) {
+      size_t par=i+(i & (~i+1));
+      if (par<=n) fenwick[par]+=fenwick[i];
+    }
+
+    // Rebuild the tree by recursively finding a coordinate
+    // value which separates the hypercubes into two groups
+    tree.clear();
+    leaf.clear();
+    if (n==0) return;
+    
+    std::vector<size_t> cells(n);
+    for(size_t i=0;i<n;i++) cells[i]=i;
+    leaf.resize(n);
+    tree.resize(1);
+    if (build_tree(cells,0)==false) {
+      // If the mesh cannot be split, then the mesh was not created
+      // by insert() and find_index() will use a linear search
+      tree.clear();
+      leaf.clear();
+    }
+    
+    return;
+  }
   
   /// The normalized density 
   virtual double pdf(const vec_t &x) const {
@@ -952,15 +1066,8 @@ namespace o2scl {
     }
 
     // Find the right hypercube
-    bool found=false;
-    size_t jm=0;
-    for(size_t j=0;j<mesh.size() && found==false;j++) {
-      if (mesh[j].is_inside(x)) {
-	found=true;
-	jm=j;
-      }
-    }
-    if (found==false) {
+    size_t jm=find_index(x);
+    if (jm==mesh.size()) {
       std::cout.setf(std::ios::showpos);
       for(size_t k=0;k<n_dim;k++) {
 	std::cout << low[k] << " " << x[k] << " " << high[k] << " ";
@@ -1090,64 +1197,219 @@ namespace o2scl {
       return;
     }
 
+    // Use the Fenwick tree if it is up to date, otherwise use a
+    // linear search over the cumulative weights
+    bool use_fenwick=(fenwick.size()==mesh.size()+1);
+    
     double total_weight=0.0;
-    for(size_t i=0;i<mesh.size();i++) {
-      total_weight+=mesh[i].weight*mesh[i].frac_vol;
+    if (use_fenwick) {
+      total_weight=fenwick_sum(mesh.size());
+    } else {
+      for(size_t i=0;i<mesh.size();i++) {
+	total_weight+=mesh[i].weight*mesh[i].frac_vol;
+      }
     }
 
-    bool failed=false;
-    int cnt=0;
-
-    do {
+    for(int cnt=0;cnt<100;cnt++) {
 
       double r=rg.random();
       double this_weight=r*total_weight;
-      double cml_wgt=0.0;
-      for(size_t j=0;j<mesh.size();j++) {
-	cml_wgt+=mesh[j].frac_vol*mesh[j].weight;
-	if (this_weight<cml_wgt || j==mesh.size()-1) {
-	  for(size_t i=0;i<n_dim;i++) {
-	    x[i]=mesh[j].low[i]+rg.random()*
-	      (mesh[j].high[i]-mesh[j].low[i]);
-	  }
-	  std::cout << "op: " << " " << j << " "
-		    << log(mesh[j].weight) << " " << mesh[j].weight << " "
-		    << mesh[j].frac_vol << " "
-		    << mesh[j].weight*mesh[j].frac_vol << std::endl;
-	  //o2scl::vector_out(std::cout,x,true);
-	  if (mesh[j].is_inside(x)==false) {
-	    if (allow_resampling) {
-	      failed=true;
-	      cnt++;
-	      if (cnt==100) {
-		O2SCL_ERR2("One hundred resamples failed in ",
-			   "prob_dens_mdim_amr::operator().",
-			   o2scl::exc_efailed);
-	      }
-	    } else {
-	      std::cout << "Not inside in operator()." << std::endl;
-	      for(size_t i=0;i<n_dim;i++) {
-		std::cout << low[i] << " " << mesh[j].low[i] << " "
-			  << x[i] << " " << mesh[j].high[i] << " "
-			  << high[i] << std::endl;
-	      }
-	      O2SCL_ERR2("Not inside in operator() in ",
-			 "prob_dens_mdim_amr::operator().",
-			 o2scl::exc_efailed);
-	      exit(-1);
-	    }
-	  }
-	  return;
+
+      size_t j;
+      if (use_fenwick) {
+	j=fenwick_find(this_weight);
+      } else {
+	double cml_wgt=0.0;
+	for(j=0;j<mesh.size()-1;j++) {
+	  cml_wgt+=mesh[j].frac_vol*mesh[j].weight;
+	  if (this_weight<cml_wgt) break;
+	}
+      }
+      
+      for(size_t i=0;i<n_dim;i++) {
+	x[i]=mesh[j].low[i]+rg.random()*
+	  (mesh[j].high[i]-mesh[j].low[i]);
+      }
+      if (verbose>1) {
+	std::cout << "op: " << " " << j << " "
+		  << log(mesh[j].weight) << " " << mesh[j].weight << " "
+		  << mesh[j].frac_vol << " "
+		  << mesh[j].weight*mesh[j].frac_vol << std::endl;
+      }
+      
+      if (mesh[j].is_inside(x)) return;
+      
+      if (allow_resampling==false) {
+	std::cout << "Not inside in operator()." << std::endl;
+	for(size_t i=0;i<n_dim;i++) {
+	  std::cout << low[i] << " " << mesh[j].low[i] << " "
+		    << x[i] << " " << mesh[j].high[i] << " "
+		    << high[i] << std::endl;
 	}
+	O2SCL_ERR2("Not inside in operator() in ",
+		   "prob_dens_mdim_amr::operator().",
+		   o2scl::exc_efailed);
+	return;
       }
+      
+    }
+
+    O2SCL_ERR2("One hundred resamples failed in ",
+	       "prob_dens_mdim_amr::operator().",o2scl::exc_efailed);
+    
+    return;
+  }
+
+#ifndef DOXYGEN_INTERNAL
 
-    } while (failed==true);
+  protected:
 
-    O2SCL_ERR2("Sampling distribution failed in ",
-	       "prob_dens_mdim_amr::operator()().",o2scl::exc_einval);
+  /** \brief A node in the tree of hypercube splits
+   */
+  class split_node {
     
+  public:
+    
+    /// If true, this node is a hypercube
+    bool is_leaf;
+    /// The split coordinate
+    size_t dim;
+    /// The split location
+    double loc;
+    /// The node with coordinate values less than \c loc
+    size_t left;
+    /// The node with coordinate values greater than \c loc
+    size_t right;
+    /// The index of the hypercube in \ref mesh for a leaf
+    size_t cell;
+    
+  };
+
+  /// \name Spatial index and sampling weights
+  //@{
+  /// The tree of splits, with the root at index 0
+  std::vector<split_node> tree;
+  /// The tree node for each hypercube in \ref mesh
+  std::vector<size_t> leaf;
+  /** \brief Fenwick tree of the weighted volumes, with one more
+      element than \ref mesh
+  */
+  std::vector<double> fenwick;
+  //@}
+
+  /** \brief Add \c dw to the weighted volume of hypercube \c i
+   */
+  void fenwick_add(size_t i, double dw) {
+    for(size_t k=i+1;k<fenwick.size();k+=(k & (~k+1))) {
+      fenwick[k]+=dw;
+    }
+    return;
+  }
+
+  /** \brief Return the sum of the weighted volumes of the first 
+      \c n hypercubes
+  */
+  double fenwick_sum(size_t n) const {
+    double ret=0.0;
+    for(size_t k=n;k>0;k-=(k & (~k+1))) {
+      ret+=fenwick[k];
+    }
+    return ret;
+  }
+
+  /** \brief Append the weighted volume \c w of a new hypercube
+   */
+  void fenwick_push(double w) {
+    size_t k=fenwick.size();
+    size_t lsb=(k & (~k+1));
+    fenwick.push_back(w+fenwick_sum(k-1)-fenwick_sum(k-lsb));
     return;
   }
+
+  /** \brief Return the index of the first hypercube for which the
+      cumulative weighted volume is larger than \c w
+  */
+  size_t fenwick_find(double w) const {
+    size_t n=fenwick.size()-1;
+    size_t step=1;
+    while (step*2<=n) step*=2;
+    size_t pos=0;
+    for(;step>0;step/=2) {
+      if (pos+step<=n && fenwick[pos+step]<=w) {
+	pos+=step;
+	w-=fenwick[pos];
+      }
+    }
+    if (pos>=n) pos=n-1;
+    return pos;
+  }
+
+  /** \brief Construct the subtree at index \c node for the
+      hypercubes in \c cells, returning false if they cannot
+      be separated
+  */
+  bool build_tree(std::vector<size_t> &cells, size_t node) {
+
+    size_t n=cells.size();
+    
+    if (n==1) {
+      tree[node].is_leaf=true;
+      tree[node].cell=cells[0];
+      leaf[cells[0]]=node;
+      return true;
+    }
+
+    // For each coordinate, sort the hypercubes by their lower
+    // limit and find the most balanced location which separates
+    // them
+    bool found=false;
+    size_t best_dim=0, best_ix=0;
+    std::vector<size_t> sorted(n);
+    for(size_t k=0;k<n_dim;k++) {
+      sorted=cells;
+      std::sort(sorted.begin(),sorted.end(),
+		[this,k](size_t i1, size_t i2) {
+		  return mesh[i1].low[k]<mesh[i2].low[k];
+		});
+      double max_high=mesh[sorted[0]].high[k];
+      for(size_t i=1;i<n;i++) {
+	if (mesh[sorted[i]].low[k]>=max_high) {
+	  size_t dist=(2*i>n) ? 2*i-n : n-2*i;
+	  size_t best_dist=(2*best_ix>n) ? 2*best_ix-n : n-2*best_ix;
+	  if (found==false || dist<best_dist) {
+	    found=true;
+	    best_dim=k;
+	    best_ix=i;
+	  }
+	}
+	if (mesh[sorted[i]].high[k]>max_high) {
+	  max_high=mesh[sorted[i]].high[k];
+	}
+      }
+    }
+    if (found==false) return false;
+    
+    std::sort(cells.begin(),cells.end(),
+	      [this,best_dim](size_t i1, size_t i2) {
+		return mesh[i1].low[best_dim]<mesh[i2].low[best_dim];
+	      });
+    std::vector<size_t> cells_left(cells.begin(),cells.begin()+best_ix);
+    std::vector<size_t> cells_right(cells.begin()+best_ix,cells.end());
+    
+    size_t n_nodes=tree.size();
+    tree.resize(n_nodes+2);
+    tree[node].is_leaf=false;
+    tree[node].dim=best_dim;
+    tree[node].loc=mesh[cells[best_ix]].low[best_dim];
+    tree[node].left=n_nodes;
+    tree[node].right=n_nodes+1;
+    
+    cells.clear();
+    if (build_tree(cells_left,n_nodes)==false) return false;
+    return build_tree(cells_right,n_nodes+1);
+  }
+
+#endif
  
   };
  
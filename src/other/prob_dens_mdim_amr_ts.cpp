@@ -106,6 +106,68 @@ int main(void) {
   tm.test_rel(amr2.total_volume(),1.0,1.0e-8,"total volume 2");
   cout << amr2.total_volume() << endl;
 
+  // Compare the tree-based lookup and sampling with a linear
+  // search over a larger mesh
+  {
+    static const size_t N3=2000;
+    table<> t4;
+    t4.line_of_names("x y z");
+    for(size_t i=0;i<N3;i++) {
+      double line[3]={r.random(),r.random(),r.random()+0.1};
+      t4.line_of_data(3,line);
+    }
+    matrix_view_table<std::vector<double> > mvt4(t4,{"x","y","z"});
+    
+    prob_dens_mdim_amr<std::vector<double>,
+		       matrix_view_table<std::vector<double> > >
+      amr3(low2,high2), amr4;
+    amr3.verbose=0;
+    amr3.initial_parse(mvt4);
+    tm.test_rel(amr3.total_volume(),1.0,1.0e-8,"total volume 3");
+
+    size_t nd, dc, ms;
+    std::vector<double> data;
+    std::vector<size_t> insides;
+    amr3.copy_to_vectors(nd,dc,ms,data,insides);
+    amr4.set_from_vectors(nd,dc,ms,data,insides);
+    
+    bool match=true;
+    vector<double> v3(2);
+    for(size_t i=0;i<1000;i++) {
+      v3[0]=r.random();
+      v3[1]=r.random();
+      size_t jm=amr3.mesh.size();
+      for(size_t j=0;j<amr3.mesh.size() && jm==amr3.mesh.size();j++) {
+	if (amr3.mesh[j].is_inside(v3)) jm=j;
+      }
+      if (amr3.pdf(v3)!=amr3.mesh[jm].weight) match=false;
+      if (amr4.pdf(v3)!=amr3.mesh[jm].weight) match=false;
+    }
+    tm.test_gen(match,"tree lookup");
+
+    // Compare the fraction of samples with x<1/2 to the
+    // probability computed from the mesh
+    double prob=0.0, total=0.0;
+    for(size_t j=0;j<amr3.mesh.size();j++) {
+      const prob_dens_mdim_amr<std::vector<double>,
+	matrix_view_table<std::vector<double> > >::hypercube &h=
+	amr3.mesh[j];
+      double wv=h.weight*h.frac_vol;
+      total+=wv;
+      if (h.high[0]<=0.5) {
+	prob+=wv;
+      } else if (h.low[0]<0.5) {
+	prob+=wv*(0.5-h.low[0])/(h.high[0]-h.low[0]);
+      }
+    }
+    size_t count=0;
+    for(size_t i=0;i<10000;i++) {
+      amr3(v3);
+      if (v3[0]<0.5) count++;
+    }
+    tm.test_abs(((double)count)/1.0e4,prob/total,0.02,"sampling");
+  }
+
   if (false) {
     ofstream fout;
     fout.open("temp.scr");
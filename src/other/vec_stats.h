@@ -36,8 +36,12 @@
     \future Consider generalizing to other data types.
 */
 
+#include <cmath>
+#include <vector>
+
 #include <o2scl/err_hnd.h>
 #include <o2scl/vector.h>
+#include <o2scl/constants.h>
 
 #ifndef DOXYGEN_NO_O2NS
 namespace o2scl {
@@ -1786,7 +1790,8 @@ namespace o2scl {
 
     long double q=0.0, v=0.0;
     for(size_t i=0;i<k;i++) {
-      v+=(data[i]-mean)*(data[i]-mean)/(i+1);
+      long double delta=data[i]-mean;
+      v+=(delta*delta-v)/(i+1);
     }
     for(size_t i=k;i<n;i++) {
       long double delta0=data[i-k]-mean;
@@ -1853,6 +1858,121 @@ namespace o2scl {
     return vector_lagk_autocorr(data.size(),data,k);
   }
 
+  /** \brief In-place radix-2 fast Fourier transform of the complex
+      vector with real part \c re and imaginary part \c im
+
+      The vectors \c re and \c im must have the same size, and it
+      must be a power of two, otherwise the error handler is called.
+      If \c inverse is true, then the inverse transform is computed
+      without the normalization factor of \f$ 1/n \f$.
+  */
+  inline void vector_fft_radix2(std::vector<double> &re,
+				std::vector<double> &im,
+				bool inverse=false) {
+    
+    size_t n=re.size();
+    if (im.size()!=n || n==0 || (n & (n-1))!=0) {
+      O2SCL_ERR2("Vector size not a power of two ",
+		 "in vector_fft_radix2().",exc_einval);
+    }
+    if (n==1) return;
+    
+    // Bit-reversal permutation
+    for(size_t i=1,j=0;i<n;i++) {
+      size_t bit=n>>1;
+      for(;j&bit;bit>>=1) j^=bit;
+      j^=bit;
+      if (i<j) {
+	std::swap(re[i],re[j]);
+	std::swap(im[i],im[j]);
+      }
+    }
+
+    // Twiddle factors for the full transform, computed directly
+    // rather than by recurrence to avoid the accumulation of
+    // roundoff error
+    double sign=inverse ? 1.0 : -1.0;
+    std::vector<double> wr(n/2), wi(n/2);
+    for(size_t k=0;k<n/2;k++) {
+      double arg=2.0*o2scl_const::pi*((double)k)/((double)n);
+      wr[k]=cos(arg);
+      wi[k]=sign*sin(arg);
+    }
+
+    // Butterflies
+    for(size_t len=2;len<=n;len<<=1) {
+      size_t half=len/2, stride=n/len;
+      for(size_t i=0;i<n;i+=len) {
+	for(size_t j=0;j<half;j++) {
+	  double tr=wr[j*stride], ti=wi[j*stride];
+	  size_t a=i+j, b=i+j+half;
+	  double xr=re[b]*tr-im[b]*ti;
+	  double xi=re[b]*ti+im[b]*tr;
+	  re[b]=re[a]-xr;
+	  im[b]=im[a]-xi;
+	  re[a]+=xr;
+	  im[a]+=xi;
+	}
+      }
+    }
+    
+    return;
+  }
+
+  /** \brief Construct an autocorrelation vector from the first
+      \c n elements of \c data using a fast Fourier transform
+
+      This computes the same quantity as \ref vector_lagk_autocorr()
+      for all \f$ k<n/2 \f$ in \f$ {\cal O}(n \log n) \f$ time
+      instead of \f$ {\cal O}(n^2) \f$. The data is padded with zeros
+      to a power of two which is at least \f$ 2n \f$ to avoid
+      circular correlations. The vector \c ac_vec is resized to
+      \f$ k_{\mathrm{max}}=n/2 \f$.
+  */
+  template<class vec_t, class resize_vec_t>
+    void vector_autocorr_vector_fft(size_t n, const vec_t &data,
+				    resize_vec_t &ac_vec) {
+    
+    size_t kmax=n/2;
+    ac_vec.resize(kmax);
+    if (kmax==0) return;
+
+    double mean=vector_mean(n,data);
+    
+    size_t nfft=1;
+    while (nfft<2*n) nfft<<=1;
+    std::vector<double> re(nfft,0.0), im(nfft,0.0);
+    for(size_t i=0;i<n;i++) re[i]=data[i]-mean;
+
+    // The autocorrelation is the inverse transform of
+    // the power spectrum
+    vector_fft_radix2(re,im);
+    for(size_t i=0;i<nfft;i++) {
+      re[i]=re[i]*re[i]+im[i]*im[i];
+      im[i]=0.0;
+    }
+    vector_fft_radix2(re,im,true);
+
+    ac_vec[0]=1.0;
+    for(size_t k=1;k<kmax;k++) {
+      ac_vec[k]=re[k]/re[0];
+    }
+    return;
+  }
+
+  /** \brief Construct an autocorrelation vector using a fast 
+      Fourier transform
+      
+      See \ref vector_autocorr_vector_fft(size_t,const vec_t &,
+      resize_vec_t &) .
+  */
+  template<class vec_t, class resize_vec_t>
+    void vector_autocorr_vector_fft(const vec_t &data,
+				    resize_vec_t &ac_vec) {
+    vector_autocorr_vector_fft(data.size(),data,ac_vec);
+    return;
+  }
+
   /** \brief Construct an autocorrelation vector
 
       This constructs a vector \c ac_vec for which the kth entry
@@ -1861,15 +1981,34 @@ namespace o2scl {
       \c data vector. The vector \c ac_vec is resized to accomodate
       exactly \f$ k_{\mathrm{max}} \f$ values, from 0 to 
       \f$ k_{\mathrm{max}}-1 \f$.
+
+      This function uses \ref vector_autocorr_vector_fft() .
   */
   template<class vec_t, class resize_vec_t> void vector_autocorr_vector
     (const vec_t &data, resize_vec_t &ac_vec) {
-    size_t kmax=data.size()/2;
-    double mean=vector_mean(data);
-    ac_vec.resize(kmax);
-    ac_vec[0]=1.0;
-    for(size_t k=1;k<kmax;k++) {
-      ac_vec[k]=vector_lagk_autocorr(data.size(),data,k,mean);
+    vector_autocorr_vector_fft(data.size(),data,ac_vec);
+    return;
+  }
+
+  /** \brief Construct autocorrelation vectors for several
+      data sets
+      
+      This computes \c ac[i] from \c data[i] using \ref
+      vector_autocorr_vector() for each data set, for example all of
+      the columns of a table. If OpenMP is enabled, the data sets are
+      processed in parallel using \c n_threads threads.
+  */
+  template<class vec_vec_t, class resize_vec_vec_t>
+    void vector_autocorr_vectors(const vec_vec_t &data,
+				 resize_vec_vec_t &ac,
+				 size_t n_threads=1) {
+    size_t nv=data.size();
+    ac.resize(nv);
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(n_threads) schedule(dynamic)
+#endif
+    for(size_t i=0;i<nv;i++) {
+      vector_autocorr_vector(data[i],ac[i]);
     }
     return;
   }
@@ -1904,11 +2043,9 @@ namespace o2scl {
     five_tau_over_M.resize(0);
     size_t len=0;
     bool len_set=false;
+    double sum=0.0;
     for (size_t M=1;M<ac_vec.size();M++) {
-      double sum=0.0;
-      for(size_t s=1;s<=M;s++) {
-	sum+=ac_vec[s];
-      }
+      sum+=ac_vec[M];
       double val=(1.0+2.0*sum)/((double)M)*5.0;
       if (len_set==false && val<=1.0) {
 	len=M;
@@ -1946,7 +2083,8 @@ namespace o2scl {
     long double q=0.0, v=0.0;
     size_t im=0, ix=0, im2=0, ix2=0;
     for(size_t i=0;i<k;i++) {
-      v+=(data[ix]-mean)*(data[ix]-mean)/(i+1);
+      long double delta=data[ix]-mean;
+      v+=(delta*delta-v)/(i+1);
       im++;
       if (im>=((size_t)(mult[ix]*(1.0+1.0e-10)))) {
 	im=0;
@@ -2007,18 +2145,19 @@ namespace o2scl {
     void vector_autocorr_vector_mult
     (size_t n2, const vec_t &data, const vec2_t &mult, resize_vec_t &ac_vec) {
 
-    size_t n=0;
+    // Expand the data using the multiplier and then use the fast
+    // Fourier transform
+    std::vector<double> expanded;
     for(size_t i=0;i<n2;i++) {
-      n+=((size_t)(mult[i]*(1.0+1.0e-10)));
+      size_t m=((size_t)(mult[i]*(1.0+1.0e-10)));
+      if (m==0) {
+	O2SCL_ERR2("Mult vector is zero ",
+		   "in vector_autocorr_vector_mult().",exc_einval);
+      }
+      expanded.insert(expanded.end(),m,data[i]);
     }
+    vector_autocorr_vector_fft(expanded.size(),expanded,ac_vec);
     
-    size_t kmax=n/2;
-    double mean=wvector_mean(data,mult);
-    ac_vec.resize(kmax);
-    ac_vec[0]=1.0;
-    for(size_t k=1;k<kmax;k++) {
-      ac_vec[k]=vector_lagk_autocorr_mult(n2,data,mult,k,mean);
-    }
     return;
   }
 
@@ -190,7 +190,59 @@ int main(void) {
     t.test_gen(ac_len==ac_len2,"vector_autocorr_vector.");
     cout << ac_len << " " << ac_len2 << endl;
   }
-  
+
+  if (true) {
+    cout << "------------------------------------------------------------"
+	 << endl;
+    cout << "Testing vector_autocorr_vector_fft(): " << endl;
+
+    // An autocorrelated series of odd length
+    std::vector<double> x0(999);
+    rng_gsl r;
+    x0[0]=r.random();
+    for(size_t i=1;i<x0.size();i++) {
+      x0[i]=0.9*x0[i-1]+r.random();
+    }
+    double mean=vector_mean(x0);
+
+    std::vector<double> ac;
+    vector_autocorr_vector_fft(x0,ac);
+    t.test_gen(ac.size()==x0.size()/2,"fft size");
+    double max_diff=0.0;
+    for(size_t k=1;k<ac.size();k++) {
+      double diff=fabs(ac[k]-vector_lagk_autocorr(x0.size(),x0,k,mean));
+      if (diff>max_diff) max_diff=diff;
+    }
+    t.test_abs(max_diff,0.0,1.0e-12,"fft vs. lagk");
+    t.test_rel(ac[1],vector_lag1_autocorr(x0),1.0e-12,"fft vs. lag1");
+
+    // Compare with the multiplier version
+    std::vector<double> x1, mult, ac1;
+    for(size_t i=0;i<x0.size();i+=3) {
+      x1.push_back(x0[i]);
+      mult.push_back(3.0);
+    }
+    vector_autocorr_vector_mult(x1,mult,ac1);
+    double wmean=wvector_mean(x1,mult);
+    max_diff=0.0;
+    for(size_t k=1;k<ac1.size();k++) {
+      double diff=fabs(ac1[k]-vector_lagk_autocorr_mult(x1,mult,k,wmean));
+      if (diff>max_diff) max_diff=diff;
+    }
+    t.test_abs(max_diff,0.0,1.0e-12,"fft vs. lagk_mult");
+
+    // Multiple data sets
+    std::vector<std::vector<double> > xv(3), acv;
+    xv[0]=x0;
+    xv[1]=x1;
+    xv[2].resize(1);
+    vector_autocorr_vectors(xv,acv,2);
+    t.test_gen(acv.size()==3,"vectors size");
+    t.test_gen(acv[0]==ac,"vectors 0");
+    t.test_gen(acv[1].size()==x1.size()/2,"vectors 1");
+    t.test_gen(acv[2].size()==0,"vectors 2");
+  }
+
   t.report();
   
   return 0;
@@ -30,6 +30,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <vector>
 
 #ifdef O2SCL_LD_TYPES
 #include <boost/multiprecision/cpp_dec_float.hpp>
@@ -204,6 +205,29 @@ namespace o2scl {
       chemical potential from the density. Of course if these
       tolerances are too small, the calculation may fail. 
 
+      \hline 
+      <b>Tabulated integrals:</b>
+
+      When the same particle is evaluated many times (e.g. in the
+      construction of a finite-temperature EOS table), the integrals
+      can be precomputed with \ref build_table(). The table stores
+      the logarithms of the dimensionless density, energy density,
+      and entropy (at \f$ T=1 \f$ and \f$ g=1 \f$) on a uniform grid
+      in \f$ \psi \f$ and \f$ \log \eta \f$, where \f$ \eta \equiv
+      m^{*}/T \f$, and uses bicubic Lagrange interpolation. The
+      interpolation error is estimated by comparing with direct
+      integration at the center of every grid cell, and the grid is
+      refined until the largest relative error is below \ref
+      table_tol or the grid reaches \ref table_max_points in either
+      direction. If \ref use_table is true, then calc_mu(),
+      calc_density() and the density solver use the table whenever
+      \f$ (\psi,\eta) \f$ lies within its range. If \ref
+      table_strict is also true, then cells whose error estimate
+      exceeds \ref table_tol are not used. Outside the table, the
+      integrals are computed directly as usual. The functions
+      pair_mu() and pair_density() always compute the integrals
+      directly, temporarily setting \ref use_table to false.
+
       \hline 
       <b>Todos:</b>
 
@@ -287,6 +311,29 @@ namespace o2scl {
     fp_t therm_ident;
     //@}
 
+    /// \name Tabulated integrals
+    //@{
+    /** \brief If true, use the table from \ref build_table() 
+	when possible (default false)
+    */
+    bool use_table;
+
+    /** \brief If true, do not use table cells with an error 
+	estimate larger than \ref table_tol (default false)
+    */
+    bool table_strict;
+
+    /** \brief The relative tolerance for the table (default 
+	\f$ 10^{-6} \f$)
+    */
+    fp_t table_tol;
+
+    /** \brief The maximum number of grid points in either 
+	direction (default 513)
+    */
+    size_t table_max_points;
+    //@}
+
     /// Storage for the uncertainty
     fermion_t unc;
 
@@ -313,6 +360,14 @@ namespace o2scl {
       tol_expan=1.0e-14;
       verify_ti=false;
       therm_ident=0.0;
+
+      use_table=false;
+      table_strict=false;
+      table_tol=1.0e-6;
+      table_max_points=513;
+      tab_n_psi=0;
+      tab_n_eta=0;
+      tab_max_err=0.0;
     }
 
     virtual ~fermion_rel_tl() {
@@ -358,6 +413,7 @@ namespace o2scl {
 	- 8: exact integration, degenerate integrands, full
 	entropy integration
 	- 9: T=0 result
+	- 10: tabulated integrals (see \ref build_table())
 
 	In \ref calc_density(), the integer is a two-digit
 	number. The first digit (1 to 3) is the method used by \ref
@@ -369,6 +425,7 @@ namespace o2scl {
 	on entropy integration
 	- 5: exact integration, degenerate integrands, full
 	entropy integration
+	- 6: tabulated integrals
 	If \ref calc_density() uses the T=0 code, then
 	last_method is 40. 
 
@@ -392,6 +449,163 @@ namespace o2scl {
     */
     int last_method;
 
+    /// \name Tabulated integrals
+    //@{
+    /** \brief Tabulate the integrals for \f$ \psi \f$ in 
+	<tt>[psi_lo,psi_hi]</tt> and \f$ \eta=m^{*}/T \f$ in 
+	<tt>[eta_lo,eta_hi]</tt>
+
+	The initial grid has \c n_psi points in \f$ \psi \f$ and \c
+	n_eta points in \f$ \log \eta \f$. The number of intervals
+	in both directions is doubled until the error estimate is
+	smaller than \ref table_tol, until the number of points
+	would exceed \ref table_max_points, or until refinement no
+	longer reduces the error (which happens when \ref table_tol
+	is smaller than the accuracy of the integrators). If the
+	tolerance cannot be achieved, the table is kept and the error
+	handler is called if \ref err_nonconv is true.
+
+	This function does not modify \ref use_table.
+    */
+    int build_table(fp_t psi_lo, fp_t psi_hi, fp_t eta_lo,
+		    fp_t eta_hi, size_t n_psi=33, size_t n_eta=17) {
+
+      if (psi_hi<=psi_lo || eta_lo<=0.0 || eta_hi<=eta_lo) {
+	O2SCL_ERR2("Invalid table limits in ",
+		   "fermion_rel::build_table().",exc_einval);
+      }
+      if (n_psi<4 || n_eta<4) {
+	O2SCL_ERR2("Need at least four grid points in each direction in ",
+		   "fermion_rel::build_table().",exc_einval);
+      }
+      
+      clear_table();
+      
+      // Direct integration is used to construct the table, so
+      // we turn off the table temporarily and store the values
+      // of unc and last_method
+      bool use_table_temp=use_table;
+      use_table=false;
+      fermion_t unc_temp=unc;
+      int lm_temp=last_method;
+
+      tab_psi_lo=psi_lo;
+      tab_psi_hi=psi_hi;
+      tab_leta_lo=o2log(eta_lo);
+      tab_leta_hi=o2log(eta_hi);
+
+      fp_t last_err=0.0;
+      bool first=true;
+      
+      while (true) {
+
+	tab_n_psi=n_psi;
+	tab_n_eta=n_eta;
+	tab_h_psi=(tab_psi_hi-tab_psi_lo)/((fp_t)(n_psi-1));
+	tab_h_leta=(tab_leta_hi-tab_leta_lo)/((fp_t)(n_eta-1));
+	tab_ln.resize(n_psi*n_eta);
+	tab_led.resize(n_psi*n_eta);
+	tab_len.resize(n_psi*n_eta);
+	tab_cell_err.resize((n_psi-1)*(n_eta-1));
+
+	for(size_t i=0;i<n_psi;i++) {
+	  fp_t psi=tab_psi_lo+((fp_t)i)*tab_h_psi;
+	  for(size_t j=0;j<n_eta;j++) {
+	    fp_t eta=o2exp(tab_leta_lo+((fp_t)j)*tab_h_leta);
+	    fp_t n, ed, en;
+	    table_direct(psi,eta,n,ed,en);
+	    if (!o2isfinite(n) || !o2isfinite(ed) || !o2isfinite(en) ||
+		n<=0.0 || ed<=0.0 || en<=0.0) {
+	      use_table=use_table_temp;
+	      unc=unc_temp;
+	      last_method=lm_temp;
+	      clear_table();
+	      O2SCL_ERR2("Integrals not finite and positive in ",
+			 "fermion_rel::build_table().",exc_efailed);
+	      return exc_efailed;
+	    }
+	    tab_ln[i*n_eta+j]=o2log(n);
+	    tab_led[i*n_eta+j]=o2log(ed);
+	    tab_len[i*n_eta+j]=o2log(en);
+	  }
+	}
+
+	// Estimate the error by comparing with direct integration
+	// at the center of each cell
+	tab_max_err=0.0;
+	for(size_t i=0;i<n_psi-1;i++) {
+	  fp_t psi=tab_psi_lo+(((fp_t)i)+0.5)*tab_h_psi;
+	  for(size_t j=0;j<n_eta-1;j++) {
+	    fp_t eta=o2exp(tab_leta_lo+(((fp_t)j)+0.5)*tab_h_leta);
+	    fp_t n, ed, en, tn, ted, ten;
+	    table_direct(psi,eta,n,ed,en);
+	    table_interp(psi,eta,tn,ted,ten);
+	    fp_t err=o2abs(tn-n)/o2abs(n);
+	    fp_t err2=o2abs(ted-ed)/o2abs(ed);
+	    if (err2>err) err=err2;
+	    err2=o2abs(ten-en)/o2abs(en);
+	    if (err2>err) err=err2;
+	    if (!o2isfinite(err)) err=1.0;
+	    tab_cell_err[i*(n_eta-1)+j]=err;
+	    if (err>tab_max_err) tab_max_err=err;
+	  }
+	}
+
+	if (verbose>0) {
+	  std::cout << "fermion_rel::build_table(): grid " << n_psi
+		    << " by " << n_eta << ", max. error "
+		    << tab_max_err << std::endl;
+	}
+	
+	if (tab_max_err<=table_tol || 2*n_psi-1>table_max_points ||
+	    2*n_eta-1>table_max_points ||
+	    (!first && tab_max_err>last_err/2.0)) {
+	  break;
+	}
+	first=false;
+	last_err=tab_max_err;
+	n_psi=2*n_psi-1;
+	n_eta=2*n_eta-1;
+      }
+      
+      use_table=use_table_temp;
+      unc=unc_temp;
+      last_method=lm_temp;
+
+      if (tab_max_err>table_tol) {
+	O2SCL_CONV2_RET("Table tolerance not achieved in ",
+			"fermion_rel::build_table().",exc_efailed,
+			this->err_nonconv);
+      }
+      
+      return success;
+    }
+
+    /// Remove the table of integrals
+    void clear_table() {
+      tab_n_psi=0;
+      tab_n_eta=0;
+      tab_max_err=0.0;
+      tab_ln.clear();
+      tab_led.clear();
+      tab_len.clear();
+      tab_cell_err.clear();
+      return;
+    }
+
+    /// Return true if a table has been constructed
+    bool table_built() const {
+      return tab_n_psi>0;
+    }
+
+    /** \brief Return the largest relative error estimate in the 
+	table
+    */
+    fp_t table_max_error() const {
+      return tab_max_err;
+    }
+    //@}
+
     /// \name Template versions of base functions
     //@{
     /** \brief Calculate the chemical potential from the density
@@ -593,6 +807,16 @@ namespace o2scl {
 	std::cout << "calc_mu(): psi,deg,deg_limit: " << psi << " "
 		  << deg << " " << deg_limit << std::endl;
       }
+
+      // Use the table if possible
+      if (use_table && table_calc(f,temper,psi)) {
+	f.pr=-f.ed+temper*f.en+f.nu*f.n;
+	unc.pr=sqrt(unc.ed*unc.ed+temper*unc.en*temper*unc.en+
+		    f.nu*unc.n*f.nu*unc.n);
+	last_method=10;
+	return;
+      }
+      
       // Try the non-degenerate expansion if psi is small enough
       if (use_expansions && psi<min_psi) {
 	bool acc=this->calc_mu_ndeg(f,temper,tol_expan);
@@ -875,6 +1099,20 @@ namespace o2scl {
       }
       if (psi<deg_limit) deg=false;
 
+      // Use the table if possible
+      if (use_table) {
+	fp_t unc_n=unc.n;
+	if (table_calc(f,temper,psi)) {
+	  unc.n=unc_n;
+	  f.n=density_temp;
+	  f.pr=-f.ed+temper*f.en+f.nu*f.n;
+	  unc.pr=sqrt(unc.ed*unc.ed+temper*unc.en*temper*unc.en+
+		      f.nu*unc.n*f.nu*unc.n);
+	  last_method+=6;
+	  return 0;
+	}
+      }
+      
       // Try the non-degenerate expansion if psi is small enough
       if (use_expansions && psi<min_psi) {
 	bool acc=this->calc_mu_ndeg(f,temper,tol_expan);
@@ -1028,6 +1266,11 @@ namespace o2scl {
       fermion_t antip(f.m,f.g);
       f.anti(antip);
 
+      // The table is not used here, since its value of last_method
+      // does not fit in the encoding below
+      bool use_table_temp=use_table;
+      use_table=false;
+
       // Particles
       calc_mu(f,temper);
       fp_t unc_n=unc.n;
@@ -1041,6 +1284,8 @@ namespace o2scl {
       last_method+=lm;
       last_method*=10;
 
+      use_table=use_table_temp;
+
       // Add up thermodynamic quantities
       if (f.inc_rest_mass) {
 	f.ed+=antip.ed;
@@ -1213,6 +1458,135 @@ namespace o2scl {
     
 #ifndef DOXYGEN_INTERNAL
 
+    /// \name Table storage
+    //@{
+    /// Number of grid points in \f$ \psi \f$ (zero if no table)
+    size_t tab_n_psi;
+    /// Number of grid points in \f$ \log \eta \f$
+    size_t tab_n_eta;
+    /// Lower and upper limits for \f$ \psi \f$
+    fp_t tab_psi_lo, tab_psi_hi;
+    /// Lower and upper limits for \f$ \log \eta \f$
+    fp_t tab_leta_lo, tab_leta_hi;
+    /// Grid spacings
+    fp_t tab_h_psi, tab_h_leta;
+    /// Logarithm of the scaled density
+    std::vector<fp_t> tab_ln;
+    /// Logarithm of the scaled energy density
+    std::vector<fp_t> tab_led;
+    /// Logarithm of the scaled entropy
+    std::vector<fp_t> tab_len;
+    /// Relative error estimate for each cell
+    std::vector<fp_t> tab_cell_err;
+    /// The largest error estimate
+    fp_t tab_max_err;
+    //@}
+
+    /** \brief Compute the scaled density, energy density and 
+	entropy (at \f$ T=1 \f$ and \f$ g=1 \f$) by direct integration
+    */
+    void table_direct(fp_t psi, fp_t eta, fp_t &n, fp_t &ed, fp_t &en) {
+      fermion_t ft(eta,1.0);
+      ft.inc_rest_mass=true;
+      ft.non_interacting=true;
+      ft.mu=psi+eta;
+      calc_mu(ft,1.0);
+      n=ft.n;
+      ed=ft.ed;
+      en=ft.en;
+      return;
+    }
+
+    /** \brief Compute the four-point Lagrange weights for
+	coordinate \c x on a uniform grid
+
+	The index of the first point in the stencil is returned
+	and the index of the grid cell containing \c x is 
+	stored in \c cell.
+    */
+    size_t table_weights(fp_t x, fp_t lo, fp_t h, size_t n,
+			 size_t &cell, fp_t w[4]) const {
+      fp_t t=(x-lo)/h;
+      if (t<0.0) t=0.0;
+      cell=static_cast<size_t>(t);
+      if (cell>n-2) cell=n-2;
+      size_t start=0;
+      if (cell>0) start=cell-1;
+      if (start>n-4) start=n-4;
+      fp_t s=t-((fp_t)start);
+      w[0]=-(s-1.0)*(s-2.0)*(s-3.0)/6.0;
+      w[1]=s*(s-2.0)*(s-3.0)/2.0;
+      w[2]=-s*(s-1.0)*(s-3.0)/2.0;
+      w[3]=s*(s-1.0)*(s-2.0)/6.0;
+      return start;
+    }
+
+    /** \brief Interpolate the scaled density, energy density and 
+	entropy from the table, returning the index of the cell
+    */
+    size_t table_interp(fp_t psi, fp_t eta, fp_t &n, fp_t &ed,
+			fp_t &en) const {
+      size_t ci, cj;
+      fp_t wi[4], wj[4];
+      size_t si=table_weights(psi,tab_psi_lo,tab_h_psi,tab_n_psi,ci,wi);
+      size_t sj=table_weights(o2log(eta),tab_leta_lo,tab_h_leta,
+			      tab_n_eta,cj,wj);
+      fp_t ln=0.0, led=0.0, len=0.0;
+      for(size_t i=0;i<4;i++) {
+	size_t row=(si+i)*tab_n_eta+sj;
+	fp_t rn=0.0, red=0.0, ren=0.0;
+	for(size_t j=0;j<4;j++) {
+	  rn+=wj[j]*tab_ln[row+j];
+	  red+=wj[j]*tab_led[row+j];
+	  ren+=wj[j]*tab_len[row+j];
+	}
+	ln+=wi[i]*rn;
+	led+=wi[i]*red;
+	len+=wi[i]*ren;
+      }
+      n=o2exp(ln);
+      ed=o2exp(led);
+      en=o2exp(len);
+      return ci*(tab_n_eta-1)+cj;
+    }
+
+    /** \brief Use the table to compute the scaled integrals if
+	possible
+
+	Returns false if there is no table, if the point is outside
+	the table, or if \ref table_strict is true and the error
+	estimate for the cell is larger than \ref table_tol. The
+	relative error estimate is stored in \c err.
+    */
+    bool table_lookup(fp_t psi, fp_t eta, fp_t &n, fp_t &ed, fp_t &en,
+		      fp_t &err) const {
+      if (tab_n_psi==0 || !o2isfinite(psi) || !(eta>0.0)) return false;
+      if (psi<tab_psi_lo || psi>tab_psi_hi) return false;
+      fp_t leta=o2log(eta);
+      if (leta<tab_leta_lo || leta>tab_leta_hi) return false;
+      size_t cell=table_interp(psi,eta,n,ed,en);
+      err=tab_cell_err[cell];
+      if (table_strict && err>table_tol) return false;
+      return true;
+    }
+
+    /** \brief Use the table to compute the density, energy density
+	and entropy of \c f (and their uncertainties) if possible
+    */
+    bool table_calc(fermion_t &f, fp_t temper, fp_t psi) {
+      fp_t tn, ted, ten, err;
+      if (!table_lookup(psi,f.ms/temper,tn,ted,ten,err)) return false;
+      fp_t fac=f.g*temper*temper*temper;
+      f.n=tn*fac;
+      f.ed=ted*fac*temper;
+      unc.ed=f.ed*err;
+      if (!f.inc_rest_mass) f.ed-=f.n*f.m;
+      f.en=ten*fac;
+      unc.n=f.n*err;
+      unc.en=f.en*err;
+      return true;
+    }
+
     /// The integrand for the density for non-degenerate fermions
     fp_t density_fun(fp_t u, fermion_t &f, fp_t T) {
 
@@ -1422,6 +1796,16 @@ namespace o2scl {
       }
       if (psi<deg_limit) deg=false;
 
+      // Use the table if possible
+      if (use_table) {
+	fp_t tn, ted, ten, err;
+	if (table_lookup(psi,f.ms/T,tn,ted,ten,err)) {
+	  nden=tn*f.g*T*T*T;
+	  unc.n=nden*err;
+	  return (f.n-nden)/f.n;
+	}
+      }
+      
       // Try the non-degenerate expansion if psi is small enough
       if (use_expansions && psi<min_psi) {
 	fp_t ntemp=f.n;
@@ -92,7 +92,63 @@ int main(void) {
   //inte_qag_gsl<> *qag=dynamic_cast<inte_qag_gsl<> *>(fr.dit.get());
   //inte_qag_gsl<> &qag2=dynamic_cast<inte_qag_gsl<> &>(*fr.dit.get());
   //t.test_gen(qag->get_rule()==qag2.get_rule(),"downcast");
-  
+
+  // -----------------------------------------------------------------
+  // Tabulated integrals
+
+  {
+    fermion_rel fr2;
+    fermion f2(1.0,2.0);
+    t.test_gen(fr2.build_table(-4.0,10.0,0.5,5.0)==0,"build_table");
+    t.test_gen(fr2.table_max_error()<fr2.table_tol,"table error");
+
+    for(double mu=0.5;mu<5.1;mu+=1.5) {
+
+      f2.mu=mu;
+      fr2.use_table=false;
+      fr2.calc_mu(f2,0.7);
+      double n=f2.n, ed=f2.ed, pr=f2.pr, en=f2.en;
+
+      fr2.use_table=true;
+      fr2.calc_mu(f2,0.7);
+      t.test_gen(fr2.last_method==10,"table calc_mu method");
+      t.test_rel(f2.n,n,1.0e-6,"table calc_mu n");
+      t.test_rel(f2.ed,ed,1.0e-6,"table calc_mu ed");
+      t.test_rel(f2.pr,pr,1.0e-6,"table calc_mu pr");
+      t.test_rel(f2.en,en,1.0e-6,"table calc_mu en");
+
+      f2.n=n;
+      f2.mu=1.0;
+      fr2.calc_density(f2,0.7);
+      t.test_gen(fr2.last_method%10==6,"table calc_density method");
+      t.test_rel(f2.mu,mu,1.0e-6,"table calc_density mu");
+      t.test_rel(f2.ed,ed,1.0e-6,"table calc_density ed");
+    }
+
+    // Outside the table, direct integration is used
+    f2.mu=1.0;
+    fr2.calc_mu(f2,0.1);
+    t.test_gen(fr2.last_method!=10,"table outside");
+
+    // The pair functions compute the integrals directly and
+    // do not change use_table
+    f2.mu=2.0;
+    fr2.use_table=false;
+    fr2.pair_mu(f2,0.7);
+    double n=f2.n, ed=f2.ed;
+    int lm=fr2.last_method;
+    fr2.use_table=true;
+    fr2.pair_mu(f2,0.7);
+    t.test_gen(fr2.last_method==lm,"table pair_mu method");
+    t.test_gen(fr2.use_table==true,"table pair_mu use_table");
+    t.test_rel(f2.n,n,1.0e-12,"table pair_mu n");
+    t.test_rel(f2.ed,ed,1.0e-12,"table pair_mu ed");
+    f2.mu=1.0;
+    fr2.pair_density(f2,0.7);
+    t.test_rel(f2.mu,2.0,1.0e-6,"table pair_density mu");
+    t.test_gen(fr2.use_table==true,"table pair_density use_table");
+  }
+
 #ifdef O2SCL_LD_TYPES
 
   // The long double type isn't that much more precise than double, so
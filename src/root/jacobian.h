@@ -28,6 +28,12 @@
 */
 
 #include <string>
+#include <vector>
+
+#ifdef O2SCL_OPENMP
+#include <omp.h>
+#endif
+
 #include <o2scl/mm_funct.h>
 #include <o2scl/deriv_gsl.h>
 #include <o2scl/columnify.h>
@@ -129,6 +135,18 @@ namespace o2scl {
       step-size found which would give a zero return value from
       the user-specified function, then the error handler is called
       depending on the value of \ref err_nonconv.
+
+      If the sparsity pattern of the Jacobian is specified with \ref
+      set_sparsity(), then columns which do not share a nonzero row
+      are collected into groups and all of the columns in a group
+      are perturbed in the same function evaluation, so the number
+      of function evaluations is the number of groups rather than
+      the number of columns.
+
+      If \ref n_threads is greater than one and a function object
+      for each thread has been given with \ref set_functions(), then
+      the columns (or groups of columns) are divided among OpenMP
+      threads. The result does not depend on the number of threads.
       
       This class does not separately check the vector and matrix sizes
       to ensure they are commensurate. 
@@ -147,11 +165,25 @@ namespace o2scl {
     
   protected:
   
-  /// Function values
-  vec_t f;
+  /// Function values for each thread
+  std::vector<vec_t> f_threads;
+
+  /// Function arguments for each thread
+  std::vector<vec_t> xx_threads;
+
+  /// The function objects for each thread
+  std::vector<func_t> func_threads;
+
+  /** \brief For each column, the list of rows which may be nonzero
+      (empty if the Jacobian is dense)
+  */
+  std::vector<std::vector<size_t> > sp_rows;
+
+  /// The number of rows in the sparsity pattern
+  size_t sp_ny;
 
-  /// Function arguments
-  vec_t xx;
+  /// The groups of columns which are perturbed together
+  std::vector<std::vector<size_t> > groups;
 
   /// Size of allocated memory in x
   size_t mem_size_x;
@@ -183,11 +215,168 @@ namespace o2scl {
     mem_size_y=0;
     max_shrink_iters=10;
     shrink_fact=1.0e2;
+    n_threads=1;
+    sp_ny=0;
   }
 
   virtual ~jacobian_gsl() {
   }
 
+  /** \brief The number of OpenMP threads (default 1)
+
+      The number of threads actually used is limited by the number
+      of function objects given in \ref set_functions().
+  */
+  size_t n_threads;
+  
+  /** \brief Set the function objects to use for each OpenMP thread
+
+      The function object <tt>vf[i]</tt> is used in thread \c i
+      when more than one thread is used, so they must all compute
+      the same function. These remain in use until \ref
+      clear_functions() or \ref set_function() is called. Since
+      the multidimensional solvers call \ref set_function() on
+      their automatic Jacobian, a parallel Jacobian must be given
+      to a solver as a user-specified Jacobian function (e.g. to
+      <tt>mroot_hybrids::msolve_de()</tt>) which calls this
+      object.
+  */
+  virtual int set_functions(std::vector<func_t> &vf) {
+    if (vf.size()==0) {
+      O2SCL_ERR2("No functions specified in ",
+		 "jacobian_gsl::set_functions().",exc_einval);
+    }
+    this->func=vf[0];
+    func_threads=vf;
+    return 0;
+  }
+
+  /** \brief Set the function to compute the Jacobian of
+
+      This also removes any function objects given in \ref
+      set_functions(), so that the Jacobian is always computed
+      from the function most recently specified, independent of
+      the number of threads.
+  */
+  virtual int set_function(func_t &f) {
+    this->func=f;
+    func_threads.clear();
+    return 0;
+  }
+
+  /// Remove the function objects given in \ref set_functions()
+  virtual void clear_functions() {
+    func_threads.clear();
+    return;
+  }
+
+  /** \brief Specify the sparsity pattern of the Jacobian
+
+      The matrix \c pattern should have \c ny rows and \c nx
+      columns, and <tt>pattern(i,j)</tt> should be nonzero (or true)
+      whenever the Jacobian entry <tt>J(i,j)</tt> may be nonzero.
+      The columns are grouped with a greedy coloring algorithm so
+      that no two columns in the same group share a nonzero row.
+  */
+  template<class mat2_t>
+  void set_sparsity(size_t ny, size_t nx, const mat2_t &pattern) {
+    std::vector<size_t> colors(nx);
+
+    // Store the list of columns in each row
+    std::vector<std::vector<size_t> > row_cols(ny);
+    for(size_t i=0;i<ny;i++) {
+      for(size_t j=0;j<nx;j++) {
+	if (pattern(i,j)) row_cols[i].push_back(j);
+      }
+    }
+
+    // Give each column the smallest color not used by one of the
+    // previous columns which shares a row
+    std::vector<size_t> last_used(nx,nx);
+    for(size_t j=0;j<nx;j++) {
+      for(size_t i=0;i<ny;i++) {
+	if (pattern(i,j)) {
+	  for(size_t k=0;k<row_cols[i].size() && row_cols[i][k]<j;k++) {
+	    last_used[colors[row_cols[i][k]]]=j;
+	  }
+	}
+      }
+      size_t c=0;
+      while (last_used[c]==j) c++;
+      colors[j]=c;
+    }
+    
+    set_sparsity(ny,nx,pattern,colors);
+    return;
+  }
+
+  /** \brief Specify the sparsity pattern of the Jacobian and
+      the group (or color) of each column
+      
+      The matrix \c pattern is as in \ref set_sparsity(size_t,
+      size_t, const mat2_t &) and the columns \c j for which
+      <tt>colors[j]</tt> are equal are perturbed together. The
+      error handler is called if two columns with the same color
+      share a nonzero row.
+  */
+  template<class mat2_t, class vec_size_t>
+  void set_sparsity(size_t ny, size_t nx, const mat2_t &pattern,
+		    const vec_size_t &colors) {
+
+    size_t n_colors=0;
+    for(size_t j=0;j<nx;j++) {
+      if (colors[j]+1>n_colors) n_colors=colors[j]+1;
+    }
+
+    // Check that the columns in each group are structurally
+    // orthogonal
+    for(size_t i=0;i<ny;i++) {
+      std::vector<bool> used(n_colors,false);
+      for(size_t j=0;j<nx;j++) {
+	if (pattern(i,j)) {
+	  if (used[colors[j]]) {
+	    O2SCL_ERR2("Two columns with the same color share a row in ",
+		       "jacobian_gsl::set_sparsity().",exc_einval);
+	  }
+	  used[colors[j]]=true;
+	}
+      }
+    }
+
+    sp_ny=ny;
+    sp_rows.clear();
+    sp_rows.resize(nx);
+    for(size_t j=0;j<nx;j++) {
+      for(size_t i=0;i<ny;i++) {
+	if (pattern(i,j)) sp_rows[j].push_back(i);
+      }
+    }
+    groups.clear();
+    groups.resize(n_colors);
+    for(size_t j=0;j<nx;j++) {
+      groups[colors[j]].push_back(j);
+    }
+    
+    return;
+  }
+
+  /// Return to the default dense Jacobian
+  void clear_sparsity() {
+    sp_rows.clear();
+    groups.clear();
+    sp_ny=0;
+    return;
+  }
+
+  /** \brief Return the number of function evaluations per
+      Jacobian given the current sparsity pattern (not including
+      those needed when the step size is changed)
+  */
+  size_t get_n_groups(size_t nx) {
+    if (sp_rows.size()==0) return nx;
+    return groups.size();
+  }
+
   /** \brief Get the relative stepsize (default \f$ 10^{-4} \f$ )
    */
   double get_epsrel() { return epsrel; }
@@ -240,83 +429,202 @@ namespace o2scl {
    */
   virtual int operator()(size_t nx, vec_t &x, size_t ny, vec_t &y, 
 			 mat_t &jac) {
-      
-    size_t i,j;
-    double h,temp;
 
-    if (mem_size_x!=nx || mem_size_y!=ny) {
-      f.resize(ny);
-      xx.resize(nx);
+    bool sparse=(sp_rows.size()>0);
+    if (sparse && (sp_rows.size()!=nx || sp_ny!=ny)) {
+      O2SCL_ERR2("Sparsity pattern does not match Jacobian size in ",
+		 "jacobian_gsl::operator().",exc_einval);
+    }
+    size_t n_groups=(sparse ? groups.size() : nx);
+
+    // Determine the number of threads
+    size_t nt=1;
+#ifdef O2SCL_OPENMP
+    nt=n_threads;
+    if (nt>func_threads.size()) nt=func_threads.size();
+    if (nt>n_groups) nt=n_groups;
+    if (nt==0) nt=1;
+#endif
+    
+    if (mem_size_x!=nx || mem_size_y!=ny || f_threads.size()<nt) {
+      f_threads.resize(nt);
+      xx_threads.resize(nt);
+      for(size_t it=0;it<nt;it++) {
+	f_threads[it].resize(ny);
+	xx_threads[it].resize(nx);
+      }
       mem_size_x=nx;
       mem_size_y=ny;
     }
-      
-    vector_copy(nx,x,xx);
+    for(size_t it=0;it<nt;it++) {
+      vector_copy(nx,x,xx_threads[it]);
+    }
 
-    for (j=0;j<nx;j++) {
+    // The status for each group: 0 for success, 1 if no valid step
+    // was found, and 2 if a column was zero. The index of the zero
+    // column is stored in zero_col.
+    std::vector<int> status(n_groups);
+    std::vector<size_t> zero_col(n_groups);
+
+    if (nt==1) {
+      for(size_t ig=0;ig<n_groups;ig++) {
+	status[ig]=eval_group(0,false,ig,nx,x,ny,y,jac,zero_col[ig]);
+	// Stop at the first failure, as in the serial algorithm
+	if (status[ig]!=0) break;
+      }
+    } else {
+#ifdef O2SCL_OPENMP
+#pragma omp parallel for num_threads(nt) schedule(dynamic)
+#endif
+      for(size_t ig=0;ig<n_groups;ig++) {
+	size_t it=0;
+#ifdef O2SCL_OPENMP
+	it=omp_get_thread_num();
+#endif
+	status[ig]=eval_group(it,true,ig,nx,x,ny,y,jac,zero_col[ig]);
+      }
+    }
 
-      // Thanks to suggestion from Conrad Curry.
-      h=epsrel*fabs(x[j]);
-      if (h<epsmin) h=epsmin;
-      if (h==0.0) h=epsrel;
+    // Report the first failure
+    for(size_t ig=0;ig<n_groups;ig++) {
+      if (status[ig]==1) {
+	O2SCL_CONV2_RET("Jacobian failed to find valid step in ",
+			"jacobian_gsl::operator().",exc_ebadfunc,
+			this->err_nonconv);
+      } else if (status[ig]==2) {
+	O2SCL_CONV_RET((((std::string)"Row ")+o2scl::szttos(zero_col[ig])+
+			" of the Jacobian is zero "+
+			"in jacobian_gsl::operator().").c_str(),exc_esing,
+		       this->err_nonconv);
+      }
+    }
+    
+    return 0;
+  }
+
+#ifndef DOXYGEN_INTERNAL
+
+  protected:
 
-      xx[j]=x[j]+h;
-      int ret=(this->func)(nx,xx,f);
-      xx[j]=x[j];
+  /** \brief Compute the columns in group \c ig (or column \c ig
+      if no sparsity pattern was given) using thread \c it
+
+      If \c threaded is false, the function given in \ref
+      set_function() is used, otherwise the function for thread
+      \c it given in \ref set_functions() is used.
+  */
+  int eval_group(size_t it, bool threaded, size_t ig, size_t nx,
+		 const vec_t &x, size_t ny, const vec_t &y, mat_t &jac,
+		 size_t &zcol) {
+
+    func_t &fn=(threaded ? func_threads[it] : this->func);
+    vec_t &xx=xx_threads[it];
+    vec_t &f=f_threads[it];
+    
+    bool sparse=(sp_rows.size()>0);
+    size_t ncols=(sparse ? groups[ig].size() : 1);
+    std::vector<double> h(ncols);
+    
+    for(size_t k=0;k<ncols;k++) {
+      size_t j=(sparse ? groups[ig][k] : ig);
       
-      // The function returned a non-zero value, so try a different step
-      size_t it=0;
-      while (ret!=0 && h>=epsmin && it<max_shrink_iters) {
-
-	// First try flipping the sign
-	h=-h;
-	xx[j]=x[j]+h;
-	ret=(this->func)(nx,xx,f);
-	xx[j]=x[j];
-
-	if (ret!=0) {
-
-	  // If that didn't work, flip to positive and try a smaller
-	  // stepsize
-	  h/=-shrink_fact;
-	  if (h>=epsmin) {
-	    xx[j]=x[j]+h;
-	    ret=(this->func)(nx,xx,f);
-	    xx[j]=x[j];
-	  }
-	  
-	}
+      // Thanks to suggestion from Conrad Curry.
+      h[k]=epsrel*fabs(x[j]);
+      if (h[k]<epsmin) h[k]=epsmin;
+      if (h[k]==0.0) h[k]=epsrel;
+    }
 
-	it++;
-      }
+    int ret=eval_step(fn,nx,x,xx,f,ig,h);
+
+    // The function returned a non-zero value, so try a different step
+    size_t iter=0;
+    while (ret!=0 && steps_above_min(h) && iter<max_shrink_iters) {
+
+      // First try flipping the sign
+      for(size_t k=0;k<ncols;k++) h[k]=-h[k];
+      ret=eval_step(fn,nx,x,xx,f,ig,h);
 
       if (ret!=0) {
-	O2SCL_CONV2_RET("Jacobian failed to find valid step in ",
-			"jacobian_gsl::operator().",exc_ebadfunc,
-			this->err_nonconv);
+
+	// If that didn't work, flip to positive and try a smaller
+	// stepsize
+	for(size_t k=0;k<ncols;k++) h[k]/=-shrink_fact;
+	if (steps_above_min(h)) {
+	  ret=eval_step(fn,nx,x,xx,f,ig,h);
+	}
+	
       }
 
+      iter++;
+    }
+
+    if (ret!=0) return 1;
+    
+    for(size_t k=0;k<ncols;k++) {
+      size_t j=(sparse ? groups[ig][k] : ig);
+      
       // This is the equivalent of GSL's test of
       // gsl_vector_isnull(&col.vector)
-
+      
       bool nonzero=false;
-      for (i=0;i<ny;i++) {
-	temp=(f[i]-y[i])/h;
-	if (temp!=0.0) nonzero=true;
-	jac(i,j)=temp;
+      if (sparse) {
+	for(size_t i=0;i<ny;i++) jac(i,j)=0.0;
+	for(size_t ii=0;ii<sp_rows[j].size();ii++) {
+	  size_t i=sp_rows[j][ii];
+	  double temp=(f[i]-y[i])/h[k];
+	  if (temp!=0.0) nonzero=true;
+	  jac(i,j)=temp;
+	}
+      } else {
+	for(size_t i=0;i<ny;i++) {
+	  double temp=(f[i]-y[i])/h[k];
+	  if (temp!=0.0) nonzero=true;
+	  jac(i,j)=temp;
+	}
       }
       if (nonzero==false) {
-	O2SCL_CONV_RET((((std::string)"Row ")+o2scl::szttos(j)+
-			" of the Jacobian is zero "+
-			"in jacobian_gsl::operator().").c_str(),exc_esing,
-		       this->err_nonconv);
+	zcol=j;
+	return 2;
       }
-
     }
-    
+
     return 0;
   }
 
+  /// Return true if all of the step sizes are at least \ref epsmin
+  bool steps_above_min(const std::vector<double> &h) {
+    for(size_t k=0;k<h.size();k++) {
+      if (h[k]<epsmin) return false;
+    }
+    return true;
+  }
+  
+  /** \brief Evaluate the function with the columns in group \c ig
+      shifted by \c h
+  */
+  int eval_step(func_t &fn, size_t nx, const vec_t &x, vec_t &xx,
+		vec_t &f, size_t ig, const std::vector<double> &h) {
+    bool sparse=(sp_rows.size()>0);
+    if (sparse) {
+      for(size_t k=0;k<h.size();k++) {
+	xx[groups[ig][k]]=x[groups[ig][k]]+h[k];
+      }
+    } else {
+      xx[ig]=x[ig]+h[0];
+    }
+    int ret=fn(nx,xx,f);
+    if (sparse) {
+      for(size_t k=0;k<h.size();k++) {
+	xx[groups[ig][k]]=x[groups[ig][k]];
+      }
+    } else {
+      xx[ig]=x[ig];
+    }
+    return ret;
+  }
+
+#endif
+
   };
   
   /** \brief A direct calculation of the jacobian using a \ref
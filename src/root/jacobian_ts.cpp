@@ -38,6 +38,25 @@ int tfun(size_t nv, const ubvector &x, ubvector &y) {
   return 0;
 }
 
+// A function with a tridiagonal Jacobian
+int tfun_tri(size_t nv, const ubvector &x, ubvector &y) {
+  for(size_t i=0;i<nv;i++) {
+    y[i]=x[i]*x[i]*x[i];
+    if (i>0) y[i]+=sin(x[i-1]);
+    if (i+1<nv) y[i]-=2.0*x[i]*x[i+1];
+  }
+  return 0;
+}
+
+bool mat_equal(size_t n, const ubmatrix &a, const ubmatrix &b) {
+  for(size_t i=0;i<n;i++) {
+    for(size_t j=0;j<n;j++) {
+      if (a(i,j)!=b(i,j)) return false;
+    }
+  }
+  return true;
+}
+
 int main(void) {
 
   jacobian_exact<mm_funct> ej;
@@ -98,6 +117,65 @@ int main(void) {
        << 3.0*x[1]*x[1] << endl;
   cout << endl;
 
+  // Sparse and parallel Jacobians
+  {
+    size_t n=10;
+    ubvector x2(n), y2(n);
+    ubmatrix jd(n,n), js(n,n), jp(n,n);
+    for(size_t i=0;i<n;i++) x2[i]=1.0+0.1*i;
+    mm_funct mff_tri=tfun_tri;
+    tfun_tri(n,x2,y2);
+    
+    jacobian_gsl<mm_funct> sj2;
+    sj2.set_function(mff_tri);
+    sj2(n,x2,n,y2,jd);
+
+    // The tridiagonal pattern requires three groups of columns
+    ubmatrix pat(n,n);
+    for(size_t i=0;i<n;i++) {
+      for(size_t j=0;j<n;j++) {
+	if (i==j || i==j+1 || j==i+1) pat(i,j)=1.0;
+	else pat(i,j)=0.0;
+      }
+    }
+    sj2.set_sparsity(n,n,pat);
+    t.test_gen(sj2.get_n_groups(n)==3,"sparse groups");
+    sj2(n,x2,n,y2,js);
+    t.test_gen(mat_equal(n,jd,js),"sparse");
+
+    vector<mm_funct> vf(3,mff_tri);
+    sj2.set_functions(vf);
+    sj2.n_threads=3;
+    sj2(n,x2,n,y2,jp);
+    t.test_gen(mat_equal(n,jd,jp),"sparse and parallel");
+
+    sj2.clear_sparsity();
+    sj2(n,x2,n,y2,jp);
+    t.test_gen(mat_equal(n,jd,jp),"parallel");
+
+    // A later call to set_function() overrides set_functions()
+    // for any number of threads
+    mm_funct mff_tri2=[](size_t nv, const ubvector &xa,
+			 ubvector &ya) -> int {
+      tfun_tri(nv,xa,ya);
+      for(size_t i=0;i<nv;i++) ya[i]*=2.0;
+      return 0;
+    };
+    sj2.n_threads=1;
+    sj2.set_function(mff_tri2);
+    for(size_t i=0;i<n;i++) y2[i]*=2.0;
+    sj2(n,x2,n,y2,jp);
+    t.test_rel(jp(0,0),2.0*jd(0,0),1.0e-6,"serial set_function");
+    t.test_rel(jp(2,1),2.0*jd(2,1),1.0e-6,"serial set_function 2");
+
+    sj2.set_functions(vf);
+    sj2.n_threads=3;
+    sj2.set_function(mff_tri2);
+    ubmatrix jp3(n,n);
+    sj2(n,x2,n,y2,jp3);
+    t.test_gen(mat_equal(n,jp,jp3),"set_function with threads");
+  }
+
   t.report();
   return 0;
 }